@@ -3,12 +3,15 @@
 #include <QFileInfo>
 #include <QMessageBox>
 #include <QResource>
+#include <QTimer>
 #include <iostream>
+#include <memory>
 
 #include "src/cli/clioptions.h"
 #include "src/cli/clirunner.h"
 #include "src/mainwindow.h"
 #include "src/ripessettings.h"
+#include "src/utilities/startuptrace.h"
 
 using namespace std;
 
@@ -24,9 +27,23 @@ void initParser(QCommandLineParser &parser, Ripes::CLIModeOptions &options) {
   parser.setApplicationDescription(helpText);
   QCommandLineOption modeOption("mode", "Ripes mode [gui, cli]", "mode", "gui");
   parser.addOption(modeOption);
+  QCommandLineOption startupTraceOption(
+      "startup-trace",
+      "Write a Chrome trace event file (chrome://tracing, Perfetto) of the "
+      "time spent in each startup stage to <path>.",
+      "path");
+  parser.addOption(startupTraceOption);
   Ripes::addCLIOptions(parser, options);
 }
 
+void writeStartupTrace(const QString &path) {
+  if (path.isEmpty())
+    return;
+  if (!Ripes::StartupTrace::writeChromeTrace(path))
+    std::cerr << "ERROR: Could not write startup trace to '"
+              << path.toStdString() << "'" << std::endl;
+}
+
 enum CommandLineParseResult {
   CommandLineError,
   CommandLineHelpRequested,
@@ -55,7 +72,7 @@ CommandLineParseResult parseCommandLine(QCommandLineParser &parser,
   }
 }
 
-int guiMode(QApplication &app) {
+int guiMode(QApplication &app, const QString &tracePath) {
   // Use the Fusion style, which respects the system light/dark palette and looks good with both. Combined
   // with QStyleHints::setColorScheme (see applyColorScheme) this gives the
   // application proper light/dark theming.
@@ -63,6 +80,7 @@ int guiMode(QApplication &app) {
   Ripes::applyColorScheme();
 
   Ripes::MainWindow m;
+  const qint64 showStartUs = Ripes::StartupTrace::nowUs();
 
 #ifdef Q_OS_WASM
   // In the WASM build, we'll just want a full-screen application that can't be
@@ -77,6 +95,14 @@ int guiMode(QApplication &app) {
   m.show();
 #endif
 
+  // Startup is considered complete once the event loop has started, i.e. the
+  // window has been shown and is about to be painted.
+  QTimer::singleShot(0, &m, [showStartUs, tracePath] {
+    Ripes::StartupTrace::record("First event loop iteration", showStartUs,
+                                Ripes::StartupTrace::nowUs() - showStartUs);
+    writeStartupTrace(tracePath);
+  });
+
   return app.exec();
 }
 
@@ -87,23 +113,53 @@ int CLIMode(QCommandLineParser &parser, Ripes::CLIModeOptions &options) {
     parser.showHelp();
     return 0;
   }
-  return Ripes::CLIRunner(options).run();
+  const int result = Ripes::CLIRunner(options).run();
+  writeStartupTrace(parser.value("startup-trace"));
+  return result;
+}
+
+/// Returns true if CLI mode was requested. The arguments are scanned before the
+/// application object is constructed, such that CLI mode runs headless,
+/// without initializing the GUI.
+bool requestsCLIMode(int argc, char **argv) {
+  for (int i = 1; i < argc; ++i) {
+    const QByteArray arg(argv[i]);
+    if (arg == "--mode=cli" ||
+        (arg == "--mode" && i + 1 < argc && QByteArray(argv[i + 1]) == "cli"))
+      return true;
+  }
+  return false;
 }
 
 int main(int argc, char **argv) {
+  Ripes::StartupTrace::start();
   Q_INIT_RESOURCE(icons);
   Q_INIT_RESOURCE(examples);
   Q_INIT_RESOURCE(layouts);
   Q_INIT_RESOURCE(fonts);
 
-  QApplication app(argc, argv);
+  const qint64 appStartUs = Ripes::StartupTrace::nowUs();
+  std::unique_ptr<QCoreApplication> app;
+  if (requestsCLIMode(argc, argv)) {
+    app = std::make_unique<QCoreApplication>(argc, argv);
+    Ripes::RipesSettings::setVolatile();
+  } else {
+    app = std::make_unique<QApplication>(argc, argv);
+  }
+  Ripes::StartupTrace::record("Application", appStartUs,
+                              Ripes::StartupTrace::nowUs() - appStartUs);
   QCoreApplication::setApplicationName("Ripes");
 
   QCommandLineParser parser;
   Ripes::CLIModeOptions options;
-  initParser(parser, options);
   QString err;
-  switch (parseCommandLine(parser, err)) {
+  CommandLineParseResult parseResult;
+  {
+    Ripes::TraceSpan span("Command line parsing");
+    initParser(parser, options);
+    parseResult = parseCommandLine(parser, err);
+  }
+  switch (parseResult) {
   case CommandLineError:
     std::cerr << "ERROR: " << err.toStdString() << std::endl;
     parser.showHelp();
@@ -112,7 +168,8 @@ int main(int argc, char **argv) {
     parser.showHelp();
     return 0;
   case CommandLineGUI:
-    return guiMode(app);
+    return guiMode(static_cast<QApplication &>(*app),
+                   parser.value("startup-trace"));
   case CommandLineCLI:
     return CLIMode(parser, options);
   }
@@ -18,5 +18,22 @@ constructAssemblerDynamic(std::shared_ptr<ISAInfoBase> isa) {
   return {};
 }
 
+std::shared_ptr<AssemblerBase>
+getCachedAssembler(const std::shared_ptr<ISAInfoBase> &isa) {
+  static std::mutex cacheMutex;
+  static std::map<std::pair<ISA, QStringList>, std::shared_ptr<AssemblerBase>>
+      cache;
+
+  QStringList extensions = isa->enabledExtensions();
+  extensions.sort();
+  auto key = std::pair(isa->isaID(), extensions);
+
+  std::lock_guard<std::mutex> lock(cacheMutex);
+  auto it = cache.find(key);
+  if (it == cache.end())
+    it = cache.emplace(std::move(key), constructAssemblerDynamic(isa)).first;
+  return it->second;
+}
+
 } // namespace Assembler
 } // namespace Ripes
@@ -3,6 +3,7 @@
 #include <QRegularExpression>
 
 #include <cstdint>
+#include <mutex>
 #include <numeric>
 #include <set>
 #include <variant>
@@ -71,8 +72,12 @@ public:
 
   AssembleResult
   assemble(const QStringList &programLines, const SymbolMap *symbols = nullptr,
-           const QString &sourceHash = QString()) const override {
+           const QString &sourceHash = QString(),
+           const SegmentBases *segmentBases = nullptr) const override {
+    std::lock_guard<std::mutex> lock(m_assembleMutex);
     AssembleResult result;
+    m_sectionBasePointers =
+        segmentBases ? *segmentBases : m_defaultSegmentBases;
 
     /// by default, emit to .text until otherwise specified
     setCurrentSegment(Location::unknown(), ".text");
@@ -80,11 +85,14 @@ public:
     if (symbols) {
       m_symbolMap = *symbols;
     }
+    m_macros.clear();
+    m_macroExpansions.clear();
+    m_macroCounter = 0;
 
     /// Tokenize each source line and separate symbol from remainder of tokens
     runPass(tokenizedLines, SourceProgram, pass0, programLines);
 
-    /// Pseudo instruction expansion
+    /// Macro and pseudo instruction expansion
     runPass(expandedLines, SourceProgram, pass1, tokenizedLines);
 
     /** Assemble. During assembly, we generate:
@@ -203,6 +211,8 @@ public:
   }
 
 protected:
+  unsigned addressBits() const override { return m_isa->bits(); }
+
   struct LinkRequest : public Location {
     // sourceLine: Source location of code which resulted in the link request
     LinkRequest(const Location &location) : Location(location) {}
@@ -241,24 +251,58 @@ protected:
      * line).
      */
     Symbols carry;
+
+    /** @brief repetitions
+     * Stack of the currently open .rept blocks. A block is repeated once its
+     * .endr is reached, by duplicating the already tokenized lines of the
+     * block; the source of a block is thus only tokenized once, regardless of
+     * the repetition count.
+     */
+    struct Repetition {
+      Location location;
+      int64_t count;
+      size_t firstLine; // Index of the first line of the block
+      // Symbols preceding the block, referring to the first repetition.
+      Symbols symbols;
+    };
+    std::vector<Repetition> repetitions;
+
+    /** @brief macro
+     * The macro currently being defined. Lines between .macro and .endm are
+     * recorded verbatim as the macro body; they are tokenized upon expansion,
+     * once their parameters have been substituted.
+     */
+    std::optional<Macro> macro;
+
     for (auto line : llvm::enumerate(program)) {
       if (line.value().isEmpty())
         continue;
-      TokenizedSrcLine tsl(line.index());
-      runOperation(tokens, tokenizeQuotes, tsl, line.value());
-
-      runOperation(remainingTokens, splitCommentFromLine, tokens);
-
-      runOperation(joinedParentheses, joinParentheses, tsl, remainingTokens);
 
-      // Symbols precede directives
-      runOperation(symbolsAndRest, splitSymbolsFromLine, tsl,
-                   joinedParentheses);
+      if (macro) {
+        const QString directive = leadingDirective(line.index(), line.value());
+        if (directive == ".endm") {
+          m_macros.insert_or_assign(macro->name, *macro);
+          macro.reset();
+        } else if (directive == ".macro") {
+          errors.push_back(Error(Location(line.index()),
+                                 "Nested macro definitions are not supported"));
+        } else if (directive == ".rept" || directive == ".endr") {
+          // .rept blocks are unrolled while tokenizing, before macros are
+          // expanded.
+          errors.push_back(Error(Location(line.index()),
+                                 "'" + directive +
+                                     "' is not supported inside .macro"));
+        } else {
+          macro->usesCounter |= line.value().contains("\\@");
+          macro->body.push_back({line.index(), line.value()});
+        }
+        continue;
+      }
 
-      tsl.symbols = symbolsAndRest.first;
+      runOperation(tsl, tokenizeLine, line.index(), line.value());
 
       bool uniqueSymbols = true;
-      for (const auto &s : symbolsAndRest.first) {
+      for (const auto &s : tsl.symbols) {
         if (!s.isLegal())
           errors.push_back(Error(tsl, "Illegal symbol '" + s.v + "'"));
 
@@ -272,17 +316,75 @@ protected:
       if (!uniqueSymbols) {
         continue;
       }
-      symbols.insert(symbolsAndRest.first.begin(), symbolsAndRest.first.end());
+      symbols.insert(tsl.symbols.begin(), tsl.symbols.end());
 
-      runOperation(directiveAndRest, splitDirectivesFromLine, tsl,
-                   symbolsAndRest.second);
-      tsl.directive = directiveAndRest.first;
+      if (tsl.directive == ".macro") {
+        runOperation(definition, parseMacroDefinition, tsl);
+        if (m_macros.count(definition.name) != 0) {
+          errors.push_back(Error(tsl, "Multiple definitions of macro '" +
+                                          definition.name + "'"));
+          continue;
+        }
+        carry.insert(tsl.symbols.begin(), tsl.symbols.end());
+        macro = definition;
+        continue;
+      }
+      if (tsl.directive == ".endm") {
+        errors.push_back(Error(tsl, "'.endm' without matching '.macro'"));
+        continue;
+      }
 
-      // Parse (and remove) relocation hints from the tokens.
-      runOperation(finalTokens, splitRelocationsFromLine,
-                   directiveAndRest.second);
+      if (tsl.directive == ".rept") {
+        if (tsl.tokens.size() != 1) {
+          errors.push_back(Error(tsl, "Expected a single repetition count"));
+          continue;
+        }
+        auto countRes = evalExpr(tsl, tsl.tokens.at(0));
+        if (auto *err = std::get_if<Error>(&countRes)) {
+          errors.push_back(*err);
+          continue;
+        }
+        const int64_t count = std::get<ExprEvalVT>(countRes);
+        if (count < 0) {
+          errors.push_back(Error(tsl, "Repetition count must be positive"));
+          continue;
+        }
+        Symbols blockSymbols = carry;
+        blockSymbols.insert(tsl.symbols.begin(), tsl.symbols.end());
+        carry.clear();
+        repetitions.push_back(
+            {tsl, count, tokenizedLines.size(), blockSymbols});
+        continue;
+      }
+      if (tsl.directive == ".endr") {
+        if (repetitions.empty()) {
+          errors.push_back(Error(tsl, "'.endr' without matching '.rept'"));
+          continue;
+        }
+        const auto repetition = repetitions.back();
+        repetitions.pop_back();
+        if (repetition.count == 0)
+          tokenizedLines.resize(repetition.firstLine);
+        if (tokenizedLines.size() == repetition.firstLine) {
+          // Empty block; symbols preceding it refer to the next line.
+          carry.insert(repetition.symbols.begin(), repetition.symbols.end());
+        } else {
+          const SourceProgram block(tokenizedLines.begin() +
+                                        repetition.firstLine,
+                                    tokenizedLines.end());
+          tokenizedLines.reserve(tokenizedLines.size() +
+                                 block.size() * (repetition.count - 1));
+          for (int64_t i = 1; i < repetition.count; ++i)
+            tokenizedLines.insert(tokenizedLines.end(), block.begin(),
+                                  block.end());
+          tokenizedLines.at(repetition.firstLine)
+              .symbols.insert(repetition.symbols.begin(),
+                              repetition.symbols.end());
+        }
+        carry.insert(tsl.symbols.begin(), tsl.symbols.end());
+        continue;
+      }
 
-      tsl.tokens = finalTokens;
       if (tsl.tokens.empty() && tsl.directive.isEmpty()) {
         if (!tsl.symbols.empty()) {
           carry.insert(tsl.symbols.begin(), tsl.symbols.end());
@@ -300,6 +402,13 @@ protected:
       }
     }
 
+    for (const auto &repetition : repetitions)
+      errors.push_back(
+          Error(repetition.location, "'.rept' without matching '.endr'"));
+    if (macro)
+      errors.push_back(
+          Error(macro->location, "'.macro' without matching '.endm'"));
+
     if (!errors.empty()) {
       return {errors};
     } else {
@@ -309,7 +418,7 @@ protected:
 
   /**
    * @brief pass1
-   * Pseudo-op expansion. If @return errors is empty, pass succeeded.
+   * Macro and pseudo-op expansion. If @return errors is empty, pass succeeded.
    */
   std::variant<Errors, SourceProgram>
   pass1(const SourceProgram &tokenizedLines) const {
@@ -317,28 +426,12 @@ protected:
     SourceProgram expandedLines;
     expandedLines.reserve(tokenizedLines.size());
 
-    for (auto tokenizedLine : llvm::enumerate(tokenizedLines)) {
-      auto expandedOps = expandPseudoOp(tokenizedLine.value());
-      if (expandedOps.isResult()) {
-        /** @note: Original source line is kept for all resulting lines after
-         * pseudo-op expantion. Labels and directives are only kept for the
-         * first expanded op.
-         */
-        const auto &eops = expandedOps.value();
-        for (auto eop : llvm::enumerate(eops)) {
-          TokenizedSrcLine tsl(tokenizedLine.value().sourceLine());
-          tsl.tokens = eop.value();
-          if (eop.index() == 0) {
-            tsl.directive = tokenizedLine.value().directive;
-            tsl.symbols = tokenizedLine.value().symbols;
-          }
-          expandedLines.push_back(tsl);
-        }
-      } else {
-        // This was not a pseudoinstruction; just add line to the set of
-        // expanded lines
-        expandedLines.push_back(tokenizedLine.value());
-      }
+    // Symbols preceding a macro which expanded to nothing refer to the next
+    // line.
+    Symbols carry;
+    for (const auto &tokenizedLine : tokenizedLines) {
+      if (auto err = expandLine(tokenizedLine, expandedLines, carry, 0))
+        errors.push_back(*err);
     }
 
     if (errors.size() != 0) {
@@ -348,6 +441,70 @@ protected:
     }
   }
 
+  /**
+   * @brief expandLine
+   * Expands @p line into @p expandedLines. Macro invocations are replaced by
+   * the (recursively expanded) lines of the macro body, and pseudo-ops by the
+   * instructions they expand to. Any other line is kept as is.
+   */
+  std::optional<Error> expandLine(const TokenizedSrcLine &line,
+                                  SourceProgram &expandedLines, Symbols &carry,
+                                  unsigned depth) const {
+    if (!line.tokens.empty() && m_macros.count(line.tokens.at(0)) != 0) {
+      if (depth >= s_maxMacroDepth) {
+        return Error(line, "Macro expansion of '" + line.tokens.at(0) +
+                               "' nested too deeply (recursive macro?)");
+      }
+      auto expansion = expandMacro(line);
+      if (expansion.isError())
+        return expansion.error();
+      carry.insert(line.symbols.begin(), line.symbols.end());
+      for (const auto &expandedLine : expansion.value()) {
+        // Early directives are executed as they are encountered, as in pass0
+        if (m_earlyDirectives.count(expandedLine.directive)) {
+          bool wasDirective; // unused
+          auto res = assembleDirective(DirectiveArg{expandedLine, nullptr},
+                                       wasDirective, false);
+          if (res.isError())
+            return res.error();
+        }
+        if (auto err =
+                expandLine(expandedLine, expandedLines, carry, depth + 1))
+          return err;
+      }
+      return {};
+    }
+
+    auto expandedOps = expandPseudoOp(line);
+    if (expandedOps.isResult()) {
+      /** @note: Original source line is kept for all resulting lines after
+       * pseudo-op expantion. Labels and directives are only kept for the
+       * first expanded op.
+       */
+      const auto &eops = expandedOps.value();
+      for (auto eop : llvm::enumerate(eops)) {
+        TokenizedSrcLine tsl(line.sourceLine());
+        tsl.tokens = eop.value();
+        if (eop.index() == 0) {
+          tsl.directive = line.directive;
+          tsl.symbols = line.symbols;
+          tsl.symbols.insert(carry.begin(), carry.end());
+          carry.clear();
+        }
+        expandedLines.push_back(tsl);
+      }
+    } else {
+      // This was not a pseudoinstruction; just add line to the set of
+      // expanded lines
+      expandedLines.push_back(line);
+      if (!carry.empty()) {
+        expandedLines.back().symbols.insert(carry.begin(), carry.end());
+        carry.clear();
+      }
+    }
+    return {};
+  }
+
   /**
    * @brief pass2
    * Machine code translation. If @return errors is empty, pass succeeded.
@@ -513,6 +670,213 @@ protected:
     }
   }
 
+  /**
+   * @brief tokenizeLine
+   * Tokenizes a single source line, and separates symbols, the directive and
+   * relocation hints from the remaining tokens.
+   */
+  Result<TokenizedSrcLine> tokenizeLine(unsigned sourceLine,
+                                        const QString &line) const {
+    TokenizedSrcLine tsl(sourceLine);
+    auto tokens = tokenizeQuotes(tsl, line);
+    if (tokens.isError())
+      return tokens.error();
+
+    auto remainingTokens = splitCommentFromLine(tokens.value());
+    if (remainingTokens.isError())
+      return remainingTokens.error();
+
+    auto joinedParentheses = joinParentheses(tsl, remainingTokens.value());
+    if (joinedParentheses.isError())
+      return joinedParentheses.error();
+
+    // Symbols precede directives
+    auto symbolsAndRest = splitSymbolsFromLine(tsl, joinedParentheses.value());
+    if (symbolsAndRest.isError())
+      return symbolsAndRest.error();
+    tsl.symbols = symbolsAndRest.value().first;
+
+    auto directiveAndRest =
+        splitDirectivesFromLine(tsl, symbolsAndRest.value().second);
+    if (directiveAndRest.isError())
+      return directiveAndRest.error();
+    tsl.directive = directiveAndRest.value().first;
+
+    // Parse (and remove) relocation hints from the tokens.
+    LineTokens rest = directiveAndRest.value().second;
+    auto finalTokens = splitRelocationsFromLine(rest);
+    if (finalTokens.isError())
+      return finalTokens.error();
+    tsl.tokens = finalTokens.value();
+    return tsl;
+  }
+
+  /// A user-defined macro (.macro/.endm).
+  struct Macro {
+    Macro(const Location &_location) : location(_location) {}
+    Location location;
+    QString name;
+    QStringList params;
+    // Default value of each parameter; empty if none was given.
+    QStringList defaults;
+    // Source lines of the macro body, and their line indices.
+    std::vector<std::pair<unsigned, QString>> body;
+    // Whether the body refers to the expansion counter ('\@'), in which case
+    // expansions differ between invocations and are not cached.
+    bool usesCounter = false;
+  };
+
+  /// Maximum nesting depth of macro invocations within macro bodies.
+  static constexpr unsigned s_maxMacroDepth = 64;
+
+  /**
+   * @brief leadingDirective
+   * Returns the directive which @p line starts with, if any, following any
+   * labels. Used to find the end of a macro body without tokenizing the body
+   * itself.
+   */
+  QString leadingDirective(unsigned sourceLine, const QString &line) const {
+    auto tokens = tokenizeQuotes(Location(sourceLine), line);
+    if (tokens.isError())
+      return QString();
+    auto remainingTokens = splitCommentFromLine(tokens.value());
+    if (remainingTokens.isError() || remainingTokens.value().isEmpty())
+      return QString();
+    for (const auto &token : remainingTokens.value()) {
+      if (!token.endsWith(':'))
+        return token.startsWith('.') ? token : QString();
+    }
+    return QString();
+  }
+
+  /**
+   * @brief parseMacroDefinition
+   * Parses the '.macro name [param[=default]]...' line @p line.
+   */
+  Result<Macro> parseMacroDefinition(const TokenizedSrcLine &line) const {
+    if (line.tokens.empty()) {
+      return Error(line, "Expected a macro name");
+    }
+    Macro macro(line);
+    macro.name = line.tokens.at(0);
+    for (const auto &token : line.tokens.mid(1)) {
+      const int eq = token.indexOf('=');
+      const QString param = eq < 0 ? QString(token) : token.left(eq);
+      if (param.isEmpty() || param.contains(s_exprOperatorsRegex)) {
+        return Error(line, "Invalid macro parameter '" + token + "'");
+      }
+      if (macro.params.contains(param)) {
+        return Error(line, "Duplicate macro parameter '" + param + "'");
+      }
+      macro.params << param;
+      macro.defaults << (eq < 0 ? QString() : token.mid(eq + 1));
+    }
+    return macro;
+  }
+
+  /**
+   * @brief expandMacro
+   * Expands the macro invoked by @p line. Arguments are bound to parameters by
+   * position, or by name ('param=value'); unbound parameters take their
+   * default value. Each parameter name prefixed by a backslash in the body is
+   * replaced by its argument, and a backslash followed by '@' by the number of
+   * macro expansions performed so far.
+   * Expansions are cached per macro and argument tuple, such that a body is
+   * only tokenized once for each unique set of arguments.
+   */
+  Result<SourceProgram> expandMacro(const TokenizedSrcLine &line) const {
+    const Macro &macro = m_macros.at(line.tokens.at(0));
+
+    QStringList args = macro.defaults;
+    int position = 0;
+    for (const auto &token : line.tokens.mid(1)) {
+      const QString arg = token.hasRelocation()
+                              ? token.relocation() + " " + token
+                              : QString(token);
+      const int eq = arg.indexOf('=');
+      const int named = eq > 0 ? macro.params.indexOf(arg.left(eq)) : -1;
+      if (named >= 0) {
+        args[named] = arg.mid(eq + 1);
+      } else if (position < macro.params.size()) {
+        args[position++] = arg;
+      } else {
+        return Error(line, "Too many arguments to macro '" + macro.name + "'");
+      }
+    }
+
+    const QString key = macro.name + QChar(0) + args.join(QChar(0));
+    auto cached = m_macroExpansions.find(key);
+    if (cached == m_macroExpansions.end() || macro.usesCounter) {
+      std::vector<MacroLine> expansion;
+      Symbols carry;
+      for (const auto &[bodyLine, text] : macro.body) {
+        auto tsl = tokenizeLine(line.sourceLine(),
+                                substituteMacroArgs(macro, text, args));
+        if (tsl.isError()) {
+          return Error(line, "In expansion of macro '" + macro.name +
+                                 "' (line " + QString::number(bodyLine + 1) +
+                                 "): " + tsl.error().errorMessage());
+        }
+        const auto &expandedLine = tsl.value();
+        if (expandedLine.tokens.empty() && expandedLine.directive.isEmpty()) {
+          carry.insert(expandedLine.symbols.begin(),
+                       expandedLine.symbols.end());
+          continue;
+        }
+        MacroLine macroLine{expandedLine.symbols, expandedLine.directive,
+                            expandedLine.tokens};
+        macroLine.symbols.insert(carry.begin(), carry.end());
+        carry.clear();
+        expansion.push_back(macroLine);
+      }
+      if (!carry.empty()) {
+        return Error(line, "Symbol at the end of macro '" + macro.name +
+                               "' does not precede any line");
+      }
+      cached = m_macroExpansions.insert_or_assign(key, expansion).first;
+    }
+    ++m_macroCounter;
+
+    SourceProgram expandedLines;
+    expandedLines.reserve(cached->second.size());
+    for (const auto &macroLine : cached->second) {
+      TokenizedSrcLine tsl(line.sourceLine());
+      tsl.symbols = macroLine.symbols;
+      tsl.directive = macroLine.directive;
+      tsl.tokens = macroLine.tokens;
+      expandedLines.push_back(tsl);
+    }
+    return expandedLines;
+  }
+
+  /// Substitutes the macro arguments @p args into a line of a macro body.
+  QString substituteMacroArgs(const Macro &macro, const QString &text,
+                              const QStringList &args) const {
+    static const QRegularExpression paramRegex(
+        R"(\\(@|\(\)|[A-Za-z_][A-Za-z0-9_$]*))");
+    QString result;
+    qsizetype last = 0;
+    auto it = paramRegex.globalMatch(text);
+    while (it.hasNext()) {
+      const auto match = it.next();
+      result += text.mid(last, match.capturedStart() - last);
+      last = match.capturedEnd();
+      const QString name = match.captured(1);
+      const int idx = macro.params.indexOf(name);
+      if (name == "@") {
+        result += QString::number(m_macroCounter);
+      } else if (name == "()") {
+        // Separates a parameter from directly following text.
+      } else if (idx >= 0) {
+        result += args.at(idx);
+      } else {
+        result += match.captured(0);
+      }
+    }
+    result += text.mid(last);
+    return result;
+  }
+
   virtual Result<std::vector<LineTokens>>
   expandPseudoOp(const TokenizedSrcLine &line) const {
     if (line.tokens.empty()) {
@@ -650,39 +1014,44 @@ protected:
   std::unique_ptr<Matcher> m_matcher;
 
   std::shared_ptr<ISAInfoBase> m_isa;
-};
 
-/// An Assembler and QObject (workaround because QObject cannot be directly
-/// subclassed by ISA_Assembler)
-class QAssembler : public QObject, public Assembler {
-  Q_OBJECT
-public:
-  QAssembler(std::shared_ptr<ISAInfoBase> isaInfo) : Assembler(isaInfo) {
-    // Initialize segment pointers and monitor settings changes to segment
-    // pointers
-    connect(RipesSettings::getObserver(RIPES_SETTING_ASSEMBLER_TEXTSTART),
-            &SettingObserver::modified, this, [this](const QVariant &value) {
-              setSegmentBase(".text", value.toULongLong());
-            });
-    RipesSettings::getObserver(RIPES_SETTING_ASSEMBLER_TEXTSTART)->trigger();
-    connect(RipesSettings::getObserver(RIPES_SETTING_ASSEMBLER_DATASTART),
-            &SettingObserver::modified, this, [this](const QVariant &value) {
-              setSegmentBase(".data", value.toULongLong());
-            });
-    RipesSettings::getObserver(RIPES_SETTING_ASSEMBLER_DATASTART)->trigger();
-    connect(RipesSettings::getObserver(RIPES_SETTING_ASSEMBLER_BSSSTART),
-            &SettingObserver::modified, this, [this](const QVariant &value) {
-              setSegmentBase(".bss", value.toULongLong());
-            });
-    RipesSettings::getObserver(RIPES_SETTING_ASSEMBLER_BSSSTART)->trigger();
-  }
+  /// A line of an expanded macro, independent of the invoking source line.
+  struct MacroLine {
+    Symbols symbols;
+    QString directive;
+    LineTokens tokens;
+  };
+
+  /**
+   * @brief m_macros contains the macros defined in the program being
+   * assembled, and m_macroExpansions the expansions of these, keyed by macro
+   * name and arguments. Per-assembly state, like m_symbolMap.
+   */
+  mutable std::map<QString, Macro> m_macros;
+  mutable std::map<QString, std::vector<MacroLine>> m_macroExpansions;
+  mutable unsigned m_macroCounter = 0;
 };
 
-/// An ISA-specific assembler
+/// Returns the segment base pointers configured in the settings.
+inline SegmentBases segmentBasesFromSettings() {
+  return {
+      {".text",
+       RipesSettings::value(RIPES_SETTING_ASSEMBLER_TEXTSTART).toULongLong()},
+      {".data",
+       RipesSettings::value(RIPES_SETTING_ASSEMBLER_DATASTART).toULongLong()},
+      {".bss",
+       RipesSettings::value(RIPES_SETTING_ASSEMBLER_BSSSTART).toULongLong()}};
+}
+
+/// An ISA-specific assembler. Assemblers are plain objects which may be shared
+/// between threads (see getCachedAssembler()); the default segment base
+/// pointers are initialized from the settings at construction, and are kept
+/// up to date with the settings by ProcessorHandler for its assembler.
 template <ISA isa>
-struct ISA_Assembler : public QAssembler {
-  ISA_Assembler(std::shared_ptr<ISAInfoBase> isaInfo) : QAssembler(isaInfo) {
+struct ISA_Assembler : public Assembler {
+  ISA_Assembler(std::shared_ptr<ISAInfoBase> isaInfo) : Assembler(isaInfo) {
     initialize(gnuDirectives());
+    setSegmentBases(segmentBasesFromSettings());
   }
 
   ISA getISA() const override { return isa; }
@@ -696,6 +1065,15 @@ protected:
 std::shared_ptr<AssemblerBase>
 constructAssemblerDynamic(std::shared_ptr<ISAInfoBase> isa);
 
+/// Returns a shared assembler for isa. Assemblers are cached process-wide,
+/// keyed by the ISA and its set of enabled extensions, such that the cost of
+/// constructing an assembler (instruction maps, matcher tree) is only paid
+/// once per ISA configuration, rather than on every processor selection.
+/// Assembling and disassembling through a shared assembler is thread-safe.
+/// Throws a runtime error if the isa does not have a matching assembler
+std::shared_ptr<AssemblerBase>
+getCachedAssembler(const std::shared_ptr<ISAInfoBase> &isa);
+
 } // namespace Assembler
 
 } // namespace Ripes
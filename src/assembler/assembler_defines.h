@@ -18,6 +18,7 @@ using SymbolLinePair = std::pair<Symbols, LineTokens>;
 using SourceProgram = std::vector<TokenizedSrcLine>;
 using NoPassResult = std::monostate;
 using Section = QString;
+using SegmentBases = std::map<Section, AInt>;
 
 /**
  * @brief The Result struct
@@ -2,6 +2,8 @@
 
 #include "parserutilities.h"
 
+#include <algorithm>
+
 namespace Ripes {
 namespace Assembler {
 
@@ -24,16 +26,42 @@ AssemblerBase::setCurrentSegment(const Location &location,
   return {};
 }
 
-/// Sets the base pointer of seg to the provided 'base' value.
+/// Sets the default base pointer of seg to the provided 'base' value.
 void AssemblerBase::setSegmentBase(Section seg, AInt base) {
-  m_sectionBasePointers[seg] = base;
+  std::lock_guard<std::mutex> lock(m_assembleMutex);
+  m_defaultSegmentBases[seg] = base;
+}
+
+void AssemblerBase::setSegmentBases(const SegmentBases &bases) {
+  std::lock_guard<std::mutex> lock(m_assembleMutex);
+  m_defaultSegmentBases = bases;
+}
+
+SegmentBases AssemblerBase::getSegmentBases() const {
+  std::lock_guard<std::mutex> lock(m_assembleMutex);
+  return m_defaultSegmentBases;
 }
 
-AssembleResult AssemblerBase::assembleRaw(const QString &program,
-                                          const SymbolMap *symbols) const {
+AssembleResult
+AssemblerBase::assembleRaw(const QString &program, const SymbolMap *symbols,
+                           const SegmentBases *segmentBases) const {
   const auto programLines = program.split(QRegularExpression("[\r\n]"));
   return assemble(programLines, symbols,
-                  Program::calculateHash(program.toUtf8()));
+                  Program::calculateHash(program.toUtf8()), segmentBases);
+}
+
+uint64_t
+AssemblerBase::sectionBytesAvailable(const ProgramSection *section) const {
+  if (!section)
+    return UINT64_MAX;
+  const uint64_t start = section->address + section->data.size();
+  // Exclusive end of the address space; saturated for 64-bit address spaces.
+  uint64_t end = addressBits() >= 64 ? UINT64_MAX : 1ull << addressBits();
+  for (const auto &[name, base] : m_sectionBasePointers) {
+    if (base > section->address)
+      end = std::min<uint64_t>(end, base);
+  }
+  return end > start ? end - start : 0;
 }
 
 /// Resolves an expression through either the built-in symbol map, or through
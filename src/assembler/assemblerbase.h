@@ -2,6 +2,7 @@
 
 #include <QRegularExpression>
 
+#include <mutex>
 #include <optional>
 
 #include "assembler_defines.h"
@@ -32,9 +33,16 @@ public:
   std::optional<Error> setCurrentSegment(const Location &location,
                                          const Section &seg) const;
 
-  /// Sets the base pointer of seg to the provided 'base' value.
+  /// Sets the default base pointer of seg to the provided 'base' value.
   void setSegmentBase(Section seg, AInt base);
 
+  /// Sets the default base pointers of all segments.
+  void setSegmentBases(const SegmentBases &bases);
+
+  /// Returns the default base pointers of the segments, used by assemblies
+  /// which are not provided with their own.
+  SegmentBases getSegmentBases() const;
+
   /// Returns the ISA that this assembler is used for.
   virtual ISA getISA() const = 0;
 
@@ -42,12 +50,16 @@ public:
   /// a set of predefined symbols may be provided to the assemble call. If
   /// programLines does not represent the source program directly (possibly due
   /// to conversion of newline/cr/..., an explicit hash of the source program
-  /// can be provided for later identification.
+  /// can be provided for later identification. If @p segmentBases is
+  /// provided, it overrides the default segment base pointers for this
+  /// assembly.
   virtual AssembleResult
   assemble(const QStringList &programLines, const SymbolMap *symbols = nullptr,
-           const QString &sourceHash = QString()) const = 0;
+           const QString &sourceHash = QString(),
+           const SegmentBases *segmentBases = nullptr) const = 0;
   AssembleResult assembleRaw(const QString &program,
-                             const SymbolMap *symbols = nullptr) const;
+                             const SymbolMap *symbols = nullptr,
+                             const SegmentBases *segmentBases = nullptr) const;
 
   /// Disassembles an input program relative to the provided base address.
   virtual DisassembleResult disassemble(const Program &program,
@@ -73,6 +85,11 @@ public:
   /// the expression evaluator.
   ExprEvalRes evalExpr(const Location &location, const QString &expr) const;
 
+  /// Returns the number of bytes which may still be emitted into @p section,
+  /// before reaching the base of the following section or the end of the
+  /// address space. Unbounded if @p section is not set.
+  uint64_t sectionBytesAvailable(const ProgramSection *section) const;
+
   /// Set the supported directives for this assembler.
   void setDirectives(const DirectiveVec &directives);
 
@@ -113,11 +130,25 @@ protected:
   /// Returns the comment-delimiting character for this assembler.
   virtual QChar commentDelimiter() const = 0;
 
+  /// Returns the width of the address space targeted by this assembler, in
+  /// bits.
+  virtual unsigned addressBits() const = 0;
+
+  /**
+   * @brief m_defaultSegmentBases holds the segment base pointers used by
+   * assemblies which do not provide their own. Guarded by m_assembleMutex,
+   * since it may be updated while the assembler is in use by another thread.
+   */
+  SegmentBases m_defaultSegmentBases;
   /**
    * @brief m_sectionBasePointers maintains the base position for the segments
-   * annoted by the Segment enum class.
+   * of the current assembly. Marked mutable since it is per-assembly state.
    */
-  std::map<Section, AInt> m_sectionBasePointers;
+  mutable SegmentBases m_sectionBasePointers;
+
+  /// Serializes assemblies through a (possibly shared) assembler, since the
+  /// symbol map, segment bases and current section are per-assembly state.
+  mutable std::mutex m_assembleMutex;
   /**
    * @brief m_currentSegment maintains the current segment where the assembler
    * emits information. Marked mutable to allow for switching currently selected
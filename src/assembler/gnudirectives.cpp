@@ -1,6 +1,8 @@
 #include "gnudirectives.h"
 #include "assembler.h"
 
+#include <QFile>
+
 namespace Ripes {
 namespace Assembler {
 
@@ -27,6 +29,10 @@ DirectiveVec gnuDirectives() {
   add_directive(directives, stringDirective());
   add_directive(directives, ascizDirective());
   add_directive(directives, zeroDirective());
+  add_directive(directives, spaceDirective(".space"));
+  add_directive(directives, spaceDirective(".skip"));
+  add_directive(directives, fillDirective());
+  add_directive(directives, incbinDirective());
   add_directive(directives, byteDirective());
   add_directive(directives, doubleDirective());
   add_directive(directives, wordDirective());
@@ -176,6 +182,123 @@ Directive zeroDirective() {
   return Directive(".zero", zeroFunctor);
 }
 
+Directive spaceDirective(const QString &name) {
+  auto spaceFunctor = [](const AssemblerBase *assembler,
+                         const DirectiveArg &arg) -> Result<QByteArray> {
+    if (arg.line.tokens.length() == 0 || arg.line.tokens.length() > 2) {
+      return {Error(
+          arg.line,
+          "Invalid number of arguments (expected at least 1, at most 2)")};
+    }
+    int64_t size, fill = 0;
+    getImmediateErroring(arg.line.tokens.at(0), size, arg.line);
+    if (arg.line.tokens.size() > 1) {
+      getImmediateErroring(arg.line.tokens.at(1), fill, arg.line);
+    }
+    if (size < 0) {
+      return {Error(arg.line, "Size must be positive")};
+    }
+    if (fill < 0 || fill > UINT8_MAX) {
+      return {Error(arg.line, "Fill value must be in range [0;255]")};
+    }
+    if (static_cast<uint64_t>(size) >
+        assembler->sectionBytesAvailable(arg.section)) {
+      return {Error(arg.line, "Size exceeds the space left in the section")};
+    }
+    return {QByteArray(size, static_cast<char>(fill))};
+  };
+  return Directive(name, spaceFunctor);
+}
+
+Directive fillDirective() {
+  auto fillFunctor = [](const AssemblerBase *assembler,
+                        const DirectiveArg &arg) -> Result<QByteArray> {
+    if (arg.line.tokens.length() == 0 || arg.line.tokens.length() > 3) {
+      return {Error(
+          arg.line,
+          "Invalid number of arguments (expected at least 1, at most 3)")};
+    }
+    int64_t repeat, size = 1, value = 0;
+    getImmediateErroring(arg.line.tokens.at(0), repeat, arg.line);
+    if (arg.line.tokens.size() > 1) {
+      getImmediateErroring(arg.line.tokens.at(1), size, arg.line);
+    }
+    if (arg.line.tokens.size() > 2) {
+      getImmediateErroring(arg.line.tokens.at(2), value, arg.line);
+    }
+    if (repeat < 0) {
+      return {Error(arg.line, "Repeat count must be positive")};
+    }
+    if (size < 0 || size > 8) {
+      return {Error(arg.line, "Size must be in range [0;8]")};
+    }
+    if (size > 0 && static_cast<uint64_t>(repeat) >
+                        assembler->sectionBytesAvailable(arg.section) / size) {
+      return {Error(arg.line,
+                    "Repeat count exceeds the space left in the section")};
+    }
+
+    // The value is emitted as a little-endian 'size'-byte quantity, truncated
+    // to the given size.
+    QByteArray element;
+    for (int64_t i = 0; i < size; ++i) {
+      element.append(static_cast<char>(value & 0xff));
+      value >>= 8;
+    }
+    return {element.repeated(repeat)};
+  };
+  return Directive(".fill", fillFunctor);
+}
+
+Directive incbinDirective() {
+  auto incbinFunctor = [](const AssemblerBase *assembler,
+                          const DirectiveArg &arg) -> Result<QByteArray> {
+    if (arg.line.tokens.length() == 0 || arg.line.tokens.length() > 3) {
+      return {Error(
+          arg.line,
+          "Invalid number of arguments (expected at least 1, at most 3)")};
+    }
+    QString path = arg.line.tokens.at(0);
+    if (!(path.startsWith('\"') && path.endsWith('\"') && path.size() > 1)) {
+      return {Error(arg.line, "Expected a quoted file name")};
+    }
+    path = path.mid(1, path.size() - 2);
+
+    int64_t skip = 0, count = -1;
+    if (arg.line.tokens.size() > 1) {
+      getImmediateErroring(arg.line.tokens.at(1), skip, arg.line);
+    }
+    if (arg.line.tokens.size() > 2) {
+      getImmediateErroring(arg.line.tokens.at(2), count, arg.line);
+      if (count < 0) {
+        return {Error(arg.line, "Count must be positive")};
+      }
+    }
+    if (skip < 0) {
+      return {Error(arg.line, "Skip must be positive")};
+    }
+
+    // The file contents are embedded verbatim; no tokenization or expression
+    // evaluation is performed on them. Relative paths are resolved against the
+    // current working directory.
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+      return {Error(arg.line, "Could not open file '" + path +
+                                  "': " + file.errorString())};
+    }
+    if (skip > file.size()) {
+      return {Error(arg.line, "Skip exceeds the size of file '" + path + "'")};
+    }
+    file.seek(skip);
+    const int64_t available = file.size() - skip;
+    if (count > available) {
+      return {Error(arg.line, "Count exceeds the size of file '" + path + "'")};
+    }
+    return {file.read(count < 0 ? available : count)};
+  };
+  return Directive(".incbin", incbinFunctor);
+}
+
 Directive equDirective() {
   auto equFunctor = [](const AssemblerBase *assembler,
                        const DirectiveArg &arg) -> Result<QByteArray> {
@@ -15,6 +15,9 @@ namespace Assembler {
 DirectiveVec gnuDirectives();
 
 Directive zeroDirective();
+Directive spaceDirective(const QString &name);
+Directive fillDirective();
+Directive incbinDirective();
 Directive stringDirective();
 Directive ascizDirective();
 
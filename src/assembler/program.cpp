@@ -111,4 +111,77 @@ bool Program::isSameSource(const QByteArray &data) const {
   return sourceHash == calculateHash(data);
 }
 
+QDataStream &operator<<(QDataStream &stream, const Program &program) {
+  stream << static_cast<quint64>(program.entryPoint);
+
+  stream << static_cast<quint32>(program.sections.size());
+  for (const auto &[name, section] : program.sections)
+    stream << name << section.name << static_cast<quint64>(section.address)
+           << section.data;
+
+  stream << static_cast<quint32>(program.symbols.size());
+  for (const auto &[address, symbol] : program.symbols)
+    stream << static_cast<quint64>(address) << symbol.v
+           << static_cast<quint32>(symbol.type);
+
+  stream << static_cast<quint32>(program.sourceMapping.size());
+  for (const auto &[address, lines] : program.sourceMapping) {
+    stream << static_cast<quint64>(address)
+           << static_cast<quint32>(lines.size());
+    for (const unsigned line : lines)
+      stream << static_cast<quint32>(line);
+  }
+
+  stream << program.sourceHash;
+  return stream;
+}
+
+QDataStream &operator>>(QDataStream &stream, Program &program) {
+  program = Program();
+  // Counts are checked against the stream status, such that a truncated or
+  // corrupted stream terminates reading rather than looping on bogus counts.
+  const auto ok = [&stream] { return stream.status() == QDataStream::Ok; };
+
+  quint64 entryPoint;
+  stream >> entryPoint;
+  program.entryPoint = entryPoint;
+
+  quint32 count;
+  stream >> count;
+  for (quint32 i = 0; i < count && ok(); ++i) {
+    QString name;
+    ProgramSection section;
+    quint64 address;
+    stream >> name >> section.name >> address >> section.data;
+    section.address = address;
+    program.sections[name] = section;
+  }
+
+  stream >> count;
+  for (quint32 i = 0; i < count && ok(); ++i) {
+    quint64 address;
+    Symbol symbol;
+    quint32 type;
+    stream >> address >> symbol.v >> type;
+    symbol.type = type;
+    program.symbols[address] = symbol;
+  }
+
+  stream >> count;
+  for (quint32 i = 0; i < count && ok(); ++i) {
+    quint64 address;
+    quint32 lineCount;
+    stream >> address >> lineCount;
+    auto &lines = program.sourceMapping[address];
+    for (quint32 j = 0; j < lineCount && ok(); ++j) {
+      quint32 line;
+      stream >> line;
+      lines.insert(line);
+    }
+  }
+
+  stream >> program.sourceHash;
+  return stream;
+}
+
 } // namespace Ripes
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QByteArray>
+#include <QDataStream>
 #include <QHash>
 #include <QMap>
 #include <QMetaType>
@@ -115,6 +116,12 @@ private:
   mutable DisassembledProgram disassembled;
 };
 
+/// Serializes the assembled contents of a program: the entry point, sections,
+/// symbols, source mapping and source hash. The disassembly is not serialized,
+/// since it is recomputed on demand.
+QDataStream &operator<<(QDataStream &stream, const Program &program);
+QDataStream &operator>>(QDataStream &stream, Program &program);
+
 } // namespace Ripes
 
 Q_DECLARE_METATYPE(Ripes::SourceType);
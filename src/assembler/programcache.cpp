@@ -0,0 +1,138 @@
+#include "programcache.h"
+#include "version/version.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+namespace Ripes {
+namespace Assembler {
+
+// Bumped whenever the format of cache entries, or the set of inputs hashed into
+// the key, changes.
+static constexpr qint32 c_programCacheFormat = 1;
+static constexpr quint32 c_programCacheMagic = 0x52504743; // "RPGC"
+// The oldest entries are removed when the cache grows beyond this size. To
+// avoid scanning the cache directory on every store, the cache is pruned on the
+// first store of a ProgramCache, and then on every c_pruneInterval'th store.
+static constexpr int c_maxEntries = 256;
+static constexpr unsigned c_pruneInterval = 32;
+
+ProgramCache::ProgramCache(const QString &directory)
+    : m_directory(directory) {}
+
+QString ProgramCache::defaultDirectory() {
+  return QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation))
+      .filePath("programs");
+}
+
+QString ProgramCache::key(const QString &source,
+                          const AssemblerBase &assembler,
+                          const ISAInfoBase &isa, const SymbolMap *symbols) {
+  QByteArray keyData;
+  QDataStream stream(&keyData, QIODevice::WriteOnly);
+
+  stream << c_programCacheFormat << getRipesVersion();
+
+  // Assembler configuration
+  stream << static_cast<qint32>(assembler.getISA()) << isa.name();
+  QStringList exts = isa.enabledExtensions();
+  exts.sort();
+  stream << exts;
+  for (const auto &[section, base] : assembler.getSegmentBases())
+    stream << section << static_cast<quint64>(base);
+  stream << (symbols != nullptr);
+  if (symbols) {
+    for (const auto &[symbol, value] : symbols->abs)
+      stream << symbol.v << static_cast<qint64>(value);
+    for (const auto &[id, lines] : symbols->rel) {
+      stream << static_cast<qint32>(id);
+      for (const auto &[line, value] : lines)
+        stream << static_cast<quint32>(line) << static_cast<qint64>(value);
+    }
+  }
+
+  // Source
+  stream << source;
+
+  return QCryptographicHash::hash(keyData, QCryptographicHash::Sha256)
+      .toHex();
+}
+
+QString ProgramCache::entryPath(const QString &key) const {
+  return QDir(m_directory).filePath(key + ".prog");
+}
+
+std::optional<Program> ProgramCache::lookup(const QString &key) const {
+  QFile file(entryPath(key));
+  if (!file.open(QIODevice::ReadOnly))
+    return {};
+
+  QDataStream stream(&file);
+  quint32 magic;
+  qint32 format;
+  QString version;
+  stream >> magic >> format >> version;
+  if (magic != c_programCacheMagic || format != c_programCacheFormat ||
+      version != getRipesVersion())
+    return {};
+
+  Program program;
+  stream >> program;
+  if (stream.status() != QDataStream::Ok)
+    return {};
+  return program;
+}
+
+bool ProgramCache::store(const QString &key, const Program &program) const {
+  if (!QDir().mkpath(m_directory))
+    return false;
+
+  // Write atomically, such that concurrent instances sharing the cache never
+  // observe a partially written entry.
+  QSaveFile file(entryPath(key));
+  if (!file.open(QIODevice::WriteOnly))
+    return false;
+  QDataStream stream(&file);
+  stream << c_programCacheMagic << c_programCacheFormat << getRipesVersion()
+         << program;
+  if (!file.commit())
+    return false;
+
+  if (m_storesUntilPrune == 0) {
+    prune();
+    m_storesUntilPrune = c_pruneInterval;
+  }
+  --m_storesUntilPrune;
+  return true;
+}
+
+void ProgramCache::prune() const {
+  const QFileInfoList entries = QDir(m_directory).entryInfoList(
+      {"*.prog"}, QDir::Files, QDir::Time);
+  for (int i = c_maxEntries; i < entries.size(); ++i)
+    QFile::remove(entries.at(i).filePath());
+}
+
+AssembleResult ProgramCache::assemble(const QString &source,
+                                      const AssemblerBase &assembler,
+                                      const ISAInfoBase &isa,
+                                      const SymbolMap *symbols) const {
+  if (source.contains(".incbin"))
+    return assembler.assembleRaw(source, symbols);
+
+  const QString cacheKey = key(source, assembler, isa, symbols);
+  if (auto program = lookup(cacheKey))
+    return {Errors(), *program};
+
+  auto res = assembler.assembleRaw(source, symbols);
+  if (res.errors.size() == 0)
+    store(cacheKey, res.program);
+  return res;
+}
+
+} // namespace Assembler
+} // namespace Ripes
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "assembler_defines.h"
+#include "assemblerbase.h"
+#include "program.h"
+
+#include <optional>
+
+namespace Ripes {
+namespace Assembler {
+
+/**
+ * @brief The ProgramCache class
+ * An on-disk cache of assembled programs. An entry holds a serialized Program,
+ * keyed by a hash of the source program and everything else which determines
+ * the output of the assembler (see key()): the ISA and its enabled
+ * extensions, the segment base addresses, the predefined symbols and the
+ * Ripes version. Entries are stored as one file per key.
+ *
+ * Only successfully assembled programs are cached. Sources including external
+ * files (.incbin) are never cached, since the included file is not part of
+ * the key.
+ */
+class ProgramCache {
+public:
+  explicit ProgramCache(const QString &directory);
+
+  /// Returns the per-user cache directory used by the GUI.
+  static QString defaultDirectory();
+
+  /// Computes the cache key for assembling @p source with @p assembler for
+  /// @p isa, given the predefined @p symbols.
+  static QString key(const QString &source, const AssemblerBase &assembler,
+                     const ISAInfoBase &isa, const SymbolMap *symbols);
+
+  /// Returns the cached program for @p key, if a valid entry exists.
+  std::optional<Program> lookup(const QString &key) const;
+
+  /// Stores @p program for @p key. Returns false if the entry could not be
+  /// written.
+  bool store(const QString &key, const Program &program) const;
+
+  /// Assembles @p source, serving the program from the cache if possible.
+  /// Successfully assembled programs are added to the cache.
+  AssembleResult assemble(const QString &source,
+                          const AssemblerBase &assembler,
+                          const ISAInfoBase &isa,
+                          const SymbolMap *symbols = nullptr) const;
+
+private:
+  QString entryPath(const QString &key) const;
+  void prune() const;
+
+  QString m_directory;
+  /// Number of stores until the cache directory is next pruned.
+  mutable unsigned m_storesUntilPrune = 0;
+};
+
+} // namespace Assembler
+} // namespace Ripes
@@ -22,7 +22,9 @@ CacheConfigWidget::CacheConfigWidget(QWidget *parent)
   // to the current configuration
   m_configItems = {
       m_ui->presets,           m_ui->ways,   m_ui->lines, m_ui->blocks,
-      m_ui->replacementPolicy, m_ui->wrMiss, m_ui->wrHit};
+      m_ui->replacementPolicy, m_ui->wrMiss, m_ui->wrHit,
+      m_ui->prefetchPolicy,    m_ui->hitLatency, m_ui->missLatency,
+      m_ui->writebackLatency};
 }
 
 void CacheConfigWidget::setCache(const std::shared_ptr<CacheSim> &cache) {
@@ -31,6 +33,7 @@ void CacheConfigWidget::setCache(const std::shared_ptr<CacheSim> &cache) {
   setupEnumCombobox(m_ui->replacementPolicy, s_cacheReplPolicyStrings);
   setupEnumCombobox(m_ui->wrHit, s_cacheWritePolicyStrings);
   setupEnumCombobox(m_ui->wrMiss, s_cacheWriteAllocateStrings);
+  setupEnumCombobox(m_ui->prefetchPolicy, s_cachePrefetchPolicyStrings);
 
   m_ui->ways->setValue(m_cache->getWays());
   m_ui->lines->setValue(m_cache->getLineBits());
@@ -59,6 +62,22 @@ void CacheConfigWidget::setCache(const std::shared_ptr<CacheSim> &cache) {
             m_cache->setWriteAllocatePolicy(
                 qvariant_cast<WriteAllocPolicy>(m_ui->wrMiss->itemData(index)));
           });
+  connect(m_ui->prefetchPolicy,
+          QOverload<int>::of(&QComboBox::currentIndexChanged), cache.get(),
+          [this](int index) {
+            m_cache->setPrefetchPolicy(qvariant_cast<PrefetchPolicy>(
+                m_ui->prefetchPolicy->itemData(index)));
+          });
+  for (auto *latency :
+       {m_ui->hitLatency, m_ui->missLatency, m_ui->writebackLatency}) {
+    latency->setToolTip(
+        "Latencies (in clock cycles) used to estimate the cycles the processor "
+        "stalls on memory accesses. The processor models assume single-cycle "
+        "memory; a hit latency of 1 and zero miss/writeback latencies thus add "
+        "no stall cycles.");
+    connect(latency, QOverload<int>::of(&QSpinBox::valueChanged),
+            cache.get(), [this] { m_cache->setTiming(currentTiming()); });
+  }
   connect(m_ui->savePresetButton, &QPushButton::clicked, this,
           &CacheConfigWidget::storePreset);
   m_ui->savePresetButton->setIcon(QIcon(":/icons/save.svg"));
@@ -90,6 +109,9 @@ void CacheConfigWidget::storePreset() {
     preset.wrPolicy = getEnumValue<WritePolicy>(m_ui->wrHit);
     preset.wrAllocPolicy = getEnumValue<WriteAllocPolicy>(m_ui->wrMiss);
     preset.replPolicy = getEnumValue<ReplPolicy>(m_ui->replacementPolicy);
+    preset.prefetchPolicy = getEnumValue<PrefetchPolicy>(m_ui->prefetchPolicy);
+    preset.timing = currentTiming();
+    preset.wordBytes = m_cache->getWordBytesSetting();
 
     auto presets = RipesSettings::value(RIPES_SETTING_CACHE_PRESETS)
                        .value<QList<Ripes::CachePreset>>();
@@ -103,6 +125,14 @@ void CacheConfigWidget::storePreset() {
   }
 }
 
+CacheTiming CacheConfigWidget::currentTiming() const {
+  CacheTiming timing;
+  timing.hitLatency = m_ui->hitLatency->value();
+  timing.missLatency = m_ui->missLatency->value();
+  timing.writebackLatency = m_ui->writebackLatency->value();
+  return timing;
+}
+
 void CacheConfigWidget::removePreset() {
   auto presetData = m_ui->presets->currentData();
   if (presetData.isNull()) {
@@ -159,6 +189,10 @@ void CacheConfigWidget::handleConfigurationChanged() {
   setEnumIndex(m_ui->wrHit, m_cache->getWritePolicy());
   setEnumIndex(m_ui->wrMiss, m_cache->getWriteAllocPolicy());
   setEnumIndex(m_ui->replacementPolicy, m_cache->getReplacementPolicy());
+  setEnumIndex(m_ui->prefetchPolicy, m_cache->getPrefetchPolicy());
+  m_ui->hitLatency->setValue(m_cache->getTiming().hitLatency);
+  m_ui->missLatency->setValue(m_cache->getTiming().missLatency);
+  m_ui->writebackLatency->setValue(m_cache->getTiming().writebackLatency);
 
   if (!m_justSetPreset) {
     m_ui->presets->setCurrentIndex(-1);
@@ -32,6 +32,7 @@ private:
   std::vector<QObject *> m_configItems;
   void storePreset();
   void removePreset();
+  CacheTiming currentTiming() const;
 
   /**
    * @brief m_justSetPreset
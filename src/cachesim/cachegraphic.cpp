@@ -4,9 +4,14 @@
 #include <QGraphicsLineItem>
 #include <QGraphicsRectItem>
 #include <QGraphicsScene>
+#include <QGraphicsSceneHoverEvent>
 #include <QGraphicsSimpleTextItem>
+#include <QPainter>
 #include <QPalette>
 #include <QPen>
+#include <QStyleOptionGraphicsItem>
+#include <climits>
+#include <cmath>
 
 #include "processorhandler.h"
 #include "radix.h"
@@ -14,16 +19,6 @@
 
 namespace {
 
-// Return a set of all keys in a map
-template <typename TK, typename TV>
-std::set<TK> keys(std::map<TK, TV> const &input_map) {
-  std::set<TK> keyset;
-  for (auto const &element : input_map) {
-    keyset.insert(element.first);
-  }
-  return keyset;
-}
-
 // True when the application is using a dark color scheme.
 bool cacheDarkMode() {
   return QApplication::palette().color(QPalette::Base).lightness() < 128;
@@ -122,191 +117,265 @@ CacheGraphic::CacheGraphic(CacheSim &cache)
   connect(ThemeManager::get(), &ThemeManager::themeChanged, this,
           [this] { cacheInvalidated(); });
 
+  // The exposed rect of the style option determines which cache lines are
+  // painted.
+  setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+  setAcceptHoverEvents(true);
+
   cacheInvalidated();
 }
 
-void CacheGraphic::updateLineReplFields(unsigned lineIdx) {
-  auto *cacheLine = m_cache.getLine(lineIdx);
+QRectF CacheGraphic::boundingRect() const {
+  return childrenBoundingRect().united(
+      QRectF(-m_indexWidth, 0, m_indexWidth + m_cacheWidth, m_cacheHeight));
+}
+
+QRectF CacheGraphic::lineRect(unsigned lineIdx) const {
+  return QRectF(-m_indexWidth, lineIdx * m_lineHeight,
+                m_indexWidth + m_cacheWidth, m_lineHeight);
+}
+
+bool CacheGraphic::hasReplFields() const {
+  return m_cache.getReplacementPolicy() == ReplPolicy::LRU &&
+         m_cache.getWays() > 1;
+}
 
-  if (cacheLine == nullptr) {
-    // Nothing to do
+void CacheGraphic::paint(QPainter *painter,
+                         const QStyleOptionGraphicsItem *option, QWidget *) {
+  if (m_cache.getLines() == 0 || m_lineHeight <= 0)
     return;
-  }
 
-  if (m_cacheTextItems.at(0).at(0).lru == nullptr) {
-    // The current cache configuration does not have any replacement field
+  // Determine the range of cache lines within the exposed area.
+  const QRectF exposed = option->exposedRect;
+  if (exposed.bottom() < 0 || exposed.top() > m_cacheHeight)
+    return;
+  const unsigned nLines = m_cache.getLines();
+  const unsigned firstLine =
+      static_cast<unsigned>(std::max<qreal>(0, exposed.top()) / m_lineHeight);
+  const unsigned lastLine = std::min<unsigned>(
+      nLines - 1, static_cast<unsigned>(exposed.bottom() / m_lineHeight));
+
+  const qreal lod =
+      QStyleOptionGraphicsItem::levelOfDetailFromTransform(
+          painter->worldTransform());
+
+  // The cache simulator is modified from the simulator thread whilst the
+  // processor is running, so its state is only painted when stopped.
+  const bool paintContents = !ProcessorHandler::isRunning();
+
+  if (m_setHeight * lod < c_minDetailedSetHeight) {
+    // Aggregate lines such that each heatmap row is at least a pixel high.
+    const unsigned linesPerRow = std::max(
+        1u, static_cast<unsigned>(std::ceil(1 / (m_lineHeight * lod))));
+    if (paintContents)
+      paintHeatmap(painter, firstLine, lastLine, linesPerRow);
+    painter->setPen(QPen(QApplication::palette().text().color(), 0));
+    painter->setBrush(Qt::NoBrush);
+    painter->drawRect(QRectF(0, 0, m_cacheWidth, m_cacheHeight));
     return;
   }
 
-  for (const auto &way : m_cacheTextItems[lineIdx]) {
-    // If LRU was just initialized, the actual (software) LRU value may be very
-    // large. Mask to the number of actual LRU bits.
-    unsigned lruVal = cacheLine->at(way.first).lru;
-    lruVal = std::min(static_cast<unsigned>(m_cache.getWays() - 1), lruVal);
-    const QString lruText = QString::number(lruVal);
-    way.second.lru->setText(lruText);
-
-    // LRU text might have changed; update LRU field position to center in
-    // column
-    const qreal y = lineIdx * m_lineHeight + way.first * m_setHeight;
-    const qreal x =
-        m_widthBeforeLRU + m_lruWidth / 2 - m_fm.horizontalAdvance(lruText) / 2;
-
-    way.second.lru->setPos(x, y);
-  }
+  if (paintContents)
+    paintLines(painter, firstLine, lastLine);
+  paintGrid(painter, firstLine, lastLine);
 }
 
-QString CacheGraphic::addressString() const {
-  return "0x" +
-         QString("0").repeated(ProcessorHandler::currentISA()->bytes() * 2);
-}
+void CacheGraphic::paintGrid(QPainter *painter, unsigned firstLine,
+                             unsigned lastLine) {
+  const QColor gridColor = QApplication::palette().text().color();
+  QPen solidPen(gridColor, 0);
+  QPen dashPen(gridColor, 0, Qt::DashLine);
+  const qreal top = firstLine * m_lineHeight;
+  const qreal bottom = (lastLine + 1) * m_lineHeight;
+
+  // Vertical column separators
+  painter->setPen(solidPen);
+  std::vector<qreal> columns = {0, m_bitWidth};
+  if (m_cache.getWritePolicy() == WritePolicy::WriteBack)
+    columns.push_back(m_widthBeforeDirty + m_bitWidth);
+  if (hasReplFields())
+    columns.push_back(m_widthBeforeLRU + m_lruWidth);
+  columns.push_back(m_widthBeforeBlocks);
+  for (int i = 1; i <= m_cache.getBlocks(); ++i)
+    columns.push_back(m_widthBeforeBlocks + i * m_blockWidth);
+  for (const qreal x : columns)
+    painter->drawLine(QLineF(x, top, x, bottom));
+
+  painter->setFont(m_font);
+  for (unsigned lineIdx = firstLine; lineIdx <= lastLine; ++lineIdx) {
+    // Cache line and cache way separators
+    const qreal y = lineIdx * m_lineHeight;
+    painter->setPen(solidPen);
+    painter->drawLine(QLineF(0, y, m_cacheWidth, y));
+    painter->setPen(dashPen);
+    for (int j = 1; j < m_cache.getWays(); j++) {
+      const qreal wayY = y + j * m_setHeight;
+      painter->drawLine(QLineF(0, wayY, m_cacheWidth, wayY));
+    }
 
-void CacheGraphic::updateWay(unsigned lineIdx, unsigned wayIdx) {
-  const auto &it = m_cacheTextItems.find(lineIdx);
-  if (it == m_cacheTextItems.end()) {
-    return;
+    // Line index number
+    painter->setPen(solidPen);
+    const QString text = QString::number(lineIdx);
+    const qreal x = -m_fm.horizontalAdvance(text) * 1.2;
+    painter->drawText(
+        QRectF(x, y, m_fm.horizontalAdvance(text) + 1, m_lineHeight),
+        Qt::AlignLeft | Qt::AlignVCenter, text);
   }
-  const auto &wayIt = it->second.find(wayIdx);
-  if (wayIt == it->second.end()) {
-    return;
+  if (lastLine + 1 == static_cast<unsigned>(m_cache.getLines())) {
+    painter->setPen(solidPen);
+    painter->drawLine(QLineF(0, bottom, m_cacheWidth, bottom));
   }
-  CacheWay &way = wayIt->second;
-
-  CacheSim::CacheWay simWay = CacheSim::CacheWay();
+}
 
-  if (auto *cacheLine = m_cache.getLine(lineIdx)) {
-    simWay = cacheLine->at(wayIdx);
-  };
+void CacheGraphic::paintLines(QPainter *painter, unsigned firstLine,
+                              unsigned lastLine) {
+  // Tags are displayed at the width of an address, and blocks at the width of
+  // a cache word, which may differ from the register width of the ISA.
+  const unsigned addressBytes = m_cache.getAddressBits() / CHAR_BIT;
+  const unsigned wordBytes = m_cache.getWordBytes();
+  const bool writeBack = m_cache.getWritePolicy() == WritePolicy::WriteBack;
+  const bool replFields = hasReplFields();
+  const QColor textColor = QApplication::palette().text().color();
+  const QColor dirtyColor = cacheDirtyColor();
+  auto &mem = ProcessorHandler::getMemory();
+
+  painter->setFont(m_font);
+  for (unsigned lineIdx = firstLine; lineIdx <= lastLine; ++lineIdx) {
+    const auto *cacheLine = m_cache.getLine(lineIdx);
+    for (int wayIdx = 0; wayIdx < m_cache.getWays(); ++wayIdx) {
+      CacheSim::CacheWay simWay = CacheSim::CacheWay();
+      if (cacheLine != nullptr) {
+        auto it = cacheLine->find(wayIdx);
+        if (it != cacheLine->end())
+          simWay = it->second;
+      }
+      const qreal y = lineIdx * m_lineHeight + wayIdx * m_setHeight;
+      const auto blockRect = [&](unsigned blockIdx) {
+        return QRectF(m_widthBeforeBlocks + blockIdx * m_blockWidth, y,
+                      m_blockWidth, m_setHeight);
+      };
+
+      // Dirty blocks highlighting
+      if (!simWay.dirtyBlocks.empty()) {
+        painter->setPen(Qt::NoPen);
+        painter->setBrush(dirtyColor);
+        painter->setOpacity(0.4);
+        for (const unsigned blockIdx : simWay.dirtyBlocks)
+          painter->drawRect(blockRect(blockIdx));
+        painter->setOpacity(1.0);
+      }
 
-  const unsigned bytes = ProcessorHandler::currentISA()->bytes();
-  // ======================== Update block text fields ======================
-  if (simWay.valid) {
-    for (int i = 0; i < m_cache.getBlocks(); ++i) {
-      QGraphicsSimpleTextItem *blockTextItem = nullptr;
-      if (way.blocks.count(i) == 0) {
-        // Block text item has not yet been created
-        const qreal x =
-            m_widthBeforeBlocks + i * m_blockWidth +
-            (m_blockWidth / 2 - m_fm.horizontalAdvance(addressString()) / 2);
-        const qreal y = lineIdx * m_lineHeight + wayIdx * m_setHeight;
-
-        way.blocks[i] = createGraphicsTextItemSP(x, y);
-        blockTextItem = way.blocks[i].get();
-      } else {
-        blockTextItem = way.blocks.at(i).get();
+      painter->setPen(textColor);
+      painter->drawText(QRectF(0, y, m_bitWidth, m_setHeight), Qt::AlignCenter,
+                        QString::number(simWay.valid));
+      if (writeBack)
+        painter->drawText(
+            QRectF(m_widthBeforeDirty, y, m_bitWidth, m_setHeight),
+            Qt::AlignCenter, QString::number(simWay.dirty));
+      if (replFields) {
+        // If LRU was just initialized, the actual (software) LRU value may be
+        // very large. Mask to the number of actual LRU bits.
+        const unsigned lruVal = std::min(
+            static_cast<unsigned>(m_cache.getWays() - 1), simWay.lru);
+        painter->drawText(QRectF(m_widthBeforeLRU, y, m_lruWidth, m_setHeight),
+                          Qt::AlignCenter, QString::number(lruVal));
       }
 
-      // Update block text
-      const AInt addressForBlock = m_cache.buildAddress(simWay.tag, lineIdx, i);
-      const auto data =
-          ProcessorHandler::getMemory().readMemConst(addressForBlock, bytes);
-      const QString text = encodeRadixValue(
-          data, Radix::Hex, ProcessorHandler::currentISA()->bytes());
-      blockTextItem->setText(text);
-      QString tooltip =
-          "Address: " +
-          encodeRadixValue(addressForBlock, Radix::Hex,
-                           ProcessorHandler::currentISA()->bytes());
-      if (simWay.dirtyBlocks.count(i)) {
-        tooltip += "\n> Dirty";
+      if (!simWay.valid)
+        continue;
+
+      painter->drawText(QRectF(m_widthBeforeTag, y, m_tagWidth, m_setHeight),
+                        Qt::AlignCenter,
+                        encodeRadixValue(simWay.tag, Radix::Hex, addressBytes));
+      for (int i = 0; i < m_cache.getBlocks(); ++i) {
+        const AInt addressForBlock =
+            m_cache.buildAddress(simWay.tag, lineIdx, i);
+        const auto data = mem.readMemConst(addressForBlock, wordBytes);
+        painter->drawText(blockRect(i), Qt::AlignCenter,
+                          encodeRadixValue(data, Radix::Hex, wordBytes));
       }
-      blockTextItem->setToolTip(tooltip);
-      // Store the address within the userrole of the block text. Doing this, we
-      // are able to easily retrieve the address for the block if the block is
-      // clicked.
-      blockTextItem->setData(Qt::UserRole,
-                             QVariant::fromValue(addressForBlock));
     }
-  } else {
-    // The way is invalid so no block text should be present
-    way.blocks.clear();
-  }
-
-  // =========================== Update dirty field =========================
-  if (way.dirty) {
-    way.dirty->setText(QString::number(simWay.dirty));
-  }
-
-  // =========================== Update valid field =========================
-  if (way.valid) {
-    way.valid->setText(QString::number(simWay.valid));
   }
+}
 
-  // ============================ Update tag field ==========================
-  if (simWay.valid) {
-    QGraphicsSimpleTextItem *tagTextItem = way.tag.get();
-    if (tagTextItem == nullptr) {
-      const qreal x =
-          m_widthBeforeTag +
-          (m_tagWidth / 2 - m_fm.horizontalAdvance(addressString()) / 2);
-      const qreal y = lineIdx * m_lineHeight + wayIdx * m_setHeight;
-      way.tag = createGraphicsTextItemSP(x, y);
-      tagTextItem = way.tag.get();
-    }
-    const QString tagText = encodeRadixValue(
-        simWay.tag, Radix::Hex, ProcessorHandler::currentISA()->bytes());
-    tagTextItem->setText(tagText);
-  } else {
-    // The way is invalid so no tag text should be present
-    if (way.tag) {
-      way.tag.reset();
+void CacheGraphic::paintHeatmap(QPainter *painter, unsigned firstLine,
+                                unsigned lastLine, unsigned linesPerRow) {
+  const QColor hitColor = cacheHitColor();
+  const QColor missColor = cacheMissColor();
+  painter->setPen(Qt::NoPen);
+
+  // Rows are aligned to multiples of linesPerRow, such that partial repaints
+  // aggregate the same lines as full repaints.
+  const unsigned nLines = m_cache.getLines();
+  for (unsigned rowStart = (firstLine / linesPerRow) * linesPerRow;
+       rowStart <= lastLine; rowStart += linesPerRow) {
+    const unsigned rowEnd = std::min(rowStart + linesPerRow, nLines);
+    uint64_t hits = 0, misses = 0;
+    for (unsigned lineIdx = rowStart; lineIdx < rowEnd; ++lineIdx) {
+      const auto stats = m_cache.getSetStats(lineIdx);
+      hits += stats.hits;
+      misses += stats.misses;
     }
+    if (hits + misses == 0)
+      continue;
+
+    const qreal missRate = static_cast<qreal>(misses) / (hits + misses);
+    const QColor color = QColor::fromRgbF(
+        hitColor.redF() + (missColor.redF() - hitColor.redF()) * missRate,
+        hitColor.greenF() + (missColor.greenF() - hitColor.greenF()) * missRate,
+        hitColor.blueF() + (missColor.blueF() - hitColor.blueF()) * missRate);
+    painter->setBrush(color);
+    painter->drawRect(QRectF(0, rowStart * m_lineHeight, m_cacheWidth,
+                             (rowEnd - rowStart) * m_lineHeight));
   }
+}
 
-  // ==================== Update dirty blocks highlighting ==================
-  const std::set<unsigned> graphicDirtyBlocks = keys(way.dirtyBlocks);
-  std::set<unsigned> newDirtyBlocks;
-  std::set<unsigned> dirtyBlocksToDelete;
-  std::set_difference(
-      graphicDirtyBlocks.begin(), graphicDirtyBlocks.end(),
-      simWay.dirtyBlocks.begin(), simWay.dirtyBlocks.end(),
-      std::inserter(dirtyBlocksToDelete, dirtyBlocksToDelete.begin()));
-  std::set_difference(simWay.dirtyBlocks.begin(), simWay.dirtyBlocks.end(),
-                      graphicDirtyBlocks.begin(), graphicDirtyBlocks.end(),
-                      std::inserter(newDirtyBlocks, newDirtyBlocks.begin()));
-
-  // Delete blocks which are not in sync with the current dirty status of the
-  // way
-  for (const unsigned &blockToDelete : dirtyBlocksToDelete) {
-    way.dirtyBlocks.erase(blockToDelete);
-  }
-  // Create all required new blocks
-  for (const auto &blockIdx : newDirtyBlocks) {
-    const auto topLeft = QPointF(blockIdx * m_blockWidth + m_widthBeforeBlocks,
-                                 lineIdx * m_lineHeight + wayIdx * m_setHeight);
-    const auto bottomRight =
-        QPointF((blockIdx + 1) * m_blockWidth + m_widthBeforeBlocks,
-                lineIdx * m_lineHeight + (wayIdx + 1) * m_setHeight);
-    way.dirtyBlocks[blockIdx] =
-        std::make_unique<QGraphicsRectItem>(QRectF(topLeft, bottomRight), this);
-
-    const auto &dirtyRectItem = way.dirtyBlocks[blockIdx];
-    dirtyRectItem->setZValue(-1);
-    dirtyRectItem->setOpacity(0.4);
-    dirtyRectItem->setBrush(cacheDirtyColor());
-  }
+std::optional<AInt> CacheGraphic::addressAt(const QPointF &pos) const {
+  if (pos.x() < m_widthBeforeBlocks || pos.x() >= m_cacheWidth ||
+      pos.y() < 0 || pos.y() >= m_cacheHeight)
+    return {};
+
+  const unsigned lineIdx = static_cast<unsigned>(pos.y() / m_lineHeight);
+  const unsigned wayIdx = static_cast<unsigned>(
+      (pos.y() - lineIdx * m_lineHeight) / m_setHeight);
+  const unsigned blockIdx =
+      static_cast<unsigned>((pos.x() - m_widthBeforeBlocks) / m_blockWidth);
+  const auto *cacheLine = m_cache.getLine(lineIdx);
+  if (cacheLine == nullptr)
+    return {};
+  auto it = cacheLine->find(wayIdx);
+  if (it == cacheLine->end() || !it->second.valid)
+    return {};
+  return m_cache.buildAddress(it->second.tag, lineIdx, blockIdx);
 }
 
-QGraphicsSimpleTextItem *
-CacheGraphic::tryCreateGraphicsTextItem(QGraphicsSimpleTextItem **item, qreal x,
-                                        qreal y) {
-  if (*item == nullptr) {
-    *item = new QGraphicsSimpleTextItem(this);
-    (*item)->setFont(m_font);
-    (*item)->setBrush(QApplication::palette().text().color());
-    (*item)->setPos(x, y);
+void CacheGraphic::hoverMoveEvent(QGraphicsSceneHoverEvent *event) {
+  QString tooltip;
+  const QPointF pos = event->pos();
+  if (!ProcessorHandler::isRunning() && pos.y() >= 0 &&
+      pos.y() < m_cacheHeight) {
+    const unsigned lineIdx = static_cast<unsigned>(pos.y() / m_lineHeight);
+    if (pos.x() < 0) {
+      const auto stats = m_cache.getSetStats(lineIdx);
+      tooltip = "Line " + QString::number(lineIdx) +
+                "\nHits: " + QString::number(stats.hits) +
+                "\nMisses: " + QString::number(stats.misses);
+    } else if (auto address = addressAt(pos)) {
+      const unsigned bytes = m_cache.getAddressBits() / CHAR_BIT;
+      const unsigned wayIdx = static_cast<unsigned>(
+          (pos.y() - lineIdx * m_lineHeight) / m_setHeight);
+      const unsigned blockIdx = m_cache.getBlockIdx(*address);
+      tooltip = "Address: " + encodeRadixValue(*address, Radix::Hex, bytes);
+      if (m_cache.getLine(lineIdx)->at(wayIdx).dirtyBlocks.count(blockIdx))
+        tooltip += "\n> Dirty";
+    }
   }
-  return *item;
+  setToolTip(tooltip);
+  QGraphicsObject::hoverMoveEvent(event);
 }
 
-std::unique_ptr<QGraphicsSimpleTextItem>
-CacheGraphic::createGraphicsTextItemSP(qreal x, qreal y) {
-  std::unique_ptr<QGraphicsSimpleTextItem> ptr =
-      std::make_unique<QGraphicsSimpleTextItem>(this);
-  ptr->setFont(m_font);
-  ptr->setBrush(QApplication::palette().text().color());
-  ptr->setPos(x, y);
-  return ptr;
+QString CacheGraphic::addressString() const {
+  return "0x" + QString("0").repeated(m_cache.getAddressBits() / CHAR_BIT * 2);
 }
 
 void CacheGraphic::drawIndexingItems() {
@@ -348,7 +417,7 @@ void CacheGraphic::drawIndexingItems() {
   };
 
   // Draw address box
-  const QString addressText = QString("-").repeated(32);
+  const QString addressText = QString("-").repeated(m_cache.getAddressBits());
   m_addressTextItem = drawText(addressText, 0, 0 - m_setHeight * 3.5);
   auto addressTextRect = m_addressTextItem->boundingRect();
   addressTextRect.moveTo(m_addressTextItem->pos());
@@ -366,7 +435,7 @@ void CacheGraphic::drawIndexingItems() {
   smallerFont.setPointSize(m_font.pointSize() * 0.8);
   drawText(botBits, nextBitsPos.x(), nextBitsPos.y() - m_setHeight,
            &smallerFont);
-  const QString topBits = "31";
+  const QString topBits = QString::number(m_cache.getAddressBits() - 1);
   drawText(topBits,
            m_addressTextItem->pos().x() -
                smallerFontMetric.horizontalAdvance(topBits),
@@ -392,8 +461,7 @@ void CacheGraphic::drawIndexingItems() {
              &smallerFont);
   };
 
-  drawNextBitPos(log2Ceil(
-      ProcessorHandler::currentISA()->bytes())); // Account for word indexing
+  drawNextBitPos(m_cache.getByteOffsetBits()); // Account for word indexing
   if (m_cache.getBlockBits() > 0) {
     m_blockIndexStartPoint = nextBitsPos;
     drawNextBitPos(m_cache.getBlockBits());
@@ -434,8 +502,8 @@ void CacheGraphic::drawIndexingItems() {
 
 void CacheGraphic::cacheInvalidated() {
   // Remove all items
+  prepareGeometryChange();
   m_highlightingItems.clear();
-  m_cacheTextItems.clear();
   m_addressTextItem = nullptr;
   m_blockIndexingLine = nullptr;
   m_lineIndexingLine = nullptr;
@@ -446,17 +514,18 @@ void CacheGraphic::cacheInvalidated() {
   // Determine cell dimensions
   m_setHeight = m_fm.height();
   m_lineHeight = m_setHeight * m_cache.getWays();
-  m_blockWidth = m_fm.horizontalAdvance(" " + addressString() + " ");
+  m_blockWidth = m_fm.horizontalAdvance(
+      " 0x" + QString("0").repeated(m_cache.getWordBytes() * 2) + " ");
   m_bitWidth = m_fm.horizontalAdvance("00");
   m_lruWidth = m_fm.horizontalAdvance(QString::number(m_cache.getWays()) + " ");
   m_cacheHeight = m_lineHeight * m_cache.getLines();
-  m_tagWidth = m_blockWidth;
+  m_tagWidth = m_fm.horizontalAdvance(" " + addressString() + " ");
+  m_indexWidth =
+      m_fm.horizontalAdvance(QString::number(m_cache.getLines() - 1)) * 1.2;
 
-  // Draw cache:
-  new QGraphicsLineItem(0, 0, 0, m_cacheHeight, this);
+  // Draw column headers. The cache lines themselves (grid, control bits, tags
+  // and blocks) are painted in paint().
   qreal width = 0;
-  // Draw valid bit column
-  new QGraphicsLineItem(m_bitWidth, 0, m_bitWidth, m_cacheHeight, this);
   const QString validBitText = "V";
   auto *validItem = drawText(validBitText, 0, -m_fm.height());
   validItem->setToolTip("Valid bit");
@@ -464,10 +533,6 @@ void CacheGraphic::cacheInvalidated() {
 
   if (m_cache.getWritePolicy() == WritePolicy::WriteBack) {
     m_widthBeforeDirty = width;
-
-    // Draw dirty bit column
-    new QGraphicsLineItem(width + m_bitWidth, 0, width + m_bitWidth,
-                          m_cacheHeight, this);
     const QString dirtyBitText = "D";
     auto *dirtyItem =
         drawText(dirtyBitText, m_widthBeforeDirty, -m_fm.height());
@@ -477,11 +542,7 @@ void CacheGraphic::cacheInvalidated() {
 
   m_widthBeforeLRU = width;
 
-  if (m_cache.getReplacementPolicy() == ReplPolicy::LRU &&
-      m_cache.getWays() > 1) {
-    // Draw LRU bit column
-    new QGraphicsLineItem(width + m_lruWidth, 0, width + m_lruWidth,
-                          m_cacheHeight, this);
+  if (hasReplFields()) {
     const QString LRUBitText = "LRU";
     auto *textItem = drawText(LRUBitText,
                               width + m_lruWidth / 2 -
@@ -493,9 +554,6 @@ void CacheGraphic::cacheInvalidated() {
 
   m_widthBeforeTag = width;
 
-  // Draw tag column
-  new QGraphicsLineItem(m_tagWidth + width, 0, m_tagWidth + width,
-                        m_cacheHeight, this);
   const QString tagText = "Tag";
   drawText(tagText,
            width + m_tagWidth / 2 - m_fm.horizontalAdvance(tagText) / 2,
@@ -504,46 +562,16 @@ void CacheGraphic::cacheInvalidated() {
   width += m_tagWidth;
   m_widthBeforeBlocks = width;
 
-  // Draw horizontal lines between cache blocks
   for (int i = 0; i < m_cache.getBlocks(); ++i) {
     const QString blockText = "Word " + QString::number(i);
     drawText(blockText,
              width + m_tagWidth / 2 - m_fm.horizontalAdvance(blockText) / 2,
              -m_fm.height());
     width += m_blockWidth;
-    new QGraphicsLineItem(width, 0, width, m_cacheHeight, this);
   }
 
   m_cacheWidth = width;
 
-  // Draw cache line rows
-  for (int i = 0; i <= m_cache.getLines(); ++i) {
-    qreal verticalAdvance = i * m_lineHeight;
-    new QGraphicsLineItem(0, verticalAdvance, m_cacheWidth, verticalAdvance,
-                          this);
-
-    if (i < m_cache.getLines()) {
-      // Draw cache set rows
-      for (int j = 1; j < m_cache.getWays(); j++) {
-        verticalAdvance += m_setHeight;
-        auto *setLine = new QGraphicsLineItem(0, verticalAdvance, m_cacheWidth,
-                                              verticalAdvance, this);
-        auto pen = setLine->pen();
-        pen.setStyle(Qt::DashLine);
-        setLine->setPen(pen);
-      }
-    }
-  }
-
-  // Draw line index numbers
-  for (int i = 0; i < m_cache.getLines(); ++i) {
-    const QString text = QString::number(i);
-
-    const qreal y = i * m_lineHeight + m_lineHeight / 2 - m_setHeight / 2;
-    const qreal x = -m_fm.horizontalAdvance(text) * 1.2;
-    drawText(text, x, y);
-  }
-
   // Draw index column text
   const QString indexText = "Index";
   const qreal x = -m_fm.horizontalAdvance(indexText) * 1.2;
@@ -555,20 +583,8 @@ void CacheGraphic::cacheInvalidated() {
     drawIndexingItems();
   }
 
-  initializeControlBits();
-
-  // Update all entries in the cache
-  for (int lineIdx = 0; lineIdx < m_cache.getLines(); lineIdx++) {
-    if (const auto *line = m_cache.getLine(lineIdx)) {
-      for (const auto &way : *line) {
-        updateWay(lineIdx, way.first);
-      }
-      updateLineReplFields(lineIdx);
-    }
-  }
-
-  // Recolor all grid lines (created with the default black pen) to the theme's
-  // text color, so the cache diagram follows light/dark mode.
+  // Recolor all lines (created with the default black pen) to the theme's text
+  // color, so the cache diagram follows light/dark mode.
   const QColor gridColor = QApplication::palette().text().color();
   for (auto *item : childItems()) {
     if (auto *lineItem = qgraphicsitem_cast<QGraphicsLineItem *>(item)) {
@@ -583,26 +599,27 @@ void CacheGraphic::cacheInvalidated() {
     // CacheGraphic
     _scene->setSceneRect({});
   }
+  update();
 }
 
 void CacheGraphic::updateAddressing(
     bool valid, const CacheSim::CacheTransaction &transaction) {
   if (m_indexingVisible) {
     if (valid) {
-      const auto &it = m_cacheTextItems.find(transaction.index.line);
-      if (it == m_cacheTextItems.end()) {
+      const auto *cacheLine = m_cache.getLine(transaction.index.line);
+      if (cacheLine == nullptr) {
         return;
       }
-      const auto &wayIt = it->second.find(transaction.index.way);
-      if (wayIt == it->second.end()) {
+      const auto &wayIt = cacheLine->find(transaction.index.way);
+      if (wayIt == cacheLine->end()) {
         return;
       }
 
-      const CacheWay &way = wayIt->second;
       m_addressTextItem->setText(
-          QString::number(transaction.address, 2).rightJustified(32, '0'));
+          QString::number(transaction.address, 2)
+              .rightJustified(m_cache.getAddressBits(), '0'));
 
-      if (way.tag) {
+      if (wayIt->second.valid) {
         QPolygonF lineIndexingPoly;
         m_lineIndexingLine->setVisible(true);
         lineIndexingPoly << m_lineIndexStartPoint;
@@ -636,14 +653,15 @@ void CacheGraphic::updateAddressing(
       }
 
     } else {
-      m_addressTextItem->setText(QString("-").repeated(32));
+      m_addressTextItem->setText(
+          QString("-").repeated(m_cache.getAddressBits()));
     }
   }
 }
 
-void CacheGraphic::wayInvalidated(unsigned lineIdx, unsigned wayIdx) {
-  updateWay(lineIdx, wayIdx);
-  updateLineReplFields(lineIdx);
+void CacheGraphic::wayInvalidated(unsigned lineIdx, unsigned) {
+  // Replacement fields of all ways in the line may have changed.
+  update(lineRect(lineIdx));
 }
 
 void CacheGraphic::dataChanged(CacheSim::CacheTransaction transaction) {
@@ -732,34 +750,4 @@ void CacheGraphic::updateHighlighting(
   }
 }
 
-void CacheGraphic::initializeControlBits() {
-  for (int lineIdx = 0; lineIdx < m_cache.getLines(); lineIdx++) {
-    auto &line = m_cacheTextItems[lineIdx];
-    for (int setIdx = 0; setIdx < m_cache.getWays(); setIdx++) {
-      const qreal y = lineIdx * m_lineHeight + setIdx * m_setHeight;
-      qreal x;
-
-      // Create valid field
-      x = m_bitWidth / 2 - m_fm.horizontalAdvance("0") / 2;
-      line[setIdx].valid = drawText("0", x, y);
-
-      if (m_cache.getWritePolicy() == WritePolicy::WriteBack) {
-        // Create dirty bit field
-        x = m_widthBeforeDirty + m_bitWidth / 2 -
-            m_fm.horizontalAdvance("0") / 2;
-        line[setIdx].dirty = drawText("0", x, y);
-      }
-
-      if (m_cache.getReplacementPolicy() == ReplPolicy::LRU &&
-          m_cache.getWays() > 1) {
-        // Create LRU field
-        const QString lruText = QString::number(m_cache.getWays() - 1);
-        x = m_widthBeforeLRU + m_lruWidth / 2 -
-            m_fm.horizontalAdvance(lruText) / 2;
-        line[setIdx].lru = drawText(lruText, x, y);
-      }
-    }
-  }
-}
-
 } // namespace Ripes
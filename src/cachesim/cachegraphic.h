@@ -7,20 +7,41 @@
 #include <QGraphicsItem>
 #include <QObject>
 #include <memory>
+#include <optional>
 
 namespace Ripes {
 class FancyPolyLine;
 
+/**
+ * @brief The CacheGraphic class
+ * Graphical view of the state of a cache simulator. The contents of the cache
+ * (control bits, tags and data blocks) are not modelled as graphics items;
+ * they are painted directly from the cache simulator state, and only for the
+ * cache lines which intersect the exposed area of the view. This keeps the
+ * cost of updating and drawing the view independent of the cache geometry.
+ * When zoomed out such that the contents of the cache would be unreadable, a
+ * heatmap of the per-line miss rate is painted instead.
+ */
 class CacheGraphic : public QGraphicsObject {
 public:
   CacheGraphic(CacheSim &cache);
 
-  QRectF boundingRect() const override { return childrenBoundingRect(); };
+  QRectF boundingRect() const override;
 
-  void paint(QPainter *, const QStyleOptionGraphicsItem *,
-             QWidget * = nullptr) override {}
+  void paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
+             QWidget * = nullptr) override;
   bool indexingVisible() const { return m_indexingVisible; }
 
+  /**
+   * @brief addressAt
+   * Returns the address of the valid cache block located at @p pos (in item
+   * coordinates), if any.
+   */
+  std::optional<AInt> addressAt(const QPointF &pos) const;
+
+protected:
+  void hoverMoveEvent(QGraphicsSceneHoverEvent *event) override;
+
 public slots:
   /**
    * @brief dataChanged
@@ -55,39 +76,29 @@ public slots:
   void setIndexingVisible(bool visible);
 
 private:
-  // Data structure modelling the cache; keeping graphics text items for each
-  // entry All text items which are not always present are stored as
-  // unqiue_ptr's to facilitate easy deletion when undoing changes to the cache
-  struct CacheWay {
-    std::map<unsigned, std::unique_ptr<QGraphicsSimpleTextItem>> blocks;
-    std::unique_ptr<QGraphicsSimpleTextItem> tag = nullptr;
-    QGraphicsSimpleTextItem *lru = nullptr;
-    QGraphicsSimpleTextItem *valid = nullptr;
-    QGraphicsSimpleTextItem *dirty = nullptr;
-    std::map<unsigned, std::unique_ptr<QGraphicsRectItem>> dirtyBlocks;
-  };
-
-  using CacheLine = std::map<unsigned, CacheWay>;
+  // Minimum on-screen height (in pixels) of a cache way for the contents of
+  // the cache to be painted. Below this, the heatmap is painted.
+  static constexpr qreal c_minDetailedSetHeight = 6;
 
   /**
-   * @brief initializeControlBits
-   * Constructs all of the "Valid" and "LRU" text items within the cache
+   * @brief lineRect
+   * Returns the area (in item coordinates) covered by cache line @p lineIdx,
+   * including its index number.
    */
-  void initializeControlBits();
+  QRectF lineRect(unsigned lineIdx) const;
+  bool hasReplFields() const;
+  void paintGrid(QPainter *painter, unsigned firstLine, unsigned lastLine);
+  void paintLines(QPainter *painter, unsigned firstLine, unsigned lastLine);
+  void paintHeatmap(QPainter *painter, unsigned firstLine, unsigned lastLine,
+                    unsigned linesPerRow);
   void updateHighlighting(bool active,
                           const CacheSim::CacheTransaction &transaction);
   QGraphicsSimpleTextItem *drawText(const QString &text, const QPointF &pos,
                                     const QFont *otherFont = nullptr);
   QGraphicsSimpleTextItem *drawText(const QString &text, qreal x, qreal y,
                                     const QFont *otherFont = nullptr);
-  QGraphicsSimpleTextItem *
-  tryCreateGraphicsTextItem(QGraphicsSimpleTextItem **item, qreal x, qreal y);
-  std::unique_ptr<QGraphicsSimpleTextItem> createGraphicsTextItemSP(qreal x,
-                                                                    qreal y);
 
   // Graphical update functions
-  void updateLineReplFields(unsigned lineIdx);
-  void updateWay(unsigned lineIdx, unsigned wayIdx);
   void updateAddressing(bool valid,
                         const CacheSim::CacheTransaction &transaction);
   void drawIndexingItems();
@@ -115,22 +126,11 @@ private:
   qreal m_widthBeforeLRU = 0;
   qreal m_widthBeforeDirty = 0;
   qreal m_lruWidth = 0;
+  qreal m_indexWidth = 0;
 
   static constexpr qreal z_grid = 0;
   static constexpr qreal z_wires = -1;
 
-  /**
-   * @brief m_cacheTextItems
-   * All text items in the cache are managed in @var m_cacheTextItems.
-   * This object models the hierarchy of the cache, and stores all currently
-   * initialized text items for the cache. The object is indexed similarly to
-   * how the cache simulator is indexed. As such, a cache transaction is used to
-   * traverse the object.
-   * All items are lazily initialized in calls to dataChanged(). This prevents
-   * initializing a ton of items if a user has created a very large cache.
-   */
-  std::map<unsigned, CacheLine> m_cacheTextItems;
-
   // Addressing related items which are moved around when addressing changes
   QGraphicsSimpleTextItem *m_addressTextItem = nullptr;
   FancyPolyLine *m_lineIndexingLine = nullptr;
@@ -0,0 +1,100 @@
+#include "cachemissclassifier.h"
+
+#include <algorithm>
+
+namespace Ripes {
+
+void CacheMissClassifier::reset(size_t capacity) {
+  m_capacity = capacity;
+  m_lru.clear();
+  m_lruIndex.clear();
+  m_touched.clear();
+  m_undoStack.clear();
+}
+
+CacheMissType CacheMissClassifier::access(AInt block, bool hit,
+                                          bool allocate) {
+  UndoRecord record;
+  record.block = block;
+  record.firstTouch = m_touched.insert(block).second;
+
+  auto it = m_lruIndex.find(block);
+  const bool shadowHit = it != m_lruIndex.end();
+  if (shadowHit) {
+    // Move to the front of the LRU order.
+    auto next = std::next(it->second);
+    if (next != m_lru.end())
+      record.successor = *next;
+    m_lru.splice(m_lru.begin(), m_lru, it->second);
+  } else if (allocate && m_capacity > 0) {
+    m_lru.push_front(block);
+    m_lruIndex[block] = m_lru.begin();
+    record.inserted = true;
+    if (m_lru.size() > m_capacity) {
+      record.evicted = m_lru.back();
+      m_lruIndex.erase(m_lru.back());
+      m_lru.pop_back();
+    }
+  } else {
+    record.noop = true;
+  }
+
+  m_undoStack.push_back(record);
+  if (m_undoStack.size() > m_undoDepth)
+    m_undoStack.pop_front();
+
+  if (hit)
+    return CacheMissType::None;
+  if (record.firstTouch)
+    return CacheMissType::Compulsory;
+  return shadowHit ? CacheMissType::Conflict : CacheMissType::Capacity;
+}
+
+void CacheMissClassifier::undo() {
+  if (m_undoStack.empty())
+    return;
+  const UndoRecord record = m_undoStack.back();
+  m_undoStack.pop_back();
+
+  if (record.firstTouch)
+    m_touched.erase(record.block);
+  if (record.noop)
+    return;
+
+  if (record.inserted) {
+    m_lruIndex.erase(record.block);
+    m_lru.pop_front();
+    if (record.evicted) {
+      m_lru.push_back(*record.evicted);
+      m_lruIndex[*record.evicted] = std::prev(m_lru.end());
+    }
+  } else {
+    // Move the block back to its previous position in the LRU order.
+    auto pos =
+        record.successor ? m_lruIndex.at(*record.successor) : m_lru.end();
+    m_lru.splice(pos, m_lru, m_lruIndex.at(record.block));
+  }
+}
+
+void MissCounter::remove(AInt key) {
+  auto it = m_counts.find(key);
+  if (it == m_counts.end())
+    return;
+  if (--it->second == 0)
+    m_counts.erase(it);
+}
+
+std::vector<std::pair<AInt, unsigned>> MissCounter::top(unsigned n) const {
+  std::vector<std::pair<AInt, unsigned>> entries(m_counts.begin(),
+                                                 m_counts.end());
+  const auto cmp = [](const auto &a, const auto &b) {
+    return a.second != b.second ? a.second > b.second : a.first < b.first;
+  };
+  const size_t count = std::min<size_t>(n, entries.size());
+  std::partial_sort(entries.begin(), entries.begin() + count, entries.end(),
+                    cmp);
+  entries.resize(count);
+  return entries;
+}
+
+} // namespace Ripes
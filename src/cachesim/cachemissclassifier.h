@@ -0,0 +1,92 @@
+#pragma once
+
+#include <deque>
+#include <list>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "isa/isa_types.h"
+
+namespace Ripes {
+
+/// Classification of a cache access following the "3C" model of cache misses.
+enum class CacheMissType { None, Compulsory, Capacity, Conflict };
+
+/**
+ * @brief The CacheMissClassifier class
+ * Classifies cache misses as compulsory, capacity or conflict misses. A miss
+ * is compulsory if the block was never accessed before. Otherwise, a shadow
+ * fully associative LRU cache with the same capacity as the simulated cache
+ * determines the type of the miss: if the block is present in the shadow
+ * cache, the miss would not have occurred without the set mapping of the
+ * simulated cache, and is thus a conflict miss. Otherwise, it is a capacity
+ * miss.
+ *
+ * All operations execute in constant (amortized) time. Accesses may be undone
+ * in reverse order, up to the configured undo depth.
+ */
+class CacheMissClassifier {
+public:
+  /// Resets the classifier for a cache holding @p capacity blocks.
+  void reset(size_t capacity);
+
+  /// Sets the maximum number of accesses which can be undone.
+  void setUndoDepth(size_t depth) { m_undoDepth = depth; }
+
+  /**
+   * @brief access
+   * Records an access to @p block (a block-granular address) in the shadow
+   * cache, and classifies the access. @p hit denotes whether the access hit in
+   * the simulated cache. If @p allocate is false, a missing block is not
+   * brought into the shadow cache (no-write-allocate write misses).
+   */
+  CacheMissType access(AInt block, bool hit, bool allocate);
+
+  /// Reverts the most recent access.
+  void undo();
+
+private:
+  struct UndoRecord {
+    AInt block;
+    bool firstTouch = false;
+    bool inserted = false;
+    // Block following the accessed block in the LRU order, before it was
+    // moved to the front.
+    std::optional<AInt> successor;
+    std::optional<AInt> evicted;
+    bool noop = false;
+  };
+
+  size_t m_capacity = 0;
+  size_t m_undoDepth = 0;
+
+  // Shadow fully associative cache, in MRU to LRU order.
+  std::list<AInt> m_lru;
+  std::unordered_map<AInt, std::list<AInt>::iterator> m_lruIndex;
+  // All blocks accessed since the last reset.
+  std::unordered_set<AInt> m_touched;
+  std::deque<UndoRecord> m_undoStack;
+};
+
+/**
+ * @brief The MissCounter class
+ * Counts cache misses per key (program counter or address), for reporting the
+ * keys causing the most misses.
+ */
+class MissCounter {
+public:
+  void add(AInt key) { ++m_counts[key]; }
+  void remove(AInt key);
+  void clear() { m_counts.clear(); }
+
+  /// Returns the (at most) @p n keys with the most misses, in descending order
+  /// of misses.
+  std::vector<std::pair<AInt, unsigned>> top(unsigned n) const;
+
+private:
+  std::unordered_map<AInt, unsigned> m_counts;
+};
+
+} // namespace Ripes
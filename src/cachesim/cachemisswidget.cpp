@@ -0,0 +1,107 @@
+#include "cachemisswidget.h"
+
+#include <QGroupBox>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QTableWidget>
+
+#include "processorhandler.h"
+#include "radix.h"
+
+namespace Ripes {
+
+CacheMissWidget::CacheMissWidget(QWidget *parent) : QWidget(parent) {
+  auto *groupBox = new QGroupBox("Miss analysis:", this);
+  auto *groupLayout = new QHBoxLayout(groupBox);
+
+  m_missTypes = new QLabel(groupBox);
+  m_missTypes->setToolTip(
+      "Compulsory: first access to a block\n"
+      "Capacity: the block would also miss in a fully associative cache of the "
+      "same size\n"
+      "Conflict: the block was evicted due to the set mapping of the cache");
+  m_topPCs = createTopTable("PC");
+  m_topAddresses = createTopTable("Address");
+
+  groupLayout->addWidget(m_missTypes);
+  groupLayout->addWidget(m_topPCs);
+  groupLayout->addWidget(m_topAddresses);
+
+  auto *layout = new QHBoxLayout(this);
+  layout->setContentsMargins(0, 0, 0, 0);
+  layout->addWidget(groupBox);
+}
+
+QTableWidget *CacheMissWidget::createTopTable(const QString &keyHeader) {
+  auto *table = new QTableWidget(s_topEntries, 2, this);
+  table->setHorizontalHeaderLabels({keyHeader, "Misses"});
+  table->verticalHeader()->hide();
+  table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+  table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+  table->setSelectionMode(QAbstractItemView::NoSelection);
+  table->setToolTip(keyHeader + "s causing the most cache misses");
+  table->setMaximumHeight(table->horizontalHeader()->sizeHint().height() +
+                          s_topEntries *
+                              table->verticalHeader()->defaultSectionSize() +
+                          2 * table->frameWidth());
+  return table;
+}
+
+void CacheMissWidget::setCache(const std::shared_ptr<CacheSim> &cache) {
+  m_cache = cache;
+  connect(m_cache.get(), &CacheSim::hitrateChanged, this,
+          &CacheMissWidget::updateMissAnalysis);
+  connect(m_cache.get(), &CacheSim::configurationChanged, this,
+          &CacheMissWidget::updateMissAnalysis);
+  updateMissAnalysis();
+}
+
+void CacheMissWidget::updateTopTable(
+    QTableWidget *table,
+    const std::vector<std::pair<AInt, unsigned>> &entries) {
+  const unsigned bytes = ProcessorHandler::currentISA()->bytes();
+  for (unsigned row = 0; row < s_topEntries; ++row) {
+    QString key, misses;
+    if (row < entries.size()) {
+      key = encodeRadixValue(entries.at(row).first, Radix::Hex, bytes);
+      misses = QString::number(entries.at(row).second);
+    }
+    table->setItem(row, 0, new QTableWidgetItem(key));
+    table->setItem(row, 1, new QTableWidgetItem(misses));
+  }
+}
+
+void CacheMissWidget::updateMissAnalysis() {
+  if (!m_cache)
+    return;
+
+  const auto stats = m_cache->getTotalStats();
+  const auto line = [&stats](const QString &name, unsigned count) {
+    const double pct =
+        stats.misses == 0 ? 0.0 : 100.0 * count / stats.misses;
+    return name + ": " + QString::number(count) + " (" +
+           QString::number(pct, 'f', 1) + "%)";
+  };
+  QString text = "Misses: " + QString::number(stats.misses) + "\n" +
+                 line("Compulsory", stats.compulsory) + "\n" +
+                 line("Capacity", stats.capacity) + "\n" +
+                 line("Conflict", stats.conflict);
+  if (m_cache->getPrefetchPolicy() != PrefetchPolicy::NoPrefetch) {
+    const auto pf = m_cache->getPrefetchStats();
+    const double accuracy =
+        pf.issued == 0 ? 0.0 : 100.0 * pf.useful / pf.issued;
+    text += "\nPrefetches: " + QString::number(pf.issued) + " (" +
+            QString::number(accuracy, 'f', 1) + "% useful)";
+  }
+  if (m_cache->getTiming() != CacheTiming()) {
+    text += "\nEst. stall cycles: " +
+            QString::number(m_cache->getStallCycles());
+  }
+  m_missTypes->setText(text);
+
+  updateTopTable(m_topPCs, m_cache->getTopMissPCs(s_topEntries));
+  updateTopTable(m_topAddresses, m_cache->getTopMissAddresses(s_topEntries));
+}
+
+} // namespace Ripes
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <QWidget>
+
+#include "cachesim.h"
+
+QT_FORWARD_DECLARE_CLASS(QLabel)
+QT_FORWARD_DECLARE_CLASS(QTableWidget)
+
+namespace Ripes {
+
+/**
+ * @brief The CacheMissWidget class
+ * Displays the miss analysis of a cache: the breakdown of misses into
+ * compulsory, capacity and conflict misses, as well as the program counters
+ * and addresses causing the most misses.
+ */
+class CacheMissWidget : public QWidget {
+  Q_OBJECT
+
+public:
+  CacheMissWidget(QWidget *parent);
+
+  void setCache(const std::shared_ptr<CacheSim> &cache);
+
+private:
+  void updateMissAnalysis();
+  QTableWidget *createTopTable(const QString &keyHeader);
+  void updateTopTable(QTableWidget *table,
+                      const std::vector<std::pair<AInt, unsigned>> &entries);
+
+  static constexpr unsigned s_topEntries = 5;
+
+  std::shared_ptr<CacheSim> m_cache;
+  QLabel *m_missTypes = nullptr;
+  QTableWidget *m_topPCs = nullptr;
+  QTableWidget *m_topAddresses = nullptr;
+};
+
+} // namespace Ripes
@@ -6,11 +6,19 @@
 
 #include <QApplication>
 #include <QThread>
+#include <climits>
+#include <limits>
 #include <random>
 #include <utility>
 
 namespace Ripes {
 
+/// Returns a mask of the @p n least significant bits of an address.
+static AInt lowBitMask(unsigned n) {
+  return n >= std::numeric_limits<AInt>::digits ? ~AInt(0)
+                                                 : (AInt(1) << n) - 1;
+}
+
 void CacheInterface::reset() {
   if (m_nextLevelCache) {
     static_cast<CacheInterface *>(m_nextLevelCache.get())->reset();
@@ -24,8 +32,7 @@ void CacheInterface::reverse() {
 }
 
 CacheSim::CacheSim(QObject *parent) : CacheInterface(parent) {
-  m_byteOffset = log2Ceil(ProcessorHandler::currentISA()->bytes());
-  m_wordBits = ProcessorHandler::currentISA()->bits();
+  updateWordSize();
 
   // Cache the max-traces setting and keep it up to date via its observer,
   // rather than reading the QSettings-backed value on every cache access.
@@ -49,10 +56,14 @@ CacheSim::CacheSim(QObject *parent) : CacheInterface(parent) {
   updateConfiguration();
 }
 
-void CacheSim::updateCacheLineReplFields(CacheLine &line, unsigned wayIdx) {
-  if (getReplacementPolicy() == ReplPolicy::LRU) {
+void CacheSim::updateCacheLineReplFields(
+    CacheLine &line, const CacheTransaction &transaction) {
+  const unsigned wayIdx = transaction.index.way;
+  auto &way = line[wayIdx];
+  switch (getReplacementPolicy()) {
+  case ReplPolicy::LRU: {
     // Find previous LRU value for the updated index
-    const unsigned preLRU = line[wayIdx].lru;
+    const unsigned preLRU = way.lru;
 
     // All indicies which are currently more recent than preLRU shall be
     // incremented
@@ -63,7 +74,101 @@ void CacheSim::updateCacheLineReplFields(CacheLine &line, unsigned wayIdx) {
     }
 
     // Upgrade @p lruIdx to the most recently used
-    line[wayIdx].lru = 0;
+    way.lru = 0;
+    break;
+  }
+  case ReplPolicy::FIFO: {
+    // Only insertions affect the FIFO order.
+    if (transaction.isHit)
+      break;
+    uint64_t newest = 0;
+    for (const auto &set : line)
+      if (set.first != wayIdx && set.second.valid)
+        newest = std::max(newest, set.second.replState);
+    way.replState = newest + 1;
+    break;
+  }
+  case ReplPolicy::PLRU:
+    plruTouch(transaction.index.line, wayIdx);
+    break;
+  case ReplPolicy::SRRIP:
+    way.replState = transaction.isHit ? 0 : c_rrpvMax - 1;
+    break;
+  case ReplPolicy::BRRIP:
+    if (transaction.isHit)
+      way.replState = 0;
+    else
+      way.replState = m_brripInsertions++ % c_brripLongInterval == 0
+                          ? c_rrpvMax - 1
+                          : c_rrpvMax;
+    break;
+  case ReplPolicy::LFU:
+    way.replState =
+        transaction.isHit ? std::min(way.replState + 1, c_lfuMax) : 1;
+    break;
+  case ReplPolicy::Random:
+    break;
+  }
+}
+
+CacheSim::ReplSnapshot CacheSim::snapshotReplFields(unsigned lineIdx) const {
+  ReplSnapshot snapshot;
+  if (m_replPolicy == ReplPolicy::Random || m_replPolicy == ReplPolicy::LRU)
+    return snapshot;
+
+  snapshot.valid = true;
+  if (const auto *line = getLine(lineIdx))
+    for (const auto &way : *line)
+      snapshot.ways.push_back({way.first, way.second.replState});
+  if (lineIdx < m_plruTrees.size())
+    snapshot.plruTree = m_plruTrees[lineIdx];
+  snapshot.brripInsertions = m_brripInsertions;
+  return snapshot;
+}
+
+void CacheSim::restoreReplFields(unsigned lineIdx,
+                                 const ReplSnapshot &snapshot) {
+  if (!snapshot.valid)
+    return;
+  auto &line = m_cacheLines[lineIdx];
+  for (const auto &[wayIdx, replState] : snapshot.ways)
+    line[wayIdx].replState = replState;
+  if (lineIdx < m_plruTrees.size())
+    m_plruTrees[lineIdx] = snapshot.plruTree;
+  m_brripInsertions = snapshot.brripInsertions;
+}
+
+// Returns the index of the leftmost leaf (way) of the subtree rooted at @p
+// node, in a tree with @p leaves leaves.
+static unsigned plruFirstLeaf(unsigned node, unsigned leaves) {
+  while (node < leaves)
+    node *= 2;
+  return node - leaves;
+}
+
+unsigned CacheSim::plruVictim(unsigned lineIdx) const {
+  const uint64_t tree = m_plruTrees.at(lineIdx);
+  const unsigned leaves = 1u << vsrtl::ceillog2(getWays());
+  unsigned node = 1;
+  while (node < leaves) {
+    unsigned child = 2 * node + ((tree >> node) & 1);
+    // For way counts which are not a power of two, subtrees without any
+    // existing ways are never selected.
+    if (plruFirstLeaf(child, leaves) >= static_cast<unsigned>(getWays()))
+      child ^= 1;
+    node = child;
+  }
+  return node - leaves;
+}
+
+void CacheSim::plruTouch(unsigned lineIdx, unsigned wayIdx) {
+  uint64_t &tree = m_plruTrees.at(lineIdx);
+  const unsigned leaves = 1u << vsrtl::ceillog2(getWays());
+  // Point all nodes on the path to the accessed way away from it.
+  for (unsigned node = wayIdx + leaves; node > 1; node /= 2) {
+    const unsigned parent = node / 2;
+    const uint64_t awayBit = (node & 1) ? 0 : 1;
+    tree = (tree & ~(uint64_t(1) << parent)) | (awayBit << parent);
   }
 }
 
@@ -101,11 +206,41 @@ CacheSim::CacheSize CacheSim::getCacheSize() const {
     size.bits += componentBits;
   }
 
-  if (m_replPolicy == ReplPolicy::LRU) {
-    // LRU bits
-    componentBits = vsrtl::ceillog2(getWays()) * entries;
-    size.components.push_back("LRU bits: " + QString::number(componentBits));
-    size.bits += componentBits;
+  if (getWays() > 1) {
+    // Replacement policy bits
+    QString replName;
+    componentBits = 0;
+    switch (m_replPolicy) {
+    case ReplPolicy::LRU:
+      replName = "LRU";
+      componentBits = vsrtl::ceillog2(getWays()) * entries;
+      break;
+    case ReplPolicy::FIFO:
+      // A round-robin pointer per line
+      replName = "FIFO";
+      componentBits = vsrtl::ceillog2(getWays()) * getLines();
+      break;
+    case ReplPolicy::PLRU:
+      replName = "PLRU";
+      componentBits = (getWays() - 1) * getLines();
+      break;
+    case ReplPolicy::SRRIP:
+    case ReplPolicy::BRRIP:
+      replName = "RRPV";
+      componentBits = vsrtl::ceillog2(c_rrpvMax + 1) * entries;
+      break;
+    case ReplPolicy::LFU:
+      replName = "LFU";
+      componentBits = c_lfuCounterBits * entries;
+      break;
+    case ReplPolicy::Random:
+      break;
+    }
+    if (componentBits > 0) {
+      size.components.push_back(replName +
+                                " bits: " + QString::number(componentBits));
+      size.bits += componentBits;
+    }
   }
 
   // Tag bits
@@ -129,8 +264,11 @@ CacheSim::locateEvictionWay(const CacheTransaction &transaction) {
   ew.first = s_invalidIndex;
   ew.second = nullptr;
 
-  // Locate a new way based on replacement policy.
-  if (m_replPolicy == ReplPolicy::Random) {
+  if (getWays() == 1) {
+    // Nothing to do if we only have 1 way.
+    ew.first = 0;
+    ew.second = &cacheLine[ew.first];
+  } else {
     // Lazily initialize all ways in the cacheline before starting to iterate.
     for (int i = 0; i < getWays(); ++i)
       cacheLine[i];
@@ -142,40 +280,10 @@ CacheSim::locateEvictionWay(const CacheTransaction &transaction) {
     if (it != cacheLine.end()) {
       ew.first = it->first;
       ew.second = &it->second;
-    }
-    if (ew.second == nullptr) {
-      // Else, Select a Random way.
-      ew.first = std::rand() % getWays();
-      ew.second = &cacheLine[ew.first];
-    }
-  } else if (m_replPolicy == ReplPolicy::LRU) {
-    if (getWays() == 1) {
-      // Nothing to do if we are in LRU and only have 1 set.
-      ew.first = 0;
-      ew.second = &cacheLine[ew.first];
     } else {
-      // Lazily initialize all ways in the cacheline before starting to iterate.
-      for (int i = 0; i < getWays(); ++i)
-        cacheLine[i];
-
-      // If there is an invalid cache line, select that.
-      auto it =
-          std::find_if(cacheLine.begin(), cacheLine.end(),
-                       [this](const auto &way) { return !way.second.valid; });
-      if (it != cacheLine.end()) {
-        ew.first = it->first;
-        ew.second = &it->second;
-      }
-      if (ew.second == nullptr) {
-        // Else, Find LRU way.
-        for (auto &way : cacheLine) {
-          if (static_cast<long>(way.second.lru) == getWays() - 1) {
-            ew.first = way.first;
-            ew.second = &way.second;
-            break;
-          }
-        }
-      }
+      // Else, locate a way based on the replacement policy.
+      ew.first = selectVictim(transaction.index.line, cacheLine);
+      ew.second = &cacheLine[ew.first];
     }
   }
 
@@ -184,6 +292,42 @@ CacheSim::locateEvictionWay(const CacheTransaction &transaction) {
   return ew;
 }
 
+unsigned CacheSim::selectVictim(unsigned lineIdx, CacheLine &line) {
+  switch (m_replPolicy) {
+  case ReplPolicy::Random:
+    return std::rand() % getWays();
+  case ReplPolicy::LRU:
+    for (const auto &way : line)
+      if (static_cast<long>(way.second.lru) == getWays() - 1)
+        return way.first;
+    break;
+  case ReplPolicy::FIFO:
+  case ReplPolicy::LFU: {
+    // Oldest insertion, respectively least frequently used way.
+    auto it = std::min_element(line.begin(), line.end(),
+                               [](const auto &a, const auto &b) {
+                                 return a.second.replState <
+                                        b.second.replState;
+                               });
+    return it->first;
+  }
+  case ReplPolicy::PLRU:
+    return plruVictim(lineIdx);
+  case ReplPolicy::SRRIP:
+  case ReplPolicy::BRRIP:
+    // Select the first way predicted to be re-referenced in the distant
+    // future, aging all ways until one is found.
+    while (true) {
+      for (const auto &way : line)
+        if (way.second.replState >= c_rrpvMax)
+          return way.first;
+      for (auto &way : line)
+        way.second.replState++;
+    }
+  }
+  return s_invalidIndex;
+}
+
 CacheSim::CacheWay CacheSim::evictAndUpdate(CacheTransaction &transaction) {
   const auto [wayIdx, wayPtr] = locateEvictionWay(transaction);
 
@@ -242,6 +386,17 @@ unsigned CacheSim::getWritebacks() const {
   }
 }
 
+uint64_t CacheSim::getStallCycles() const {
+  const uint64_t hits = getHits();
+  const uint64_t misses = getMisses();
+  // The first cycle of each access is covered by the memory stage of the
+  // processor models.
+  const uint64_t accessStall =
+      m_timing.hitLatency > 0 ? m_timing.hitLatency - 1 : 0;
+  return (hits + misses) * accessStall + misses * m_timing.missLatency +
+         static_cast<uint64_t>(getWritebacks()) * m_timing.writebackLatency;
+}
+
 double CacheSim::getHitRate() const {
   if (m_accessTrace.size() == 0) {
     return 0;
@@ -307,15 +462,17 @@ void CacheSim::popAccessTrace() {
   emit hitrateChanged();
 }
 
-void CacheSim::access(AInt address, MemoryAccess::Type type) {
-  address = address & ~0b11; // Disregard unaligned accesses
+void CacheSim::access(AInt address, MemoryAccess::Type type, AInt pc) {
+  address &= ~lowBitMask(m_byteOffset); // Disregard unaligned accesses
   CacheTrace trace;
   CacheWay oldWay;
   CacheTransaction transaction;
   transaction.address = address;
+  transaction.pc = pc;
   transaction.type = type;
 
   analyzeCacheAccess(transaction);
+  trace.repl = snapshotReplFields(transaction.index.line);
 
   if (!transaction.isHit) {
     if (type == MemoryAccess::Read ||
@@ -340,16 +497,22 @@ void CacheSim::access(AInt address, MemoryAccess::Type type) {
     // Lazily ensure that the located way has been initialized
     m_cacheLines[transaction.index.line][transaction.index.way];
 
+    CacheWay &way = m_cacheLines[transaction.index.line][transaction.index.way];
     if (type == MemoryAccess::Write &&
         getWritePolicy() == WritePolicy::WriteBack) {
-      CacheWay &way =
-          m_cacheLines[transaction.index.line][transaction.index.way];
       way.dirty = true;
       way.dirtyBlocks.insert(transaction.index.block);
     }
 
+    if (transaction.isHit && way.prefetched) {
+      // First access to a prefetched block
+      transaction.prefetchHit = true;
+      way.prefetched = false;
+      m_prefetchStats.useful++;
+    }
+
     updateCacheLineReplFields(m_cacheLines[transaction.index.line],
-                              transaction.index.way);
+                              transaction);
   } else {
     // In case of a write miss with no write allocate, the value is always
     // written through to memory (a writeback)
@@ -363,14 +526,31 @@ void CacheSim::access(AInt address, MemoryAccess::Type type) {
     transaction.isWriteback = true;
   }
 
+  // === Classify the access ===
+  transaction.missType = m_missClassifier.access(
+      blockAddress(address), transaction.isHit, !writeMissNoAlloc);
+  if (!transaction.isHit) {
+    m_missesByPC.add(pc);
+    m_missesByAddress.add(blockAddress(address));
+  }
+
   // ===========================
 
+  // Prefetches are issued after the demand access, and are recorded as part of
+  // its trace.
+  if (auto target = prefetchTarget(transaction, trace)) {
+    prefetch(*target, trace);
+    transaction.prefetchWriteback =
+        trace.prefetch && trace.prefetch->isWriteback;
+  }
+
   // At this point, no further changes shall be made to the transaction.
   // We record the transaction as well as a possible eviction
   trace.oldWay = oldWay;
   trace.transaction = transaction;
   pushTrace(trace);
   pushAccessTrace(transaction);
+  recordSetAccess(transaction, false);
 
   // === Some sanity checking ===
   // It should never be possible that a read returns an invalid way index
@@ -403,10 +583,35 @@ void CacheSim::undo() {
 
   const auto trace = popTrace();
   popAccessTrace();
+  recordSetAccess(trace.transaction, true);
+  m_missClassifier.undo();
+  if (!trace.transaction.isHit) {
+    m_missesByPC.remove(trace.transaction.pc);
+    m_missesByAddress.remove(blockAddress(trace.transaction.address));
+  }
+
+  // Prefetches were issued after the demand access, and are thus reverted
+  // first.
+  if (trace.prefetch)
+    undoPrefetch(*trace.prefetch);
+  if (trace.stride) {
+    if (trace.stride->entry)
+      m_strideTable[trace.stride->pc] = *trace.stride->entry;
+    else
+      m_strideTable.erase(trace.stride->pc);
+  }
+  if (trace.transaction.prefetchHit)
+    m_prefetchStats.useful--;
 
   const auto &oldWay = trace.oldWay;
   const unsigned &lineIdx = trace.transaction.index.line;
   const unsigned &wayIdx = trace.transaction.index.way;
+  if (wayIdx == s_invalidIndex) {
+    // A write miss without write allocation; the cache was not modified.
+    emit dataChanged(m_traceStack.size() > 0 ? m_traceStack.begin()->transaction
+                                             : CacheTransaction());
+    return;
+  }
   auto &line = m_cacheLines.at(lineIdx);
   auto &way = line.at(wayIdx);
 
@@ -425,8 +630,11 @@ void CacheSim::undo() {
   }
   // Case 3: Else, it was a cache hit; Revert replacement fields and dirty
   // blocks
+  way.dirty = oldWay.dirty;
   way.dirtyBlocks = oldWay.dirtyBlocks;
+  way.prefetched = oldWay.prefetched;
   revertCacheLineReplFields(line, oldWay, wayIdx);
+  restoreReplFields(lineIdx, trace.repl);
 
   // Notify that changes to the way has been performed
   emit wayInvalidated(lineIdx, wayIdx);
@@ -440,6 +648,91 @@ void CacheSim::undo() {
   }
 }
 
+std::optional<AInt>
+CacheSim::prefetchTarget(const CacheTransaction &transaction,
+                         CacheTrace &trace) {
+  const AInt blockBytes = getLineBytes();
+  std::optional<AInt> target;
+  switch (m_prefetchPolicy) {
+  case PrefetchPolicy::NoPrefetch:
+    return {};
+  case PrefetchPolicy::NextLinePrefetch:
+    // Prefetch the next block upon a miss.
+    if (!transaction.isHit)
+      target = blockAddress(transaction.address) + blockBytes;
+    break;
+  case PrefetchPolicy::StridePrefetch: {
+    StrideTrace strideTrace{transaction.pc, {}};
+    if (auto it = m_strideTable.find(transaction.pc); it != m_strideTable.end())
+      strideTrace.entry = it->second;
+    trace.stride = strideTrace;
+
+    auto &entry = m_strideTable[transaction.pc];
+    const AInt stride = transaction.address - entry.lastAddress;
+    if (stride != 0 && stride == entry.stride) {
+      entry.confidence = std::min(entry.confidence + 1, c_strideConfidence);
+    } else {
+      if (entry.confidence > 0)
+        entry.confidence--;
+      if (entry.confidence == 0)
+        entry.stride = stride;
+    }
+    entry.lastAddress = transaction.address;
+    if (entry.confidence >= c_strideConfidence)
+      target = transaction.address + entry.stride;
+    break;
+  }
+  }
+
+  // Accesses within the block which was just accessed need no prefetching.
+  if (target && blockAddress(*target) == blockAddress(transaction.address))
+    return {};
+  return target;
+}
+
+void CacheSim::prefetch(AInt address, CacheTrace &trace) {
+  CacheTransaction transaction;
+  transaction.address = blockAddress(address);
+  transaction.type = MemoryAccess::Read;
+  analyzeCacheAccess(transaction);
+  if (transaction.isHit)
+    return; // Already present in the cache
+
+  PrefetchTrace prefetchTrace;
+  prefetchTrace.lineIdx = transaction.index.line;
+  prefetchTrace.repl = snapshotReplFields(transaction.index.line);
+  prefetchTrace.oldWay = evictAndUpdate(transaction);
+  prefetchTrace.wayIdx = transaction.index.way;
+  prefetchTrace.transToValid = transaction.transToValid;
+  prefetchTrace.isWriteback = transaction.isWriteback;
+
+  auto &line = m_cacheLines[transaction.index.line];
+  line[transaction.index.way].prefetched = true;
+  updateCacheLineReplFields(line, transaction);
+  m_prefetchStats.issued++;
+  trace.prefetch = prefetchTrace;
+
+  if (!ProcessorHandler::isRunning())
+    emit wayInvalidated(transaction.index.line, transaction.index.way);
+}
+
+void CacheSim::undoPrefetch(const PrefetchTrace &trace) {
+  auto &line = m_cacheLines.at(trace.lineIdx);
+  auto &way = line.at(trace.wayIdx);
+  way = trace.transToValid ? CacheWay() : trace.oldWay;
+  revertCacheLineReplFields(line, trace.oldWay, trace.wayIdx);
+  restoreReplFields(trace.lineIdx, trace.repl);
+  m_prefetchStats.issued--;
+  emit wayInvalidated(trace.lineIdx, trace.wayIdx);
+}
+
+void CacheSim::resetPolicyState() {
+  m_plruTrees.assign(getLines(), 0);
+  m_brripInsertions = 0;
+  m_strideTable.clear();
+  m_prefetchStats = PrefetchStats();
+}
+
 CacheSim::CacheTrace CacheSim::popTrace() {
   Q_ASSERT(m_traceStack.size() > 0);
   auto val = m_traceStack.front();
@@ -454,12 +747,12 @@ void CacheSim::pushTrace(const CacheTrace &eviction) {
   }
 }
 
-AInt CacheSim::buildAddress(unsigned tag, unsigned lineIdx,
+AInt CacheSim::buildAddress(AInt tag, unsigned lineIdx,
                             unsigned blockIdx) const {
   AInt address = 0;
   address |= tag << (m_byteOffset + getBlockBits() + getLineBits());
-  address |= lineIdx << (m_byteOffset + getBlockBits());
-  address |= blockIdx << (m_byteOffset);
+  address |= static_cast<AInt>(lineIdx) << (m_byteOffset + getBlockBits());
+  address |= static_cast<AInt>(blockIdx) << (m_byteOffset);
   return address;
 }
 
@@ -469,7 +762,7 @@ unsigned CacheSim::getLineIdx(const AInt address) const {
   return maskedAddress;
 }
 
-unsigned CacheSim::getTag(const AInt address) const {
+AInt CacheSim::getTag(const AInt address) const {
   AInt maskedAddress = address & m_tagMask;
   maskedAddress >>= m_byteOffset + getBlockBits() + getLineBits();
   return maskedAddress;
@@ -481,6 +774,62 @@ unsigned CacheSim::getBlockIdx(const AInt address) const {
   return maskedAddress;
 }
 
+void CacheSim::recordSetAccess(const CacheTransaction &transaction,
+                               bool undo) {
+  if (transaction.index.line >= m_setStats.size())
+    return;
+  auto &stats = m_setStats[transaction.index.line];
+  const auto count = [undo](unsigned &counter) {
+    counter = undo ? counter - 1 : counter + 1;
+  };
+  count(transaction.isHit ? stats.hits : stats.misses);
+  switch (transaction.missType) {
+  case CacheMissType::Compulsory:
+    count(stats.compulsory);
+    break;
+  case CacheMissType::Capacity:
+    count(stats.capacity);
+    break;
+  case CacheMissType::Conflict:
+    count(stats.conflict);
+    break;
+  case CacheMissType::None:
+    break;
+  }
+}
+
+CacheSim::SetStats CacheSim::getTotalStats() const {
+  SetStats total;
+  for (const auto &stats : m_setStats) {
+    total.hits += stats.hits;
+    total.misses += stats.misses;
+    total.compulsory += stats.compulsory;
+    total.capacity += stats.capacity;
+    total.conflict += stats.conflict;
+  }
+  return total;
+}
+
+void CacheSim::resetMissAnalysis() {
+  m_setStats.assign(getLines(), SetStats());
+  m_missClassifier.reset(static_cast<size_t>(getLines()) * getWays());
+  m_missClassifier.setUndoDepth(
+      vsrtl::core::ClockedComponent::reverseStackSize());
+  m_missesByPC.clear();
+  m_missesByAddress.clear();
+}
+
+AInt CacheSim::blockAddress(AInt address) const {
+  const unsigned offsetBits = m_byteOffset + getBlockBits();
+  return address & ~lowBitMask(offsetBits);
+}
+
+CacheSim::SetStats CacheSim::getSetStats(unsigned lineIdx) const {
+  if (lineIdx < m_setStats.size())
+    return m_setStats[lineIdx];
+  return SetStats();
+}
+
 const CacheSim::CacheLine *CacheSim::getLine(unsigned idx) const {
   if (m_cacheLines.count(idx)) {
     return &m_cacheLines.at(idx);
@@ -510,11 +859,21 @@ void CacheSim::reverse() {
 
 void CacheSim::recalculateMasks() {
   unsigned bitOffset = m_byteOffset;
-  m_blockMask = vsrtl::generateBitmask(getBlockBits()) << bitOffset;
+  m_blockMask = lowBitMask(getBlockBits()) << bitOffset;
   bitOffset += getBlockBits();
-  m_lineMask = vsrtl::generateBitmask(getLineBits()) << bitOffset;
+  m_lineMask = lowBitMask(getLineBits()) << bitOffset;
   bitOffset += getLineBits();
-  m_tagMask = vsrtl::generateBitmask(m_wordBits - bitOffset) << bitOffset;
+  m_tagMask = bitOffset >= m_addressBits
+                  ? 0
+                  : lowBitMask(m_addressBits - bitOffset) << bitOffset;
+}
+
+void CacheSim::updateWordSize() {
+  const auto *isa = ProcessorHandler::currentISA();
+  const unsigned wordBytes = m_wordBytes != 0 ? m_wordBytes : isa->bytes();
+  m_byteOffset = log2Ceil(wordBytes);
+  m_wordBits = wordBytes * CHAR_BIT;
+  m_addressBits = isa->bits();
 }
 
 void CacheSim::reset() {
@@ -528,9 +887,10 @@ void CacheSim::reset() {
   m_cacheLines.clear();
   m_accessTrace.clear();
   m_traceStack.clear();
+  resetMissAnalysis();
+  resetPolicyState();
 
-  m_wordBits = ProcessorHandler::currentISA()->bits();
-  m_byteOffset = log2Ceil(ProcessorHandler::currentISA()->bytes());
+  updateWordSize();
   recalculateMasks();
   m_isResetting = false;
 
@@ -542,8 +902,10 @@ void CacheSim::reset() {
 
 void CacheSim::updateConfiguration() {
   // Recalculate masks
-  m_byteOffset = log2Ceil(ProcessorHandler::currentISA()->bytes());
+  updateWordSize();
   recalculateMasks();
+  resetMissAnalysis();
+  resetPolicyState();
   emit configurationChanged();
 }
 
@@ -577,6 +939,21 @@ void CacheSim::setReplacementPolicy(ReplPolicy policy) {
   updateConfiguration();
 }
 
+void CacheSim::setPrefetchPolicy(PrefetchPolicy policy) {
+  m_prefetchPolicy = policy;
+  updateConfiguration();
+}
+
+void CacheSim::setWordBytes(unsigned bytes) {
+  m_wordBytes = bytes;
+  updateConfiguration();
+}
+
+void CacheSim::setTiming(const CacheTiming &timing) {
+  m_timing = timing;
+  updateConfiguration();
+}
+
 void CacheSim::setPreset(const CachePreset &preset) {
   m_blocks = preset.blocks;
   m_ways = std::max(1, preset.ways);
@@ -584,6 +961,9 @@ void CacheSim::setPreset(const CachePreset &preset) {
   m_wrPolicy = preset.wrPolicy;
   m_wrAllocPolicy = preset.wrAllocPolicy;
   m_replPolicy = preset.replPolicy;
+  m_prefetchPolicy = preset.prefetchPolicy;
+  m_timing = preset.timing;
+  m_wordBytes = preset.wordBytes;
 
   updateConfiguration();
 }
@@ -2,12 +2,15 @@
 
 #include <map>
 #include <math.h>
+#include <optional>
+#include <unordered_map>
 #include <vector>
 
 #include <QDataStream>
 #include <QObject>
 
 #include "VSRTL/core/vsrtl_register.h"
+#include "cachemissclassifier.h"
 #include "processors/RISC-V/rv_memory.h"
 #include "processors/interface/ripesprocessor.h"
 
@@ -16,7 +19,33 @@ class CacheSim;
 
 enum WriteAllocPolicy { WriteAllocate, NoWriteAllocate };
 enum WritePolicy { WriteThrough, WriteBack };
-enum ReplPolicy { Random, LRU };
+enum ReplPolicy { Random, LRU, FIFO, PLRU, SRRIP, BRRIP, LFU };
+enum PrefetchPolicy { NoPrefetch, NextLinePrefetch, StridePrefetch };
+
+/**
+ * @brief The CacheTiming struct
+ * Latencies, in cycles, used to estimate the memory stall cycles incurred by
+ * the accesses to a cache. The processor models assume single-cycle memory, so
+ * only the cycles of a hit beyond the first one stall the pipeline. The
+ * default timing adds no stall cycles.
+ */
+struct CacheTiming {
+  // Access time of the cache itself.
+  unsigned hitLatency = 1;
+  // Additional time to fetch a block from the next level of the memory
+  // hierarchy (L2 or DRAM) upon a miss.
+  unsigned missLatency = 0;
+  // Time to write a block (or a word, for write-through caches) to the next
+  // level of the memory hierarchy.
+  unsigned writebackLatency = 0;
+
+  bool operator==(const CacheTiming &other) const {
+    return hitLatency == other.hitLatency &&
+           missLatency == other.missLatency &&
+           writebackLatency == other.writebackLatency;
+  }
+  bool operator!=(const CacheTiming &other) const { return !(*this == other); }
+};
 
 struct CachePreset {
   QString name;
@@ -27,6 +56,19 @@ struct CachePreset {
   WritePolicy wrPolicy;
   WriteAllocPolicy wrAllocPolicy;
   ReplPolicy replPolicy;
+  PrefetchPolicy prefetchPolicy = PrefetchPolicy::NoPrefetch;
+  CacheTiming timing;
+  // Size of a cache word in bytes. 0 denotes the register width of the ISA.
+  unsigned wordBytes = 0;
+
+  // The prefetch policy is stored in bits 16-23 of the replacement policy
+  // field, and the version of the fields following it in bits 24-31. This
+  // keeps the format of the presets stored by earlier versions (which then
+  // load with the defaults of the fields they lack) unchanged.
+  // Version 1: timing. Version 2: timing, word size.
+  static constexpr qint32 c_prefetchShift = 16;
+  static constexpr qint32 c_versionShift = 24;
+  static constexpr qint32 c_version = 2;
 
   friend QDataStream &operator<<(QDataStream &arch, const CachePreset &object) {
     arch << object.name;
@@ -35,7 +77,13 @@ struct CachePreset {
     arch << object.ways;
     arch << object.wrPolicy;
     arch << object.wrAllocPolicy;
-    arch << object.replPolicy;
+    arch << static_cast<qint32>(object.replPolicy |
+                                (object.prefetchPolicy << c_prefetchShift) |
+                                (c_version << c_versionShift));
+    arch << object.timing.hitLatency;
+    arch << object.timing.missLatency;
+    arch << object.timing.writebackLatency;
+    arch << object.wordBytes;
     return arch;
   }
 
@@ -46,7 +94,21 @@ struct CachePreset {
     arch >> object.ways;
     arch >> object.wrPolicy;
     arch >> object.wrAllocPolicy;
-    arch >> object.replPolicy;
+    qint32 policies;
+    arch >> policies;
+    object.replPolicy = static_cast<ReplPolicy>(policies & 0xFFFF);
+    object.prefetchPolicy =
+        static_cast<PrefetchPolicy>((policies >> c_prefetchShift) & 0xFF);
+    const qint32 version = (policies >> c_versionShift) & 0xFF;
+    object.timing = CacheTiming();
+    object.wordBytes = 0;
+    if (version >= 1) {
+      arch >> object.timing.hitLatency;
+      arch >> object.timing.missLatency;
+      arch >> object.timing.writebackLatency;
+    }
+    if (version >= 2)
+      arch >> object.wordBytes;
     return arch;
   }
 
@@ -64,9 +126,10 @@ public:
   /**
    * @brief access
    * A function called by the logical "child" of this cache, indicating that it
-   * desires to access this cache
+   * desires to access this cache. @p pc is the program counter of the
+   * instruction performing the access.
    */
-  virtual void access(AInt address, MemoryAccess::Type type) = 0;
+  virtual void access(AInt address, MemoryAccess::Type type, AInt pc) = 0;
   void setNextLevelCache(const std::shared_ptr<CacheSim> &cache) {
     m_nextLevelCache = cache;
   }
@@ -106,6 +169,13 @@ public:
     // LRU algorithm relies on invalid cache ways to have an initial high value.
     // -1 ensures maximum value for all way sizes.
     unsigned lru = -1;
+
+    // Replacement state of the FIFO (insertion order), SRRIP/BRRIP
+    // (re-reference prediction value) and LFU (access count) policies.
+    uint64_t replState = 0;
+
+    // True if the way was filled by a prefetch, and not yet accessed.
+    bool prefetched = false;
   };
 
   struct CacheIndex {
@@ -126,6 +196,7 @@ public:
 
   struct CacheTransaction {
     AInt address;
+    AInt pc = 0;
     CacheIndex index;
 
     bool isHit = false;
@@ -136,6 +207,11 @@ public:
         false; // True if the cacheline just transitioned from invalid to valid
     bool tagChanged =
         false; // True if transToValid or the previous entry was evicted
+    CacheMissType missType = CacheMissType::None;
+    bool prefetchHit = false; // True if the access was the first access to a
+                              // prefetched way
+    bool prefetchWriteback = false; // True if a prefetch issued by the access
+                                    // evicted a dirty cacheline
   };
 
   struct CacheAccessTrace {
@@ -153,26 +229,67 @@ public:
       lastTransaction = transaction;
       reads = pre.reads + (transaction.type == MemoryAccess::Read ? 1 : 0);
       writes = pre.writes + (transaction.type == MemoryAccess::Write ? 1 : 0);
-      writebacks = pre.writebacks + (transaction.isWriteback ? 1 : 0);
+      writebacks = pre.writebacks + (transaction.isWriteback ? 1 : 0) +
+                   (transaction.prefetchWriteback ? 1 : 0);
       hits = pre.hits + (transaction.isHit ? 1 : 0);
       misses = pre.misses + (transaction.isHit ? 0 : 1);
     }
   };
 
+  /**
+   * @brief The SetStats struct
+   * Access counters of a single cache line (set), accumulated since the last
+   * reset of the cache.
+   */
+  struct SetStats {
+    unsigned hits = 0;
+    unsigned misses = 0;
+    unsigned compulsory = 0;
+    unsigned capacity = 0;
+    unsigned conflict = 0;
+  };
+
+  /**
+   * @brief The PrefetchStats struct
+   * Prefetches issued into the cache, and the number of those which were
+   * accessed before being evicted.
+   */
+  struct PrefetchStats {
+    unsigned issued = 0;
+    unsigned useful = 0;
+  };
+
+  /// Number of entries reported by getTopMissPCs/getTopMissAddresses.
+  static constexpr unsigned s_defaultTopMisses = 10;
+
   using CacheLine = std::map<unsigned, CacheWay>;
 
   CacheSim(QObject *parent);
   void setWritePolicy(WritePolicy policy);
   void setWriteAllocatePolicy(WriteAllocPolicy policy);
   void setReplacementPolicy(ReplPolicy policy);
+  void setPrefetchPolicy(PrefetchPolicy policy);
 
-  void access(AInt address, MemoryAccess::Type type) override;
+  void access(AInt address, MemoryAccess::Type type, AInt pc) override;
   void undo();
   void reset() override;
 
   WriteAllocPolicy getWriteAllocPolicy() const { return m_wrAllocPolicy; }
   ReplPolicy getReplacementPolicy() const { return m_replPolicy; }
   WritePolicy getWritePolicy() const { return m_wrPolicy; }
+  PrefetchPolicy getPrefetchPolicy() const { return m_prefetchPolicy; }
+  PrefetchStats getPrefetchStats() const { return m_prefetchStats; }
+
+  void setTiming(const CacheTiming &timing);
+  const CacheTiming &getTiming() const { return m_timing; }
+
+  /**
+   * @brief getStallCycles
+   * Returns the estimated number of cycles which the processor would have
+   * stalled on the accesses to this cache so far, as per the configured
+   * timing.
+   */
+  uint64_t getStallCycles() const;
 
   const std::map<unsigned, CacheAccessTrace> &getAccessTrace() const {
     return m_accessTrace;
@@ -184,26 +301,59 @@ public:
   unsigned getWritebacks() const;
   CacheSize getCacheSize() const;
 
-  AInt buildAddress(unsigned tag, unsigned lineIdx, unsigned blockIdx) const;
+  AInt buildAddress(AInt tag, unsigned lineIdx, unsigned blockIdx) const;
 
   int getBlockBits() const { return m_blocks; }
   int getLineBits() const { return m_lines; }
   int getTagBits() const {
-    return 32 - 2 /*byte offset*/ - getBlockBits() - getLineBits();
+    return static_cast<int>(m_addressBits - m_byteOffset) - getBlockBits() -
+           getLineBits();
   }
+  /// Number of bits addressing a byte within a cache word.
+  unsigned getByteOffsetBits() const { return m_byteOffset; }
+  /// Width of the addresses decomposed by the cache.
+  unsigned getAddressBits() const { return m_addressBits; }
 
   int getBlocks() const { return static_cast<int>(std::pow(2, m_blocks)); }
   int getWays() const { return m_ways; }
   int getLines() const { return static_cast<int>(std::pow(2, m_lines)); }
-  unsigned getBlockMask() const { return m_blockMask; }
-  unsigned getTagMask() const { return m_tagMask; }
-  unsigned getLineMask() const { return m_lineMask; }
+  AInt getBlockMask() const { return m_blockMask; }
+  AInt getTagMask() const { return m_tagMask; }
+  AInt getLineMask() const { return m_lineMask; }
+
+  /**
+   * @brief setWordBytes
+   * Sets the size of a cache word in bytes (a power of two). 0 selects the
+   * register width of the current ISA.
+   */
+  void setWordBytes(unsigned bytes);
+  /// Returns the configured word size; 0 if following the ISA.
+  unsigned getWordBytesSetting() const { return m_wordBytes; }
+  unsigned getWordBytes() const { return 1u << m_byteOffset; }
+  unsigned getLineBytes() const { return getWordBytes() << m_blocks; }
 
   unsigned getLineIdx(const AInt address) const;
   unsigned getBlockIdx(const AInt address) const;
-  unsigned getTag(const AInt address) const;
+  AInt getTag(const AInt address) const;
 
   const CacheLine *getLine(unsigned idx) const;
+  SetStats getSetStats(unsigned lineIdx) const;
+  /// Accumulated access counters of all lines in the cache.
+  SetStats getTotalStats() const;
+
+  /**
+   * @brief getTopMissPCs/getTopMissAddresses
+   * @returns the (at most) @p n program counters, respectively block
+   * addresses, which caused the most misses, in descending order of misses.
+   */
+  std::vector<std::pair<AInt, unsigned>>
+  getTopMissPCs(unsigned n = s_defaultTopMisses) const {
+    return m_missesByPC.top(n);
+  }
+  std::vector<std::pair<AInt, unsigned>>
+  getTopMissAddresses(unsigned n = s_defaultTopMisses) const {
+    return m_missesByAddress.top(n);
+  }
 
 public slots:
   void setBlocks(unsigned blocks);
@@ -240,13 +390,63 @@ signals:
 
 private:
   size_t m_cleanupCounter = 0;
+
+  /**
+   * @brief The ReplSnapshot struct
+   * Replacement state of a cache line prior to an access, for the policies
+   * whose state cannot be reverted from the evicted way alone (all but Random
+   * and LRU).
+   */
+  struct ReplSnapshot {
+    bool valid = false;
+    std::vector<std::pair<unsigned, uint64_t>> ways;
+    uint64_t plruTree = 0;
+    unsigned brripInsertions = 0;
+  };
+
+  /**
+   * @brief The PrefetchTrace struct
+   * A prefetch issued as a consequence of an access, for rollback.
+   */
+  struct PrefetchTrace {
+    unsigned lineIdx;
+    unsigned wayIdx;
+    CacheWay oldWay;
+    ReplSnapshot repl;
+    bool transToValid;
+    bool isWriteback;
+  };
+
+  // Stride prefetcher: a reference prediction table indexed by the program
+  // counter of the accessing instruction. A prefetch is issued once the same
+  // stride has been observed c_strideConfidence times in a row.
+  struct StrideEntry {
+    AInt lastAddress = 0;
+    AInt stride = 0;
+    unsigned confidence = 0;
+  };
+
+  /**
+   * @brief The StrideTrace struct
+   * The stride table entry of an accessing instruction prior to the access,
+   * for rollback. Unset if the instruction had no entry.
+   */
+  struct StrideTrace {
+    AInt pc;
+    std::optional<StrideEntry> entry;
+  };
+
   struct CacheTrace {
     CacheTransaction transaction;
     CacheWay oldWay;
+    ReplSnapshot repl;
+    std::optional<PrefetchTrace> prefetch;
+    std::optional<StrideTrace> stride;
   };
 
   std::pair<unsigned, CacheSim::CacheWay *>
   locateEvictionWay(const CacheTransaction &transaction);
+  unsigned selectVictim(unsigned lineIdx, CacheLine &line);
   CacheWay evictAndUpdate(CacheTransaction &transaction);
   void analyzeCacheAccess(CacheTransaction &transaction) const;
   void pushAccessTrace(const CacheTransaction &transaction);
@@ -259,6 +459,9 @@ private:
    */
   void updateConfiguration();
   void recalculateMasks();
+  /// Derives the word size and address width from the configured word size
+  /// and the current ISA.
+  void updateWordSize();
 
   /**
    * @brief reassociateMemory
@@ -271,15 +474,17 @@ private:
   WritePolicy m_wrPolicy = WritePolicy::WriteBack;
   WriteAllocPolicy m_wrAllocPolicy = WriteAllocPolicy::WriteAllocate;
 
-  unsigned m_blockMask = -1;
-  unsigned m_lineMask = -1;
-  unsigned m_tagMask = -1;
+  AInt m_blockMask = -1;
+  AInt m_lineMask = -1;
+  AInt m_tagMask = -1;
 
   int m_blocks = 2; // Some power of 2
   int m_lines = 5;  // Some power of 2
   int m_ways = 1;
   unsigned m_byteOffset = -1; // # of bits to represent the # of bytes in a word
   unsigned m_wordBits = -1;
+  unsigned m_addressBits = -1;
+  unsigned m_wordBytes = 0; // Configured word size; 0 follows the ISA
 
   // Cached copy of RIPES_SETTING_CACHE_MAXTRACES. Reading a QSettings-backed
   // value constructs a QSettings object (a registry/file access) on every
@@ -293,7 +498,69 @@ private:
    */
   std::map<unsigned, CacheLine> m_cacheLines;
 
-  void updateCacheLineReplFields(CacheLine &line, unsigned wayIdx);
+  /**
+   * @brief m_setStats
+   * Per-line access counters, indexed by line index. Sized to the number of
+   * lines in the cache upon reconfiguration.
+   */
+  std::vector<SetStats> m_setStats;
+  void recordSetAccess(const CacheTransaction &transaction, bool undo);
+
+  /**
+   * @brief m_missClassifier
+   * Shadow fully associative cache classifying misses as compulsory, capacity
+   * or conflict misses. Misses are furthermore counted per program counter and
+   * per block address.
+   */
+  CacheMissClassifier m_missClassifier;
+  MissCounter m_missesByPC;
+  MissCounter m_missesByAddress;
+  void resetMissAnalysis();
+  AInt blockAddress(AInt address) const;
+
+  void updateCacheLineReplFields(CacheLine &line,
+                                 const CacheTransaction &transaction);
+  ReplSnapshot snapshotReplFields(unsigned lineIdx) const;
+  void restoreReplFields(unsigned lineIdx, const ReplSnapshot &snapshot);
+
+  // Tree pseudo-LRU. Each line holds a binary tree of (ways - 1) bits, rounded
+  // up to a power of two, where each bit points towards the least recently
+  // used half of its subtree. Bit i corresponds to node i of the tree, where
+  // the root is node 1 and the children of node n are 2n and 2n+1.
+  unsigned plruVictim(unsigned lineIdx) const;
+  void plruTouch(unsigned lineIdx, unsigned wayIdx);
+  std::vector<uint64_t> m_plruTrees;
+
+  // SRRIP/BRRIP use 2-bit re-reference prediction values (RRPV). BRRIP inserts
+  // with a long re-reference interval except for every c_brripLongInterval'th
+  // insertion.
+  static constexpr uint64_t c_rrpvMax = 3;
+  static constexpr unsigned c_brripLongInterval = 32;
+  unsigned m_brripInsertions = 0;
+
+  // LFU access counters saturate at c_lfuMax.
+  static constexpr unsigned c_lfuCounterBits = 8;
+  static constexpr uint64_t c_lfuMax = (1 << c_lfuCounterBits) - 1;
+
+  /**
+   * @brief prefetchTarget
+   * Returns the address to prefetch as a consequence of @p transaction, as per
+   * the configured prefetch policy. Any prefetcher state updated by the access
+   * is recorded in @p trace.
+   */
+  std::optional<AInt> prefetchTarget(const CacheTransaction &transaction,
+                                     CacheTrace &trace);
+  void prefetch(AInt address, CacheTrace &trace);
+  void undoPrefetch(const PrefetchTrace &trace);
+
+  static constexpr unsigned c_strideConfidence = 2;
+  std::unordered_map<AInt, StrideEntry> m_strideTable;
+
+  PrefetchPolicy m_prefetchPolicy = PrefetchPolicy::NoPrefetch;
+  CacheTiming m_timing;
+  PrefetchStats m_prefetchStats;
+  void resetPolicyState();
+
   /**
    * @brief revertCacheLineReplFields
    * Called whenever undoing a transaction to the cache. Reverts a cacheline's
@@ -334,7 +601,14 @@ private:
 };
 
 const static std::map<ReplPolicy, QString> s_cacheReplPolicyStrings{
-    {ReplPolicy::Random, "Random"}, {ReplPolicy::LRU, "LRU"}};
+    {ReplPolicy::Random, "Random"}, {ReplPolicy::LRU, "LRU"},
+    {ReplPolicy::FIFO, "FIFO"},     {ReplPolicy::PLRU, "Tree-PLRU"},
+    {ReplPolicy::SRRIP, "SRRIP"},   {ReplPolicy::BRRIP, "BRRIP"},
+    {ReplPolicy::LFU, "LFU"}};
+const static std::map<PrefetchPolicy, QString> s_cachePrefetchPolicyStrings{
+    {PrefetchPolicy::NoPrefetch, "None"},
+    {PrefetchPolicy::NextLinePrefetch, "Next line"},
+    {PrefetchPolicy::StridePrefetch, "Stride"}};
 const static std::map<WriteAllocPolicy, QString> s_cacheWriteAllocateStrings{
     {WriteAllocPolicy::WriteAllocate, "Write allocate"},
     {WriteAllocPolicy::NoWriteAllocate, "No write allocate"}};
@@ -354,5 +628,6 @@ Q_DECLARE_METATYPE(Ripes::CacheSim::CacheTransaction);
 Q_DECLARE_METATYPE(Ripes::WritePolicy);
 Q_DECLARE_METATYPE(Ripes::WriteAllocPolicy);
 Q_DECLARE_METATYPE(Ripes::ReplPolicy);
+Q_DECLARE_METATYPE(Ripes::PrefetchPolicy);
 Q_DECLARE_METATYPE(Ripes::CachePreset);
 Q_DECLARE_METATYPE(QList<Ripes::CachePreset>);
@@ -1,11 +1,11 @@
 #include "cacheview.h"
 
-#include <QGraphicsSimpleTextItem>
 #include <QScrollBar>
 #include <QWheelEvent>
 #include <algorithm>
 #include <qmath.h>
 
+#include "cachegraphic.h"
 #include "ripessettings.h"
 
 namespace Ripes {
@@ -39,15 +39,15 @@ void CacheView::mousePressEvent(QMouseEvent *event) {
     return;
   }
 
-  // If we press on a cache data block, get the address stored for that block
-  // and emit a signal indicating that the address was selected through the
-  // cache
+  // If we press on a cache data block, get the address of that block and emit
+  // a signal indicating that the address was selected through the cache
+  const QPointF scenePos = mapToScene(event->pos());
   const auto viewItems = items(event->pos());
   for (const auto &item : std::as_const(viewItems)) {
-    if (auto *textItem = dynamic_cast<QGraphicsSimpleTextItem *>(item)) {
-      const QVariant userData = textItem->data(Qt::UserRole);
-      if (userData.isValid()) {
-        emit cacheAddressSelected(userData.toULongLong());
+    if (auto *cacheGraphic = dynamic_cast<CacheGraphic *>(item)) {
+      if (auto address =
+              cacheGraphic->addressAt(cacheGraphic->mapFromScene(scenePos))) {
+        emit cacheAddressSelected(*address);
         break;
       }
     }
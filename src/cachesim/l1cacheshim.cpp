@@ -21,13 +21,16 @@ L1CacheShim::L1CacheShim(CacheType type, QObject *parent)
   processorReset();
 }
 
-void L1CacheShim::access(AInt, MemoryAccess::Type) {
+void L1CacheShim::access(AInt, MemoryAccess::Type, AInt) {
   // Should never occur; the shim determines accesses based on investigating the
   // associated memory.
   Q_ASSERT(false);
 }
 
 void L1CacheShim::processorReset() {
+  // The processor may have been replaced; re-determine its memory stages.
+  m_stagesProcessor = nullptr;
+
   // Propagate a reset through the cache hierarchy
   CacheInterface::reset();
 
@@ -44,6 +47,30 @@ void L1CacheShim::processorReversed() {
   CacheInterface::reverse();
 }
 
+AInt L1CacheShim::dataAccessPC() {
+  const auto *processor = ProcessorHandler::getProcessor();
+  if (processor != m_stagesProcessor) {
+    // Stage names are only looked up once per processor. For multi-lane
+    // processors, memory instructions are issued to the last lane.
+    m_stagesProcessor = processor;
+    m_dataAccessStages.clear();
+    const auto &structure = processor->structure();
+    for (auto lane = structure.rbegin(); lane != structure.rend(); ++lane)
+      for (unsigned stage = 0; stage < lane->second; ++stage)
+        if (processor->stageName({lane->first, stage}) == "MEM")
+          m_dataAccessStages.push_back({lane->first, stage});
+    if (m_dataAccessStages.empty())
+      m_dataAccessStages.push_back({0, 0});
+  }
+
+  for (const auto &stage : m_dataAccessStages) {
+    const auto info = processor->stageInfo(stage);
+    if (info.stage_valid)
+      return info.pc;
+  }
+  return 0;
+}
+
 void L1CacheShim::processorWasClocked() {
   // Only simulate the cache if the current processor actually exposes the
   // corresponding cache interface (unless this check has been explicitly
@@ -62,10 +89,12 @@ void L1CacheShim::processorWasClocked() {
     // if so, the access type.
     switch (dataAccess.type) {
     case MemoryAccess::Write:
-      m_nextLevelCache->access(dataAccess.address, MemoryAccess::Write);
+      m_nextLevelCache->access(dataAccess.address, MemoryAccess::Write,
+                               dataAccessPC());
       break;
     case MemoryAccess::Read:
-      m_nextLevelCache->access(dataAccess.address, MemoryAccess::Read);
+      m_nextLevelCache->access(dataAccess.address, MemoryAccess::Read,
+                               dataAccessPC());
       break;
     case MemoryAccess::None:
     default:
@@ -78,7 +107,8 @@ void L1CacheShim::processorWasClocked() {
     }
     const auto instrAccess = ProcessorHandler::getProcessor()->instrMemAccess();
     if (instrAccess.type == MemoryAccess::Read) {
-      m_nextLevelCache->access(instrAccess.address, MemoryAccess::Read);
+      m_nextLevelCache->access(instrAccess.address, MemoryAccess::Read,
+                               instrAccess.address);
     }
   }
 }
@@ -19,7 +19,7 @@ class L1CacheShim : public CacheInterface {
 public:
   enum class CacheType { DataCache, InstrCache };
   L1CacheShim(CacheType type, QObject *parent);
-  void access(AInt address, MemoryAccess::Type type) override;
+  void access(AInt address, MemoryAccess::Type type, AInt pc) override;
 
   void setType(CacheType type);
 
@@ -41,6 +41,15 @@ private:
   void processorWasClocked();
   void processorReversed();
 
+  /**
+   * @brief dataAccessPC
+   * Returns the program counter of the instruction accessing the data memory in
+   * the current cycle. This is the instruction in the memory stage of the
+   * processor; for processors without a memory stage, the instruction in the
+   * first stage.
+   */
+  AInt dataAccessPC();
+
   /**
    * @brief m_memory
    * The cache simulator may be attached to either a ROM or a Read/Write memory
@@ -50,6 +59,10 @@ private:
   CacheType m_type;
 
   bool m_requireCacheInterface = true;
+
+  // Candidate stages for dataAccessPC, determined once per processor.
+  const RipesProcessor *m_stagesProcessor = nullptr;
+  std::vector<StageIndex> m_dataAccessStages;
 };
 
 } // namespace Ripes
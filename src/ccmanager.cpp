@@ -6,8 +6,15 @@
 #include "ripessettings.h"
 #include "utilities/systemutils.h"
 
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
 #include <QProcess>
 #include <QProgressDialog>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QTemporaryFile>
+#include <QRegularExpression>
 #include <QTextDocument>
 
 namespace Ripes {
@@ -17,6 +24,42 @@ const static std::vector<QString> s_validAutodetectedCCs = {
     "riscv64-unknown-elf-c++"};
 const static QString s_testprogram = "int main() { return 0; }";
 
+// Bumped whenever the set of inputs hashed into the compilation cache key
+// changes.
+static constexpr qint32 c_compileCacheFormat = 3;
+// The oldest cached executables are removed when the cache grows beyond this
+// number of entries.
+static constexpr int c_maxCacheEntries = 128;
+
+#ifdef RIPES_WITH_QPROCESS
+/// Returns the default output file of a compilation, removing any previously
+/// compiled file.
+static QString tempOutputFile() {
+  const QString outname = QDir::tempPath() + QDir::separator() +
+                          QCoreApplication::applicationName() + ".temp.out";
+  QFile::remove(outname);
+  return outname;
+}
+#endif
+
+/// Returns the SHA-256 hash of the contents of @p path, or an empty array if
+/// the file cannot be read.
+static QByteArray hashFile(const QString &path) {
+  QFile file(path);
+  if (!file.open(QIODevice::ReadOnly))
+    return QByteArray();
+  QCryptographicHash hash(QCryptographicHash::Sha256);
+  hash.addData(&file);
+  return hash.result();
+}
+
+/// Validates that the output file of @p res is an executable.
+static void validateOutput(CCManager::CCRes &res) {
+  auto elfInfo = LoadDialog::validateELFFile(QFile(res.outFile));
+  res.success = elfInfo.valid;
+  res.errorOutput.errMsg = elfInfo.errorMessage;
+}
+
 QString indentString(const QString &string, int indent) {
   auto subStrings = string.split("\n");
   auto indentedStrings = QStringList();
@@ -42,7 +85,21 @@ QString CCManager::CompileError::toString(const CompileCommand &cc) const {
   return out.join("\n");
 }
 
+QString CCManager::defaultCacheDirectory() {
+  return QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation))
+      .filePath("elf");
+}
+
 CCManager::CCManager() {
+  // Caching is opt-in in the GUI. The CLI sets its cache directory explicitly
+  // (see setCacheDirectory()).
+  const auto updateCacheDir = [this](const QVariant &enabled) {
+    m_cacheDir = enabled.toBool() ? defaultCacheDirectory() : QString();
+  };
+  updateCacheDir(RipesSettings::value(RIPES_SETTING_CCCACHE));
+  connect(RipesSettings::getObserver(RIPES_SETTING_CCCACHE),
+          &SettingObserver::modified, this, updateCacheDir);
+
   if (RipesSettings::value(RIPES_SETTING_CCPATH) == "") {
     // No previous compiler path has been set. Try to autodetect a valid
     // compiler within the current path
@@ -81,8 +138,7 @@ bool CCManager::trySetCC(const QString &CC) {
   return res.success;
 }
 
-CCManager::CCRes CCManager::compileRaw(const QString &rawsource,
-                                       QString outname, bool showProgressdiag) {
+QStringList CCManager::writeSourceFiles(const QString &rawsource) {
   // Write program to temporary file with a .c extension
   if (!(m_tmpSrcFile && (QFile::exists(m_tmpSrcFile->fileName())))) {
     const auto tempFileTemplate =
@@ -110,7 +166,12 @@ CCManager::CCRes CCManager::compileRaw(const QString &rawsource,
     sourceFiles << peripheralSymbolsHeader;
   }
 
-  return compile(sourceFiles, outname, showProgressdiag);
+  return sourceFiles;
+}
+
+CCManager::CCRes CCManager::compileRaw(const QString &rawsource,
+                                       QString outname, bool showProgressdiag) {
+  return compile(writeSourceFiles(rawsource), outname, showProgressdiag);
 }
 
 CCManager::CCRes CCManager::compile(const QTextDocument *source,
@@ -121,13 +182,41 @@ CCManager::CCRes CCManager::compile(const QTextDocument *source,
 CCManager::CCRes CCManager::compile(const QStringList &files, QString outname,
                                     bool showProgressdiag) {
 #ifdef RIPES_WITH_QPROCESS
-  CCRes res;
-  if (outname.isEmpty()) {
-    outname = QDir::tempPath() + QDir::separator() +
-              QCoreApplication::applicationName() + ".temp.out";
-    QFile::remove(outname); // Remove any previously compiled file
+  if (outname.isEmpty())
+    outname = tempOutputFile();
+
+  const QString key = cacheKey(files);
+  CCRes cached;
+  cached.inFiles = files;
+  cached.outFile = outname;
+  cached.cc = createCompileCommand(files, outname);
+  if (loadCached(key, cached)) {
+    m_lastError.clear();
+    return cached;
   }
 
+  // The headers included by the sources are only listed when the result is
+  // cached.
+  QStringList includes;
+  auto res = runCompiler(files, outname, showProgressdiag,
+                         key.isEmpty() ? nullptr : &includes);
+  if (res.success)
+    storeCached(key, res.outFile, includes);
+  return res;
+#else
+  return runCompiler(files, outname, showProgressdiag);
+#endif
+}
+
+CCManager::CCRes CCManager::runCompiler(const QStringList &files,
+                                        QString outname,
+                                        bool showProgressdiag,
+                                        QStringList *includes) {
+#ifdef RIPES_WITH_QPROCESS
+  CCRes res;
+  if (outname.isEmpty())
+    outname = tempOutputFile();
+
   res.inFiles = files;
   res.outFile = outname;
 
@@ -147,22 +236,30 @@ CCManager::CCRes CCManager::compile(const QStringList &files, QString outname,
   m_aborted = false;
   m_errored = false;
   m_process.close();
-  QProgressDialog progressDiag =
-      QProgressDialog("Executing compiler...", "Abort", 0, 0, nullptr);
-  connect(&progressDiag, &QProgressDialog::canceled, &m_process,
-          &QProcess::kill);
-  connect(&progressDiag, &QProgressDialog::canceled, &m_process,
-          [this] { m_aborted = true; });
-  connect(&m_process,
-          QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
-          &progressDiag, &QProgressDialog::reset);
-  connect(&m_process, &QProcess::errorOccurred, &progressDiag,
-          &QProgressDialog::reset);
+  // The progress dialog is only constructed when shown; in headless CLI mode,
+  // no widgets may be constructed.
+  std::unique_ptr<QProgressDialog> progressDiag;
+  if (showProgressdiag) {
+    progressDiag = std::make_unique<QProgressDialog>(
+        "Executing compiler...", "Abort", 0, 0, nullptr);
+    connect(progressDiag.get(), &QProgressDialog::canceled, &m_process,
+            &QProcess::kill);
+    connect(progressDiag.get(), &QProgressDialog::canceled, &m_process,
+            [this] { m_aborted = true; });
+    connect(&m_process,
+            QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+            progressDiag.get(), &QProgressDialog::reset);
+    connect(&m_process, &QProcess::errorOccurred, progressDiag.get(),
+            &QProgressDialog::reset);
+  }
   connect(&m_process, &QProcess::errorOccurred, this,
           [this]() { m_errored = true; });
   m_process.setWorkingDirectory(cc.bin.absolutePath());
   m_process.setProgram(cc.bin.absoluteFilePath());
-  m_process.setArguments(cc.args);
+  QStringList args = cc.args;
+  if (includes)
+    args << "-H";
+  m_process.setArguments(args);
 
   m_process.start();
   /** @todo: It is seen that if the process fails upon startup, errorOccurred
@@ -171,14 +268,41 @@ CCManager::CCRes CCManager::compile(const QStringList &files, QString outname,
    * not remove the race condition. Such race condition seems inherintly tied to
    * how QDialog::exec works and no proper fix has been able to be found
    * (yet).*/
-  if (!m_errored && showProgressdiag) {
-    progressDiag.exec();
+  if (!m_errored && progressDiag) {
+    progressDiag->exec();
   }
   m_process.waitForFinished();
 
-  auto elfInfo = LoadDialog::validateELFFile(QFile(outname));
-  res.success = elfInfo.valid;
-  res.errorOutput.errMsg = elfInfo.errorMessage;
+  res.errorOutput._stdout = m_process.readAllStandardOutput();
+  QStringList errorLines;
+  const QStringList stderrLines =
+      QString(m_process.readAllStandardError()).split('\n');
+  if (includes) {
+    // -H lists each included header on a line of its own, prefixed by dots
+    // denoting the include depth. It is followed by a list of headers without
+    // include guards, which are all included headers themselves.
+    static const QRegularExpression includeRe(R"(^\.+ (.+)$)");
+    static const QString guardsNote =
+        "Multiple include guards may be useful for";
+    const QDir workingDir(cc.bin.absolutePath());
+    QStringList listed;
+    for (const auto &line : stderrLines) {
+      const auto match = includeRe.match(line);
+      if (match.hasMatch()) {
+        listed << match.captured(1);
+        includes->append(workingDir.absoluteFilePath(match.captured(1)));
+      } else if (!line.startsWith(guardsNote) && !listed.contains(line)) {
+        errorLines << line;
+      }
+    }
+    includes->removeDuplicates();
+  } else {
+    errorLines = stderrLines;
+  }
+  res.errorOutput._stderr = errorLines.join('\n');
+  m_lastError = res.errorOutput._stderr;
+
+  validateOutput(res);
   res.aborted = m_aborted;
 
   return res;
@@ -189,14 +313,95 @@ CCManager::CCRes CCManager::compile(const QStringList &files, QString outname,
 #endif
 }
 
-QString CCManager::getError() {
-#ifdef RIPES_WITH_QPROCESS
-  return get().m_process.readAllStandardError();
-#else
-  return QString();
-#endif
+QString CCManager::cacheKey(const QStringList &files) const {
+  if (m_cacheDir.isEmpty())
+    return QString();
+
+  QByteArray keyData;
+  QDataStream stream(&keyData, QIODevice::WriteOnly);
+  stream << c_compileCacheFormat;
+
+  // The compile command, with the (temporary) file paths substituted by
+  // placeholders. The size and modification time of the compiler identify
+  // in-place toolchain updates.
+  QStringList inputs;
+  for (int i = 0; i < files.size(); ++i)
+    inputs << "${input" + QString::number(i) + "}";
+  const auto cc = createCompileCommand(inputs, "${output}");
+  stream << cc.bin.absoluteFilePath() << cc.bin.size()
+         << cc.bin.lastModified() << cc.args;
+
+  // The input files. Included headers are verified when looking up an entry.
+  for (const auto &file : files)
+    stream << hashFile(file);
+
+  return QCryptographicHash::hash(keyData, QCryptographicHash::Sha256)
+      .toHex();
 }
 
+bool CCManager::loadCached(const QString &key, CCRes &res) const {
+  if (key.isEmpty() || res.outFile.isEmpty())
+    return false;
+  QFile entry(QDir(m_cacheDir).filePath(key + ".entry"));
+  if (!entry.open(QIODevice::ReadOnly))
+    return false;
+
+  // An entry is only valid while the headers it was compiled with are
+  // unchanged.
+  QDataStream stream(&entry);
+  QList<QPair<QString, QByteArray>> includes;
+  QByteArray executable;
+  stream >> includes >> executable;
+  if (stream.status() != QDataStream::Ok)
+    return false;
+  for (const auto &[path, hash] : includes) {
+    if (hashFile(path) != hash)
+      return false;
+  }
+
+  QFile output(res.outFile);
+  if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+      output.write(executable) != executable.size())
+    return false;
+  output.close();
+  validateOutput(res);
+  return res.success;
+}
+
+void CCManager::storeCached(const QString &key, const QString &outFile,
+                            const QStringList &includes) const {
+  if (key.isEmpty() || !QDir().mkpath(m_cacheDir))
+    return;
+
+  QFile output(outFile);
+  if (!output.open(QIODevice::ReadOnly))
+    return;
+  QList<QPair<QString, QByteArray>> includeHashes;
+  for (const auto &path : includes) {
+    const QByteArray hash = hashFile(path);
+    if (hash.isEmpty())
+      return;
+    includeHashes << qMakePair(path, hash);
+  }
+
+  // Write atomically, such that concurrent instances sharing the cache never
+  // observe a partially written entry.
+  QSaveFile entry(QDir(m_cacheDir).filePath(key + ".entry"));
+  if (!entry.open(QIODevice::WriteOnly))
+    return;
+  QDataStream stream(&entry);
+  stream << includeHashes << output.readAll();
+  if (!entry.commit())
+    return;
+
+  const QFileInfoList entries = QDir(m_cacheDir).entryInfoList(
+      {"*.entry"}, QDir::Files, QDir::Time);
+  for (int i = c_maxCacheEntries; i < entries.size(); ++i)
+    QFile::remove(entries.at(i).filePath());
+}
+
+QString CCManager::getError() { return get().m_lastError; }
+
 static QStringList sanitizedArguments(const QString &args) {
   QStringList arglist = args.split(" ");
   for (const auto invArg : {"", " ", "-"}) {
@@ -205,10 +410,27 @@ static QStringList sanitizedArguments(const QString &args) {
   return arglist;
 }
 
+QStringList CCManager::compilerArguments() const {
+  const auto &currentISA = ProcessorHandler::currentISA();
+  QStringList args;
+
+  // Machine architecture and ABI
+  args << (QString("-march=") + currentISA->CCmarch());
+  args << (QString("-mabi=") + currentISA->CCmabi());
+
+  // Additional CC arguments
+  args << sanitizedArguments(
+      RipesSettings::value(RIPES_SETTING_CCARGS).toString());
+
+  // Enforce compilation as C language (allows us to use C++ compilers)
+  args << "-x"
+       << "c";
+  return args;
+}
+
 CCManager::CompileCommand
 CCManager::createCompileCommand(const QStringList &files,
                                 const QString &outname) const {
-  const auto &currentISA = ProcessorHandler::currentISA();
 
   /**
    * @brief s_baseCC
@@ -228,19 +450,8 @@ CCManager::createCompileCommand(const QStringList &files,
   // Compiler path
   cc.bin = QFileInfo(m_currentCC);
 
-  // Substitute machine architecture
-  cc.args << (QString("-march=") + currentISA->CCmarch());
-
-  // Substitute machine ABI
-  cc.args << (QString("-mabi=") + currentISA->CCmabi());
-
-  // Substitute additional CC arguments
-  cc.args << sanitizedArguments(
-      RipesSettings::value(RIPES_SETTING_CCARGS).toString());
-
-  // Enforce compilation as C language (allows us to use C++ compilers)
-  cc.args << "-x"
-          << "c";
+  // Substitute machine architecture, ABI and additional CC arguments
+  cc.args << compilerArguments();
 
   // Substitute in and out files
   cc.args << files << "-o" << outname;
@@ -272,12 +483,9 @@ CCManager::CCRes CCManager::verifyCC(const QString &CCPath) {
     goto verifyCC_end;
   }
 
-  res = compileRaw(s_testprogram, QString(), false);
-
-  if (!res.success) {
-    res.errorOutput._stdout = QString(m_process.readAllStandardOutput());
-    res.errorOutput._stderr = QString(m_process.readAllStandardError());
-  }
+  // The test program is always compiled, such that the compiler itself is
+  // verified rather than a cached executable.
+  res = runCompiler(writeSourceFiles(s_testprogram), QString(), false);
 
   // Cleanup
   res.clean();
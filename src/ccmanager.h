@@ -9,6 +9,7 @@
 QT_FORWARD_DECLARE_CLASS(QTextDocument)
 
 #include <memory>
+#include <vector>
 
 namespace Ripes {
 
@@ -16,6 +17,15 @@ namespace Ripes {
  * @brief The CCManager class
  * Manages the detection, verification and execution of a valid C/C++ compiler
  * suitable for the ISAs targetted by the various processor models of Ripes.
+ *
+ * Compiled executables may be cached on disk (see setCacheDirectory()), keyed
+ * by the contents of the input files, the compiler (path, size and
+ * modification time) and the compiler arguments. Each entry records the
+ * headers included by the sources, as listed by the compiler (-H) when the
+ * entry was compiled, together with a hash of their contents; an entry is only
+ * used while all of these headers are unchanged. Looking up an entry thus
+ * never runs the compiler. In the GUI, caching is enabled through
+ * RIPES_SETTING_CCCACHE.
  */
 class CCManager : public QObject {
   Q_OBJECT
@@ -72,6 +82,14 @@ public:
   CompileCommand createCompileCommand(const QStringList &files,
                                       const QString &outname) const;
 
+  /// Returns the per-user cache directory used by the GUI.
+  static QString defaultCacheDirectory();
+
+  /// Sets the directory in which compiled executables are cached. An empty
+  /// directory disables caching.
+  void setCacheDirectory(const QString &directory) { m_cacheDir = directory; }
+  const QString &cacheDirectory() const { return m_cacheDir; }
+
 signals:
   /**
    * @brief ccChanged
@@ -103,8 +121,34 @@ private:
    */
   CCRes verifyCC(const QString &CC);
 
+  /// Writes @p rawsource to a temporary file. @returns the files to compile
+  /// for the source.
+  QStringList writeSourceFiles(const QString &rawsource);
+
+  /// Runs the compiler on @p files, bypassing the cache. If @p includes is
+  /// set, it receives the headers included by @p files.
+  CCRes runCompiler(const QStringList &files, QString outname,
+                    bool showProgressdiag, QStringList *includes = nullptr);
+
+  /// Returns the arguments passed to the compiler ahead of the input files.
+  QStringList compilerArguments() const;
+
+  /// Returns the cache key for compiling @p files with the current compiler
+  /// and arguments, or an empty string if the result cannot be cached.
+  QString cacheKey(const QStringList &files) const;
+  /// Writes the cached executable for @p key to the output file of @p res, if
+  /// the headers it was compiled with are unchanged. @returns true on a cache
+  /// hit.
+  bool loadCached(const QString &key, CCRes &res) const;
+  /// Stores @p outFile for @p key, compiled with the headers @p includes.
+  void storeCached(const QString &key, const QString &outFile,
+                   const QStringList &includes) const;
+
   CCManager();
   QString m_currentCC;
+  QString m_cacheDir;
+  // Error output of the latest compilation.
+  QString m_lastError;
 #ifdef RIPES_WITH_QPROCESS
   QProcess m_process;
 #endif
@@ -1,4 +1,6 @@
 #include "clioptions.h"
+#include "binutils.h"
+#include "processorhandler.h"
 #include "processorregistry.h"
 #include "radix.h"
 #include "ripessettings.h"
@@ -25,7 +27,17 @@ static const std::map<QString, WriteAllocPolicy> s_writeAllocTokens{
     {"writeallocate", WriteAllocPolicy::WriteAllocate},
     {"nowriteallocate", WriteAllocPolicy::NoWriteAllocate}};
 static const std::map<QString, ReplPolicy> s_replPolicyTokens{
-    {"lru", ReplPolicy::LRU}, {"random", ReplPolicy::Random}};
+    {"lru", ReplPolicy::LRU},     {"random", ReplPolicy::Random},
+    {"fifo", ReplPolicy::FIFO},   {"plru", ReplPolicy::PLRU},
+    {"srrip", ReplPolicy::SRRIP}, {"brrip", ReplPolicy::BRRIP},
+    {"lfu", ReplPolicy::LFU}};
+static const std::map<QString, PrefetchPolicy> s_prefetchPolicyTokens{
+    {"none", PrefetchPolicy::NoPrefetch},
+    {"nextline", PrefetchPolicy::NextLinePrefetch},
+    {"stride", PrefetchPolicy::StridePrefetch}};
+
+// Tree-PLRU state of a cache line is held in a 64-bit word.
+static constexpr int c_maxPLRUWays = 64;
 
 template <typename T>
 static QString tokenKeys(const std::map<QString, T> &m) {
@@ -43,11 +55,15 @@ static QList<CachePreset> availableCachePresets() {
 }
 
 // Parses a single cache spec (blocks/lines/ways + policies) from a JSON object.
-// The three geometry fields are required; the three policy fields are optional
-// and default to a write-back/write-allocate/LRU cache. Returns false and sets
-// 'errorMessage' on any error.
+// The three geometry fields are required, although the line size may be given
+// in bytes ("lineBytes") instead of words ("blocks"). The word size defaults
+// to the register width of the ISA ('isaBytes'). The policy fields are
+// optional and default to a write-back/write-allocate/LRU cache without
+// prefetching. The latency fields are optional and default to a timing without
+// memory stalls. Returns false and sets 'errorMessage' on any error.
 static bool parseCacheSpec(const QString &cacheName, const QJsonObject &obj,
-                           CachePreset &out, QString &errorMessage) {
+                           unsigned isaBytes, CachePreset &out,
+                           QString &errorMessage) {
   const auto requireInt = [&](const QString &key, int &dst) -> bool {
     if (!obj.contains(key) || !obj.value(key).isDouble()) {
       errorMessage = "Cache spec '" + cacheName +
@@ -60,14 +76,48 @@ static bool parseCacheSpec(const QString &cacheName, const QJsonObject &obj,
     return true;
   };
 
-  if (!requireInt("blocks", out.blocks) || !requireInt("lines", out.lines) ||
-      !requireInt("ways", out.ways))
+  const auto requirePow2 = [&](const QString &key, int value) -> bool {
+    if (value <= 0 || !isPowerOf2(value)) {
+      errorMessage = "Cache spec '" + cacheName + "' has invalid '" + key +
+                     "' value " + QString::number(value) +
+                     "; must be a power of two (--cache-config).";
+      return false;
+    }
+    return true;
+  };
+
+  out.wordBytes = 0;
+  unsigned wordBytes = isaBytes;
+  if (obj.contains("wordBytes")) {
+    int value = 0;
+    if (!requireInt("wordBytes", value) || !requirePow2("wordBytes", value))
+      return false;
+    out.wordBytes = wordBytes = value;
+  }
+
+  if (!requireInt("lines", out.lines) || !requireInt("ways", out.ways))
     return false;
+  if (obj.contains("lineBytes")) {
+    int lineBytes = 0;
+    if (!requireInt("lineBytes", lineBytes) ||
+        !requirePow2("lineBytes", lineBytes))
+      return false;
+    if (static_cast<unsigned>(lineBytes) < wordBytes) {
+      errorMessage = "Cache spec '" + cacheName +
+                     "' has a line size smaller than its word size of " +
+                     QString::number(wordBytes) + " bytes (--cache-config).";
+      return false;
+    }
+    out.blocks = log2Ceil(lineBytes / wordBytes);
+  } else if (!requireInt("blocks", out.blocks)) {
+    return false;
+  }
 
   // Optional policy fields (defaults match the direct-mapped preset).
   out.wrPolicy = WritePolicy::WriteBack;
   out.wrAllocPolicy = WriteAllocPolicy::WriteAllocate;
   out.replPolicy = ReplPolicy::LRU;
+  out.prefetchPolicy = PrefetchPolicy::NoPrefetch;
 
   const auto parsePolicy = [&](const QString &key, const auto &tokens,
                                auto &dst) -> bool {
@@ -89,13 +139,83 @@ static bool parseCacheSpec(const QString &cacheName, const QJsonObject &obj,
   if (!parsePolicy("writePolicy", s_writePolicyTokens, out.wrPolicy) ||
       !parsePolicy("writeAllocatePolicy", s_writeAllocTokens,
                    out.wrAllocPolicy) ||
-      !parsePolicy("replacementPolicy", s_replPolicyTokens, out.replPolicy))
+      !parsePolicy("replacementPolicy", s_replPolicyTokens, out.replPolicy) ||
+      !parsePolicy("prefetchPolicy", s_prefetchPolicyTokens,
+                   out.prefetchPolicy))
+    return false;
+
+  if (out.replPolicy == ReplPolicy::PLRU && out.ways > c_maxPLRUWays) {
+    errorMessage = "Cache spec '" + cacheName +
+                   "': replacement policy 'plru' supports at most " +
+                   QString::number(c_maxPLRUWays) + " ways (--cache-config).";
+    return false;
+  }
+
+  out.timing = CacheTiming();
+  const auto parseLatency = [&](const QString &key, unsigned &dst) -> bool {
+    if (!obj.contains(key))
+      return true; // optional
+    if (!obj.value(key).isDouble() || obj.value(key).toInt(-1) < 0) {
+      errorMessage = "Cache spec '" + cacheName + "' has invalid '" + key +
+                     "' value; expected a non-negative integer number of "
+                     "cycles (--cache-config).";
+      return false;
+    }
+    dst = static_cast<unsigned>(obj.value(key).toInt());
+    return true;
+  };
+  if (!parseLatency("hitLatency", out.timing.hitLatency) ||
+      !parseLatency("missLatency", out.timing.missLatency) ||
+      !parseLatency("writebackLatency", out.timing.writebackLatency))
     return false;
 
   out.name = cacheName;
   return true;
 }
 
+QString peripheralToken(const QString &name) {
+  QString token;
+  for (const QChar &c : name)
+    if (c.isLetterOrNumber())
+      token += c.toLower();
+  return token;
+}
+
+// Parses a single peripheral spec of the form 'type[:key=value]*'. Returns
+// false and sets 'errorMessage' on any error.
+static bool parsePeripheralSpec(const QString &specStr, PeripheralSpec &out,
+                                QString &errorMessage) {
+  const QStringList parts = specStr.split(':');
+  const QString typeToken = parts.at(0).trimmed().toLower();
+  const auto it = std::find_if(
+      IOTypeTitles.begin(), IOTypeTitles.end(),
+      [&](const auto &t) { return peripheralToken(t.second) == typeToken; });
+  if (it == IOTypeTitles.end()) {
+    QStringList types;
+    for (const auto &t : IOTypeTitles)
+      types.push_back(peripheralToken(t.second));
+    errorMessage = "Unknown peripheral '" + typeToken +
+                   "' (--peripherals). Available peripherals: " +
+                   types.join(", ") + ".";
+    return false;
+  }
+  out.type = it->first;
+
+  for (int i = 1; i < parts.size(); ++i) {
+    const QStringList kv = parts.at(i).split('=');
+    bool ok = kv.size() == 2;
+    const int value = ok ? kv.at(1).toInt(&ok) : 0;
+    if (!ok) {
+      errorMessage = "Invalid peripheral parameter '" + parts.at(i) +
+                     "' for '" + typeToken +
+                     "'; expected key=integer (--peripherals).";
+      return false;
+    }
+    out.parameters.push_back({peripheralToken(kv.at(0)), value});
+  }
+  return true;
+}
+
 void addCLIOptions(QCommandLineParser &parser, Ripes::CLIModeOptions &options) {
   parser.addOption(QCommandLineOption("src", "Path to source file.", "path"));
   parser.addOption(QCommandLineOption(
@@ -125,11 +245,53 @@ void addCLIOptions(QCommandLineParser &parser, Ripes::CLIModeOptions &options) {
       "Simulation timeout in milliseconds. If simulation does not finish "
       "within the specified time, it will be aborted.",
       "ms", "0"));
+  parser.addOption(QCommandLineOption(
+      "virtual-time",
+      "Derive the time observed by the program (RTC peripheral, time system "
+      "calls) from the processor cycle count at the given core frequency (at "
+      "most " +
+          QString::number(ProcessorHandler::s_maxVirtualTimeFreq) +
+          " Hz), rather than from the host wall-clock. Makes the results of "
+          "timing-dependent programs reproducible.",
+      "Hz"));
   parser.addOption(QCommandLineOption("v", "Verbose output"));
   parser.addOption(QCommandLineOption(
       "output", "Report output file. If not set, report is printed to stdout.",
       "path"));
   parser.addOption(QCommandLineOption("json", "JSON-formatted report."));
+  parser.addOption(QCommandLineOption(
+      "result-cache",
+      "Cache run results in the given directory. Results are keyed by the "
+      "program and run configuration (processor, ISA extensions, register "
+      "initialization, caches, peripherals, time base) and the Ripes "
+      "version; a repeated run is reported from the cache without "
+      "simulating; the program output (stdout) of the run is replayed. Runs "
+      "reading stdin, opening files or reading the wall-clock time are not "
+      "cached.",
+      "dir"));
+  parser.addOption(QCommandLineOption(
+      "program-cache",
+      "Cache assembled programs in the given directory. Programs are keyed by "
+      "the source, ISA, extensions, segment addresses and the Ripes version; "
+      "an unchanged assembly source is loaded without reassembling.",
+      "dir"));
+  parser.addOption(QCommandLineOption(
+      "compile-cache",
+      "Cache compiled C programs in the given directory. Executables are "
+      "keyed by the source, the headers it includes, compiler and compiler "
+      "arguments; an unchanged C source is loaded without recompiling.",
+      "dir"));
+  parser.addOption(QCommandLineOption(
+      "stdout-buffer",
+      "Size of the buffer used for program output to stdout. 0 disables "
+      "buffering.",
+      "bytes", "65536"));
+  parser.addOption(QCommandLineOption(
+      "stdout-flush",
+      "When to flush buffered program output. Options: [line, full]. 'line' "
+      "flushes on every newline, 'full' only when the buffer is full, before "
+      "reading from stdin and when the program finishes.",
+      "mode", "line"));
 
   parser.addOption(QCommandLineOption("all", "Enable all report options."));
 
@@ -139,8 +301,11 @@ void addCLIOptions(QCommandLineParser &parser, Ripes::CLIModeOptions &options) {
   options.telemetry.push_back(std::make_shared<CPITelemetry>());
   options.telemetry.push_back(std::make_shared<IPCTelemetry>());
   options.telemetry.push_back(std::make_shared<PipelineTelemetry>());
+  options.telemetry.push_back(std::make_shared<HazardTelemetry>());
+  options.telemetry.push_back(std::make_shared<StageStatsTelemetry>());
   options.telemetry.push_back(std::make_shared<RegisterTelemetry>());
   options.telemetry.push_back(std::make_shared<ExecutionTimeTelemetry>());
+  options.telemetry.push_back(std::make_shared<ScreenHashTelemetry>());
   options.telemetry.push_back(std::make_shared<RunInfoTelemetry>(&parser));
 
   for (auto &telemetry : options.telemetry) {
@@ -164,12 +329,45 @@ void addCLIOptions(QCommandLineParser &parser, Ripes::CLIModeOptions &options) {
       "cache-config",
       "Enable L1 cache simulation from a JSON spec file. The document may "
       "contain \"L1I\" and/or \"L1D\" objects; each object requires integer "
-      "fields \"blocks\", \"lines\" and \"ways\" and optionally "
-      "\"writePolicy\" (writeback|writethrough), \"writeAllocatePolicy\" "
-      "(writeallocate|nowriteallocate) and \"replacementPolicy\" (lru|random). "
-      "A cache is simulated only if its object is present.",
+      "fields \"blocks\" (log2 of words per line; alternatively "
+      "\"lineBytes\", the line size in bytes), \"lines\" (log2 of sets) and "
+      "\"ways\" and optionally \"wordBytes\" (defaults to the register "
+      "width), \"writePolicy\" (writeback|writethrough), "
+      "\"writeAllocatePolicy\" (writeallocate|nowriteallocate), "
+      "\"replacementPolicy\" "
+      "(lru|random|fifo|plru|srrip|brrip|lfu) and \"prefetchPolicy\" "
+      "(none|nextline|stride). Optional integer fields \"hitLatency\", "
+      "\"missLatency\" and \"writebackLatency\" (cycles) enable the "
+      "estimation of memory stall cycles and the effective CPI. A cache is "
+      "simulated only if its object is present.",
       "path"));
   options.telemetry.push_back(std::make_shared<CacheTelemetry>());
+
+  QStringList peripheralTypes;
+  for (const auto &t : IOTypeTitles)
+    peripheralTypes.push_back(peripheralToken(t.second));
+  parser.addOption(QCommandLineOption(
+      "peripherals",
+      "Comma-separated list of memory-mapped peripherals to attach (headless) "
+      "to the address space, in the given order. Peripheral parameters may be "
+      "set as colon-separated key=value pairs, where the key is the parameter "
+      "name in lower case without spaces or punctuation. Example: "
+      "screen:width=320:height=240,switches. Options: [" +
+          peripheralTypes.join(", ") + "]",
+      "peripherals"));
+  parser.addOption(QCommandLineOption(
+      "screen-dump",
+      "Dump the frames presented by screen peripherals to a file, as raw "
+      "little-endian 32-bit 0x00RRGGBB pixels, row-major, frames back to "
+      "back. If multiple screens are attached, the frames of the n'th screen "
+      "(n > 0) are written to '<path>.<n>'. Requires a screen peripheral "
+      "(--peripherals).",
+      "path"));
+  parser.addOption(QCommandLineOption(
+      "screen-dump-every",
+      "Only dump every N'th presented frame (starting with the first) "
+      "(--screen-dump).",
+      "N", "1"));
 }
 
 bool parseCLIOptions(QCommandLineParser &parser, QString &errorMessage,
@@ -245,7 +443,45 @@ bool parseCLIOptions(QCommandLineParser &parser, QString &errorMessage,
     }
   }
 
+  if (parser.isSet("virtual-time")) {
+    bool ok;
+    options.virtualTimeFreq = parser.value("virtual-time").toULongLong(&ok);
+    if (!ok || options.virtualTimeFreq == 0 ||
+        options.virtualTimeFreq > ProcessorHandler::s_maxVirtualTimeFreq) {
+      errorMessage =
+          "Invalid virtual time frequency '" + parser.value("virtual-time") +
+          "'; must be in the range [1; " +
+          QString::number(ProcessorHandler::s_maxVirtualTimeFreq) +
+          "] Hz (--virtual-time).";
+      return false;
+    }
+  }
+
   options.outputFile = parser.value("output");
+  options.resultCacheDir = parser.value("result-cache");
+  options.programCacheDir = parser.value("program-cache");
+  options.compileCacheDir = parser.value("compile-cache");
+
+  if (parser.isSet("stdout-buffer")) {
+    bool ok;
+    options.stdoutBufferSize = parser.value("stdout-buffer").toUInt(&ok);
+    if (!ok) {
+      errorMessage = "Invalid buffer size specified (--stdout-buffer).";
+      return false;
+    }
+  }
+
+  if (parser.isSet("stdout-flush")) {
+    const QString mode = parser.value("stdout-flush");
+    if (mode == "line") {
+      options.stdoutFlushMode = BufferedStdoutSink::FlushMode::Line;
+    } else if (mode == "full") {
+      options.stdoutFlushMode = BufferedStdoutSink::FlushMode::Full;
+    } else {
+      errorMessage = "Invalid flush mode '" + mode + "' (--stdout-flush).";
+      return false;
+    }
+  }
 
   // Configure L1 cache simulation from either a named preset or a JSON spec.
   if (parser.isSet("cache-preset") && parser.isSet("cache-config")) {
@@ -293,22 +529,47 @@ bool parseCLIOptions(QCommandLineParser &parser, QString &errorMessage,
                      "\"L1I\" or \"L1D\" (--cache-config).";
       return false;
     }
+    const unsigned isaBytes = ProcessorRegistry::getAvailableProcessors()
+                                  .at(options.proc)
+                                  ->isaInfo()
+                                  .isa->bytes();
     if (root.contains("L1I")) {
       CachePreset spec;
-      if (!parseCacheSpec("L1I", root.value("L1I").toObject(), spec,
+      if (!parseCacheSpec("L1I", root.value("L1I").toObject(), isaBytes, spec,
                           errorMessage))
         return false;
       options.l1iCache = spec;
     }
     if (root.contains("L1D")) {
       CachePreset spec;
-      if (!parseCacheSpec("L1D", root.value("L1D").toObject(), spec,
+      if (!parseCacheSpec("L1D", root.value("L1D").toObject(), isaBytes, spec,
                           errorMessage))
         return false;
       options.l1dCache = spec;
     }
   }
 
+  if (parser.isSet("peripherals")) {
+    for (const auto &specStr : parser.value("peripherals").split(',')) {
+      PeripheralSpec spec;
+      if (!parsePeripheralSpec(specStr, spec, errorMessage))
+        return false;
+      options.peripherals.push_back(spec);
+    }
+  }
+
+  if (parser.isSet("screen-dump")) {
+    options.screenDumpPath = parser.value("screen-dump");
+    const int every = parser.value("screen-dump-every").toInt(&ok);
+    if (!ok || every < 1) {
+      errorMessage = "Invalid frame interval '" +
+                     parser.value("screen-dump-every") +
+                     "'; must be a positive integer (--screen-dump-every).";
+      return false;
+    }
+    options.screenDumpEvery = every;
+  }
+
   // Validate register initializations
   if (parser.isSet("reginit")) {
     const auto &procisa =
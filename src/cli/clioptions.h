@@ -2,7 +2,9 @@
 
 #include "assembler/program.h"
 #include "cachesim/cachesim.h"
+#include "io/ioregistry.h"
 #include "processorregistry.h"
+#include "stdoutsink.h"
 #include "telemetry.h"
 #include <QCommandLineParser>
 #include <optional>
@@ -10,6 +12,14 @@
 
 namespace Ripes {
 
+/// A peripheral to attach to the address space in CLI mode, as specified by
+/// the --peripherals option.
+struct PeripheralSpec {
+  IOType type;
+  // (parameter key, value) pairs; see peripheralToken().
+  std::vector<std::pair<QString, int>> parameters;
+};
+
 struct CLIModeOptions {
   QString src;
   SourceType srcType;
@@ -19,8 +29,16 @@ struct CLIModeOptions {
   QString outputFile = "";
   bool jsonOutput = false;
   int timeout = 0;
+  // Virtual time frequency (Hz); 0 selects wall-clock time.
+  uint64_t virtualTimeFreq = 0;
   RegisterInitialization regInit;
 
+  // Buffering of program output (print/write syscalls) to stdout. A buffer
+  // size of 0 disables buffering.
+  size_t stdoutBufferSize = 64 * 1024;
+  BufferedStdoutSink::FlushMode stdoutFlushMode =
+      BufferedStdoutSink::FlushMode::Line;
+
   // Optional L1 instruction/data cache configurations. When set, the
   // corresponding cache is simulated during the run (mirroring the GUI cache
   // tab) so cache behaviour/overhead can be exercised and reported headlessly.
@@ -29,10 +47,34 @@ struct CLIModeOptions {
   std::optional<CachePreset> l1iCache;
   std::optional<CachePreset> l1dCache;
 
+  // Peripherals to instantiate (headless) before the program is loaded.
+  std::vector<PeripheralSpec> peripherals;
+
+  // If set, frames presented by screen peripherals are dumped to this file
+  // (every screenDumpEvery'th frame), rather than rendered.
+  QString screenDumpPath;
+  unsigned screenDumpEvery = 1;
+
+  // If set, run results are cached in (and served from) this directory.
+  QString resultCacheDir;
+
+  // If set, assembled programs are cached in (and served from) this
+  // directory.
+  QString programCacheDir;
+
+  // If set, compiled C programs are cached in (and served from) this
+  // directory.
+  QString compileCacheDir;
+
   // A list of enabled telemetry options.
   std::vector<std::shared_ptr<Telemetry>> telemetry;
 };
 
+/// Returns the CLI token for a peripheral type title or parameter name: the
+/// name in lower case, with all non-alphanumeric characters removed (e.g.
+/// "LED Matrix" -> "ledmatrix").
+QString peripheralToken(const QString &name);
+
 /// Adds Ripes CLI options to a parser.
 void addCLIOptions(QCommandLineParser &parser, Ripes::CLIModeOptions &options);
 
@@ -1,19 +1,29 @@
 #include "clirunner.h"
+#include "assembler/programcache.h"
 #include "cachesim/cachesim.h"
 #include "cachesim/l1cacheshim.h"
 #include "ccmanager.h"
 #include "io/iomanager.h"
+#include "io/ioscreen.h"
 #include "loaddialog.h"
 #include "processorhandler.h"
 #include "programutilities.h"
+#include "resultcache.h"
 #include "syscall/systemio.h"
 #include "telemetry.h"
 
+#include <QElapsedTimer>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QTime>
+
+#include <functional>
 
 namespace Ripes {
 
+// Runs producing more output than this are not stored in the result cache.
+static constexpr qsizetype c_maxCachedOutputSize = 16 * 1024 * 1024;
+
 /**
  * An extended QVariant-to-string convertion method which handles a special
  * cases such as QVariantMap and QStringList.
@@ -55,23 +65,37 @@ CLIRunner::CLIRunner(const CLIModeOptions &options)
   info("Ripes CLI mode", false, true);
   ProcessorHandler::selectProcessor(m_options.proc, m_options.isaExtensions,
                                     m_options.regInit);
+  // The time base is selected per run, rather than taken from the settings.
+  ProcessorHandler::setVirtualTimeFrequency(m_options.virtualTimeFreq);
+
+  // Per-stage pipeline statistics are gathered by the processor itself, but
+  // only when requested, since they require a per-cycle stage inspection.
+  for (auto &telemetry : m_options.telemetry)
+    if (telemetry->isEnabled() &&
+        dynamic_cast<PipelineStatsTelemetry *>(telemetry.get()))
+      ProcessorHandler::getProcessorNonConst()->setPipelineStatsEnabled(true);
 
   // Optionally instantiate cache simulation so its behaviour/overhead is
   // exercised during the headless run.
   if (m_options.l1iCache || m_options.l1dCache)
     setupCaches();
 
-  // Connect systemIO output to stdout.
-  connect(&SystemIO::get(), &SystemIO::doPrint, this, [&](auto text) {
-    std::cout << text.toStdString();
-    std::flush(std::cout);
-  });
+  // Route systemIO output to stdout through a buffered, byte-oriented sink.
+  m_stdoutSink = std::make_unique<BufferedStdoutSink>(
+      m_options.stdoutBufferSize, m_options.stdoutFlushMode);
+  SystemIO::setOutputSink(m_stdoutSink.get());
 
   // Handle systemIO input in stdin
   SystemIO::setCLIInput();
 }
 
-CLIRunner::~CLIRunner() = default;
+CLIRunner::~CLIRunner() {
+  // Peripherals unregister themselves from the IOManager upon deletion.
+  m_peripherals.clear();
+
+  // Detach the sink before it is destroyed (flushing any remaining output).
+  SystemIO::setOutputSink(nullptr);
+}
 
 /**
  * Instantiates the requested L1 instruction- and/or data-cache simulators and
@@ -112,27 +136,211 @@ void CLIRunner::setupCaches() {
       ct->setCaches(m_l1iCache, m_l1dCache);
 }
 
+/**
+ * Instantiates the peripherals requested through --peripherals. Peripherals
+ * are created through the IOManager (as in the GUI I/O tab), which maps them
+ * into the processor address space and exports their symbols, but without any
+ * accompanying widget. Peripheral parameters are applied in the order given.
+ *
+ * @return 0 on success, or 1 if an invalid peripheral parameter was specified.
+ */
+int CLIRunner::setupPeripherals() {
+  for (const auto &spec : m_options.peripherals) {
+    std::unique_ptr<IOBase> peripheral(
+        IOManager::get().createPeripheral(spec.type));
+
+    for (const auto &[key, value] : spec.parameters) {
+      const auto &params = peripheral->parameters();
+      const auto it = std::find_if(params.begin(), params.end(), [&](auto &p) {
+        return peripheralToken(p.second.name) == key;
+      });
+      if (it == params.end()) {
+        QStringList keys;
+        for (const auto &p : params)
+          keys.push_back(peripheralToken(p.second.name));
+        error("Peripheral '" + peripheral->name() + "' has no parameter '" +
+              key + "'. Parameters: [" + keys.join(", ") + "]");
+        return 1;
+      }
+      const IOParam &param = it->second;
+      if (param.hasRange &&
+          (value < param.min.toInt() || value > param.max.toInt())) {
+        error("Parameter '" + key + "' of peripheral '" + peripheral->name() +
+              "' must be in the range [" + param.min.toString() + "; " +
+              param.max.toString() + "]");
+        return 1;
+      }
+      peripheral->setParameter(it->first, value);
+    }
+
+    info("Attached peripheral '" + peripheral->name() + "'");
+    for (const auto &symbol :
+         IOManager::get().assemblerSymbolsForPeriph(peripheral.get()))
+      info("  " + symbol.first.v + " = 0x" +
+           QString::number(symbol.second, 16));
+    m_peripherals.push_back(std::move(peripheral));
+  }
+  return 0;
+}
+
+/**
+ * Attaches frame sinks to the screen peripherals. With sinks attached, the
+ * screens pass presented frames directly to the sinks, rather than converting
+ * them into an image for display.
+ *
+ * @return 0 on success, or 1 if a frame dump file could not be opened, or if
+ * frames are to be dumped without any screen peripheral attached.
+ */
+int CLIRunner::setupScreenSinks() {
+  ScreenHashTelemetry *hashTelemetry = nullptr;
+  for (auto &telemetry : m_options.telemetry)
+    if (auto *t = dynamic_cast<ScreenHashTelemetry *>(telemetry.get());
+        t && t->isEnabled())
+      hashTelemetry = t;
+
+  unsigned screenIdx = 0;
+  for (const auto &peripheral : m_peripherals) {
+    auto *screen = dynamic_cast<IOScreen *>(peripheral.get());
+    if (!screen)
+      continue;
+
+    if (!m_options.screenDumpPath.isEmpty()) {
+      QString path = m_options.screenDumpPath;
+      if (screenIdx > 0)
+        path += "." + QString::number(screenIdx);
+      auto sink = std::make_shared<ScreenFrameDumpSink>(
+          path, m_options.screenDumpEvery);
+      if (!sink->isOpen()) {
+        error("Could not open frame dump file '" + path +
+              "': " + sink->errorString());
+        return 1;
+      }
+      info("Dumping frames of '" + screen->name() + "' to '" + path + "'");
+      screen->addFrameSink(sink);
+    }
+
+    if (hashTelemetry) {
+      auto sink = std::make_shared<ScreenFrameHashSink>();
+      screen->addFrameSink(sink);
+      hashTelemetry->addScreen(screen->name(), sink);
+    }
+    screenIdx++;
+  }
+
+  if (!m_options.screenDumpPath.isEmpty() && screenIdx == 0) {
+    error("No screen peripheral to dump frames of (--screen-dump); attach one "
+          "through --peripherals");
+    return 1;
+  }
+  return 0;
+}
+
 /**
  * Main execution method for the CLI runner.
- * Runs the CLI process in three phases: process input, run model, and post-run.
+ * Runs the CLI process in three phases: process input, run model, and post-run,
+ * preceded by the setup of any requested peripherals.
  * Checks after each phase that the execution was successful, and returns 1 if
  * an error occurs during any phase.
+ * If a result cache is used and holds the results of an identical run, the
+ * model is not run; the cached program output is replayed and the cached
+ * results are reported instead.
  *
  * @return 0 on success, or 1 if an error occurs during any phase.
  */
 int CLIRunner::run() {
+  if (setupPeripherals())
+    return 1;
+
+  if (setupScreenSinks())
+    return 1;
+
   if (processInput())
     return 1;
 
-  if (runModel())
+  std::unique_ptr<ResultCache> resultCache;
+  QString resultKey;
+  const auto program = ProcessorHandler::getProgram();
+  if (!m_options.resultCacheDir.isEmpty() && program) {
+    if (!m_options.screenDumpPath.isEmpty()) {
+      // Frame dumps are a side effect of simulating; always run.
+      info("Result cache not used, since frames are dumped (--screen-dump)");
+    } else {
+      resultCache = std::make_unique<ResultCache>(m_options.resultCacheDir);
+      resultKey = ResultCache::key(*program, m_options);
+      if (const auto cached =
+              resultCache->lookup(resultKey, cacheableTelemetryKeys())) {
+        info("Reporting cached results (" + resultKey + ")");
+        m_stdoutSink->write(cached->output.constData(), cached->output.size());
+        m_stdoutSink->flush();
+        return postRun(&cached->reports);
+      }
+    }
+  }
+
+  // Record the program output while running, for replaying it from the cache.
+  std::unique_ptr<RecordingSink> recordingSink;
+  if (resultCache) {
+    recordingSink =
+        std::make_unique<RecordingSink>(*m_stdoutSink, c_maxCachedOutputSize);
+    SystemIO::setOutputSink(recordingSink.get());
+  }
+
+  const bool runFailed = runModel();
+  if (recordingSink)
+    SystemIO::setOutputSink(m_stdoutSink.get());
+  if (runFailed)
     return 1;
 
+  if (resultCache) {
+    if (ProcessorHandler::hostInputObserved())
+      info("Results not cached, since the program read stdin or the "
+           "wall-clock time");
+    else if (ProcessorHandler::hostFilesAccessed())
+      info("Results not cached, since the program opened host files");
+    else if (!recordingSink->complete())
+      info("Results not cached, since the program output is too large");
+    else if (!resultCache->store(resultKey, {collectReports(),
+                                             recordingSink->recording()}))
+      info("Failed to write result cache entry to '" +
+               m_options.resultCacheDir + "'",
+           true, false, "WARNING");
+  }
+
   if (postRun())
     return 1;
 
   return 0;
 }
 
+QStringList CLIRunner::cacheableTelemetryKeys() const {
+  QStringList keys;
+  for (const auto &telemetry : m_options.telemetry)
+    if (telemetry->isEnabled() && telemetry->cacheable())
+      keys.push_back(telemetry->key());
+  return keys;
+}
+
+QJsonObject CLIRunner::collectReports() {
+  QJsonObject reports;
+  for (auto &telemetry : m_options.telemetry) {
+    if (!telemetry->isEnabled() || !telemetry->cacheable())
+      continue;
+    QString text;
+    QTextStream out(&text);
+    if (!telemetry->writeReport(out)) {
+      QVariant reportedValue = telemetry->report(/*json=*/false);
+      out << qVariantToString(reportedValue);
+    }
+    out.flush();
+
+    QJsonObject report;
+    report["json"] = QJsonValue::fromVariant(telemetry->report(/*json=*/true));
+    report["text"] = text;
+    reports[telemetry->key()] = report;
+  }
+  return reports;
+}
+
 /**
  * Processes the input file based on the file source type in the provided CLI
  * options. The method prepares the program for the execution by assembling,
@@ -151,8 +359,14 @@ int CLIRunner::processInput() {
       error("Failed to open input file");
       return 1;
     }
-    auto res = ProcessorHandler::getAssembler()->assembleRaw(
-        inputFile.readAll(), &IOManager::get().assemblerSymbols());
+    const QString source = inputFile.readAll();
+    const auto *symbols = &IOManager::get().assemblerSymbols();
+    auto res =
+        m_options.programCacheDir.isEmpty()
+            ? ProcessorHandler::getAssembler()->assembleRaw(source, symbols)
+            : Assembler::ProgramCache(m_options.programCacheDir)
+                  .assemble(source, *ProcessorHandler::getAssembler(),
+                            *ProcessorHandler::currentISA(), symbols);
     if (res.errors.size() == 0)
       ProcessorHandler::loadProgram(std::make_shared<Program>(res.program));
     else {
@@ -215,6 +429,7 @@ int CLIRunner::processInput() {
     }
     QString fileContent = file.readAll();
     file.close();
+    CCManager::get().setCacheDirectory(m_options.compileCacheDir);
     auto res = CCManager::get().compileRaw(fileContent, QString(),
                                            /* enableGUI = */ false);
     if (res.success) {
@@ -237,53 +452,38 @@ int CLIRunner::processInput() {
 
 /**
  * Runs the processor model for the loaded program until the program is
- * finished (so ProcessorHandler::runFinished signal is emitted)
+ * finished, or the timeout elapses. The model is run on the calling thread, so
+ * no event loop is required.
  *
  * @return 0 on success, or 1 if an error occurs during model execution.
  */
 int CLIRunner::runModel() {
   info("Running model", false, true);
 
-  QEventLoop loop;
-  QObject::connect(ProcessorHandler::get(), &ProcessorHandler::runFinished,
-                   &loop, &QEventLoop::quit);
-  bool hadTimeout = false;
-  QTimer timeoutTimer;
-  timeoutTimer.setSingleShot(true);
-  QObject::connect(&timeoutTimer, &QTimer::timeout, &loop, &QEventLoop::quit);
-  QObject::connect(&timeoutTimer, &QTimer::timeout, &loop,
-                   [&]() { hadTimeout = true; });
-
   // Display status info every second when verbose output is enabled.
-  QTimer infoTimer;
   QElapsedTimer elapsed;
   elapsed.start();
-  infoTimer.connect(&infoTimer, &QTimer::timeout, this, [&]() {
-    QTime timeFormat(0, 0);
-    QString infostr =
-        timeFormat.addMSecs(elapsed.elapsed()).toString("hh:mm:ss");
-    const auto cycleCount = ProcessorHandler::getProcessor()->getCycleCount();
-    const auto instrsRetired =
-        ProcessorHandler::getProcessor()->getInstructionsRetired();
-    infostr += "\tcycles: " + QString::number(cycleCount);
-    infostr += "\tretired: " + QString::number(instrsRetired);
-    info(infostr, false, false);
-  });
-
-  if (m_options.verbose)
-    infoTimer.start(1000);
-
-  // Start simulation
-  ProcessorHandler::run();
-  if (m_options.timeout != 0)
-    timeoutTimer.start(m_options.timeout);
-  loop.exec();
-
-  // Event loop finished either by processor finishing or timeout. Determine the
-  // cause and act.
-
-  timeoutTimer.stop();
-  infoTimer.stop();
+  std::function<void()> progress;
+  if (m_options.verbose) {
+    progress = [&]() {
+      QTime timeFormat(0, 0);
+      QString infostr =
+          timeFormat.addMSecs(elapsed.elapsed()).toString("hh:mm:ss");
+      const auto cycleCount =
+          ProcessorHandler::getProcessor()->getCycleCount();
+      const auto instrsRetired =
+          ProcessorHandler::getProcessor()->getInstructionsRetired();
+      infostr += "\tcycles: " + QString::number(cycleCount);
+      infostr += "\tretired: " + QString::number(instrsRetired);
+      info(infostr, false, false);
+    };
+  }
+
+  const bool hadTimeout =
+      !ProcessorHandler::runBlocking(m_options.timeout, progress);
+
+  // Make all program output visible before any further reporting.
+  SystemIO::flushOutput();
 
   // Record the wall-clock execution time for the ExecutionTimeTelemetry.
   const qint64 elapsedMs = elapsed.elapsed();
@@ -292,7 +492,6 @@ int CLIRunner::runModel() {
       et->setElapsedMs(elapsedMs);
 
   if (hadTimeout) {
-    ProcessorHandler::stopRun();
     error("Simulation did not finish within the specified timeout (" +
           QString::number(m_options.timeout) + " ms)");
     return 1;
@@ -308,7 +507,7 @@ int CLIRunner::runModel() {
  *
  * @return 0 on success, or 1 if an error occurs during post run tasks.
  */
-int CLIRunner::postRun() {
+int CLIRunner::postRun(const QJsonObject *cachedReports) {
   info("Post-run", false, true);
 
   // Open output stream
@@ -329,19 +528,35 @@ int CLIRunner::postRun() {
   if (m_options.jsonOutput) {
     // Telemetry output
     QJsonObject jsonOutput;
-    for (auto &telemetry : m_options.telemetry)
-      if (telemetry->isEnabled())
+    for (auto &telemetry : m_options.telemetry) {
+      if (!telemetry->isEnabled())
+        continue;
+      if (cachedReports && telemetry->cacheable())
+        jsonOutput.insert(telemetry->prettyKey(),
+                          cachedReports->value(telemetry->key())
+                              .toObject()
+                              .value("json"));
+      else
         jsonOutput.insert(
             telemetry->prettyKey(),
             QJsonValue::fromVariant(telemetry->report(/*json=*/true)));
+    }
     *stream << QJsonDocument(jsonOutput).toJson(QJsonDocument::Indented);
   } else {
     // Telemetry output
     for (auto &telemetry : m_options.telemetry)
       if (telemetry->isEnabled()) {
         *stream << "===== " << telemetry->description() << "\n";
-        QVariant reportedValue = telemetry->report(/*json=*/false);
-        *stream << qVariantToString(reportedValue) << "\n";
+        if (cachedReports && telemetry->cacheable()) {
+          *stream << cachedReports->value(telemetry->key())
+                         .toObject()
+                         .value("text")
+                         .toString();
+        } else if (!telemetry->writeReport(*stream)) {
+          QVariant reportedValue = telemetry->report(/*json=*/false);
+          *stream << qVariantToString(reportedValue);
+        }
+        *stream << "\n";
       }
   }
 
@@ -1,12 +1,14 @@
 #pragma once
 
 #include "clioptions.h"
+#include <QJsonObject>
 #include <QObject>
 #include <memory>
 
 namespace Ripes {
 
 class CacheSim;
+class IOBase;
 class L1CacheShim;
 
 /// The CLIRunner class is used to run Ripes in CLI mode.
@@ -29,8 +31,15 @@ private:
   /// Runs the processor model until the program is finished.
   int runModel();
 
-  /// Prints requested telemetry to the console/output file.
-  int postRun();
+  /// Prints requested telemetry to the console/output file. If
+  /// @p cachedReports is set, cacheable telemetry is reported from it (see
+  /// ResultCache::lookup) rather than from the simulation state.
+  int postRun(const QJsonObject *cachedReports = nullptr);
+
+  /// Returns the reports of all enabled, cacheable telemetry, in the format
+  /// stored by the ResultCache.
+  QJsonObject collectReports();
+  QStringList cacheableTelemetryKeys() const;
   void info(QString msg, bool alwaysPrint = false, bool header = false,
             const QString &prefix = "INFO");
   void error(const QString &msg);
@@ -39,6 +48,15 @@ private:
   /// processor, mirroring the GUI cache tab. Used when --cache is requested.
   void setupCaches();
 
+  /// Instantiates the peripherals requested through --peripherals and
+  /// attaches them to the address space. Must be performed before the program
+  /// is processed, such that the peripheral symbols are available.
+  int setupPeripherals();
+
+  /// Attaches frame sinks (dump/hash) to the screen peripherals, as requested
+  /// through --screen-dump and the screen hash telemetry.
+  int setupScreenSinks();
+
   CLIModeOptions m_options;
 
   // L1 cache simulation state (only populated when --cache is set). The shims
@@ -48,6 +66,12 @@ private:
   std::unique_ptr<L1CacheShim> m_l1dShim;
   std::shared_ptr<CacheSim> m_l1iCache;
   std::shared_ptr<CacheSim> m_l1dCache;
+
+  // Destination of program output (print/write syscalls) while running.
+  std::unique_ptr<BufferedStdoutSink> m_stdoutSink;
+
+  // Headless peripherals attached through --peripherals.
+  std::vector<std::unique_ptr<IOBase>> m_peripherals;
 };
 
 } // namespace Ripes
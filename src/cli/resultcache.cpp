@@ -0,0 +1,109 @@
+#include "resultcache.h"
+#include "ripessettings.h"
+#include "version/version.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QJsonDocument>
+#include <QSaveFile>
+
+#include <algorithm>
+
+namespace Ripes {
+
+// Bumped whenever the format of cache entries, or the set of inputs hashed into
+// the key, changes.
+static constexpr int c_resultCacheFormat = 4;
+
+ResultCache::ResultCache(const QString &directory) : m_directory(directory) {}
+
+QString ResultCache::key(const Program &program,
+                         const CLIModeOptions &options) {
+  QByteArray keyData;
+  QDataStream stream(&keyData, QIODevice::WriteOnly);
+
+  stream << c_resultCacheFormat << getRipesVersion();
+
+  // Run configuration
+  stream << enumToString<ProcessorID>(options.proc);
+  QStringList exts = options.isaExtensions;
+  exts.sort();
+  stream << exts;
+  for (const auto &[regFile, inits] : options.regInit) {
+    stream << QString::fromUtf8(regFile.data(), regFile.size());
+    for (const auto &[idx, value] : inits)
+      stream << idx << static_cast<quint64>(value);
+  }
+  for (const auto &cache : {options.l1iCache, options.l1dCache}) {
+    stream << cache.has_value();
+    if (cache)
+      stream << *cache;
+  }
+  for (const auto &periph : options.peripherals) {
+    stream << static_cast<int>(periph.type);
+    for (const auto &[param, value] : periph.parameters)
+      stream << param << value;
+  }
+  stream << static_cast<quint64>(options.virtualTimeFreq);
+  // Bounds the cycles recorded by the pipeline telemetry.
+  stream << RipesSettings::value(RIPES_SETTING_PIPEDIAGRAM_MAXCYCLES).toInt();
+
+  // Program
+  stream << static_cast<quint64>(program.entryPoint);
+  for (const auto &[name, section] : program.sections)
+    stream << name << static_cast<quint64>(section.address) << section.data;
+
+  return QCryptographicHash::hash(keyData, QCryptographicHash::Sha256)
+      .toHex();
+}
+
+QString ResultCache::entryPath(const QString &key) const {
+  return QDir(m_directory).filePath(key + ".json");
+}
+
+std::optional<ResultCache::Entry>
+ResultCache::lookup(const QString &key,
+                    const QStringList &telemetryKeys) const {
+  QFile file(entryPath(key));
+  if (!file.open(QIODevice::ReadOnly))
+    return {};
+
+  const QJsonObject entry = QJsonDocument::fromJson(file.readAll()).object();
+  if (entry.value("format").toInt() != c_resultCacheFormat ||
+      entry.value("version").toString() != getRipesVersion())
+    return {};
+
+  Entry result;
+  result.reports = entry.value("reports").toObject();
+  const auto hasReport = [&](const QString &k) {
+    return result.reports.contains(k);
+  };
+  if (!std::all_of(telemetryKeys.begin(), telemetryKeys.end(), hasReport))
+    return {};
+  result.output =
+      QByteArray::fromBase64(entry.value("output").toString().toLatin1());
+  return result;
+}
+
+bool ResultCache::store(const QString &key, const Entry &entry) const {
+  if (!QDir().mkpath(m_directory))
+    return false;
+
+  QJsonObject json;
+  json["format"] = c_resultCacheFormat;
+  json["version"] = getRipesVersion();
+  json["reports"] = entry.reports;
+  // Program output is arbitrary binary data.
+  json["output"] = QString::fromLatin1(entry.output.toBase64());
+
+  // Write atomically, such that concurrent jobs sharing the cache never
+  // observe a partially written entry.
+  QSaveFile file(entryPath(key));
+  if (!file.open(QIODevice::WriteOnly))
+    return false;
+  file.write(QJsonDocument(json).toJson(QJsonDocument::Compact));
+  return file.commit();
+}
+
+} // namespace Ripes
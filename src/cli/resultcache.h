@@ -0,0 +1,55 @@
+#pragma once
+
+#include "assembler/program.h"
+#include "clioptions.h"
+
+#include <QJsonObject>
+#include <optional>
+
+namespace Ripes {
+
+/**
+ * @brief The ResultCache class
+ * An on-disk cache of CLI run results. An entry holds the reports of the
+ * (cacheable) telemetry of a run and the program output, keyed by a hash of
+ * the loaded program and the run configuration (see key()). Entries are stored
+ * as one JSON file per key. The Ripes version is part of both the key and the
+ * entry, such that results of a different simulator version are never reused.
+ *
+ * Caching assumes that the results of a run are fully determined by the
+ * program and the run configuration. Runs which observed input from the host
+ * (see ProcessorHandler::hostInputObserved()) or accessed host files (see
+ * ProcessorHandler::hostFilesAccessed()) must therefore not be stored.
+ */
+class ResultCache {
+public:
+  struct Entry {
+    /// Reports indexed by telemetry key, each holding the JSON ("json") and
+    /// textual ("text") report.
+    QJsonObject reports;
+    /// Output of the program to stdout/stderr.
+    QByteArray output;
+  };
+
+  explicit ResultCache(const QString &directory);
+
+  /// Computes the cache key for running @p program with @p options.
+  static QString key(const Program &program, const CLIModeOptions &options);
+
+  /// Returns the cached entry for @p key, if an entry exists which was
+  /// written by this version of Ripes and contains a report for each of
+  /// @p telemetryKeys.
+  std::optional<Entry> lookup(const QString &key,
+                              const QStringList &telemetryKeys) const;
+
+  /// Stores @p entry for @p key. Returns false if the entry could not be
+  /// written.
+  bool store(const QString &key, const Entry &entry) const;
+
+private:
+  QString entryPath(const QString &key) const;
+
+  QString m_directory;
+};
+
+} // namespace Ripes
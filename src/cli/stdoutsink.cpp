@@ -0,0 +1,61 @@
+#include "stdoutsink.h"
+
+#include <cstring>
+
+namespace Ripes {
+
+BufferedStdoutSink::BufferedStdoutSink(size_t capacity, FlushMode mode,
+                                       FILE *stream)
+    : m_buffer(capacity), m_mode(mode), m_stream(stream) {}
+
+BufferedStdoutSink::~BufferedStdoutSink() { flush(); }
+
+void BufferedStdoutSink::write(const char *data, size_t size) {
+  if (size == 0)
+    return;
+
+  if (size > m_buffer.size() - m_size) {
+    // Not enough room; drain the buffer. Writes which would not fit an empty
+    // buffer either are passed straight through.
+    flush();
+    if (size > m_buffer.size()) {
+      writeThrough(data, size);
+      return;
+    }
+  }
+
+  std::memcpy(m_buffer.data() + m_size, data, size);
+  m_size += size;
+
+  if (m_mode == FlushMode::Line && std::memchr(data, '\n', size))
+    flush();
+}
+
+void BufferedStdoutSink::flush() {
+  if (m_size == 0)
+    return;
+  writeThrough(m_buffer.data(), m_size);
+  m_size = 0;
+}
+
+void BufferedStdoutSink::writeThrough(const char *data, size_t size) {
+  std::fwrite(data, 1, size, m_stream);
+  std::fflush(m_stream);
+}
+
+RecordingSink::RecordingSink(OutputSink &sink, qsizetype maxSize)
+    : m_sink(sink), m_maxSize(maxSize) {}
+
+void RecordingSink::write(const char *data, size_t size) {
+  m_sink.write(data, size);
+  if (!m_complete)
+    return;
+  if (static_cast<size_t>(m_maxSize - m_recording.size()) < size) {
+    m_complete = false;
+    m_recording = QByteArray();
+    return;
+  }
+  m_recording.append(data, size);
+}
+
+} // namespace Ripes
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "syscall/systemio.h"
+
+#include <QByteArray>
+
+#include <cstdio>
+#include <vector>
+
+namespace Ripes {
+
+/**
+ * @brief The BufferedStdoutSink class
+ * A SystemIO output sink which accumulates program output in a fixed-size
+ * buffer and writes it to a C stream in bulk. The buffer is flushed when full,
+ * upon an explicit flush() (e.g. before blocking on stdin, or when the program
+ * finishes), upon destruction, and - in line-buffered mode - whenever a
+ * newline is written. Memory use is bounded by the buffer capacity, regardless
+ * of the amount of output produced.
+ */
+class BufferedStdoutSink : public OutputSink {
+public:
+  enum class FlushMode {
+    Line, // Flush whenever a newline is written.
+    Full  // Flush only when the buffer is full or on an explicit flush.
+  };
+
+  /// A capacity of 0 disables buffering; each write is then immediately
+  /// written and flushed to @p stream.
+  BufferedStdoutSink(size_t capacity, FlushMode mode, FILE *stream = stdout);
+  ~BufferedStdoutSink() override;
+
+  void write(const char *data, size_t size) override;
+  void flush() override;
+
+private:
+  void writeThrough(const char *data, size_t size);
+
+  std::vector<char> m_buffer;
+  size_t m_size = 0;
+  FlushMode m_mode;
+  FILE *m_stream;
+};
+
+/**
+ * @brief The RecordingSink class
+ * A SystemIO output sink which forwards all output to another sink, while
+ * recording up to a maximum number of bytes of it. If the output exceeds the
+ * maximum, the recording is discarded and marked as incomplete.
+ */
+class RecordingSink : public OutputSink {
+public:
+  RecordingSink(OutputSink &sink, qsizetype maxSize);
+
+  void write(const char *data, size_t size) override;
+  void flush() override { m_sink.flush(); }
+
+  /// Returns false if the output exceeded the maximum recording size.
+  bool complete() const { return m_complete; }
+  const QByteArray &recording() const { return m_recording; }
+
+private:
+  OutputSink &m_sink;
+  qsizetype m_maxSize;
+  QByteArray m_recording;
+  bool m_complete = true;
+};
+
+} // namespace Ripes
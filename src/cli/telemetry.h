@@ -3,6 +3,7 @@
 #include <QTextStream>
 
 #include "cachesim/cachesim.h"
+#include "io/screenframesink.h"
 #include "pipelinediagrammodel.h"
 #include "processorhandler.h"
 #include "radix.h"
@@ -21,6 +22,12 @@ public:
   // set, indicates that the output is intended for JSON export.
   virtual QVariant report(bool /*json*/) = 0;
 
+  // Writes the (non-JSON) report directly to 'out'. Returns false if not
+  // supported, in which case report() is used instead. Telemetry with
+  // potentially very large reports may implement this to avoid building the
+  // entire report in memory.
+  virtual bool writeReport(QTextStream & /*out*/) { return false; }
+
   // Returns the name of this telemetry.
   virtual QString key() const = 0;
 
@@ -30,6 +37,11 @@ public:
   // Returns the description of this telemetry.
   virtual QString description() const = 0;
 
+  // Returns true if the report of this telemetry is fully determined by the
+  // program and run configuration, and may thus be served from the result
+  // cache. Non-cacheable telemetry is always reported live.
+  virtual bool cacheable() const { return true; }
+
   virtual void enable() { m_enabled = true; }
   virtual void disable() { m_enabled = false; }
   bool isEnabled() const { return m_enabled; }
@@ -105,11 +117,94 @@ public:
     // Simply grab the current state of the pipeline diagram model and print it.
     return m_pipelineDiagramModel->toString();
   }
+  bool writeReport(QTextStream &out) override {
+    // Stream the diagram row by row rather than building the full string.
+    m_pipelineDiagramModel->writeDiagram(out);
+    return true;
+  }
 
 private:
   std::shared_ptr<PipelineDiagramModel> m_pipelineDiagramModel;
 };
 
+/// Base class for telemetry reporting the per-stage pipeline statistics which
+/// are maintained by the processor (see RipesProcessor::pipelineStats). The
+/// CLIRunner enables statistics gathering in the processor when any telemetry
+/// of this type is enabled. Unlike the PipelineTelemetry, this does not record
+/// a per-cycle pipeline diagram, and thus has a constant memory footprint.
+class PipelineStatsTelemetry : public Telemetry {
+protected:
+  static QString stageKey(const StageIndex &idx) {
+    const auto *proc = ProcessorHandler::getProcessor();
+    QString name = proc->stageName(idx);
+    if (proc->structure().size() > 1)
+      name = "lane " + QString::number(idx.lane()) + " " + name;
+    return name;
+  }
+};
+
+class HazardTelemetry : public PipelineStatsTelemetry {
+public:
+  QString key() const override { return "hazards"; }
+  QString prettyKey() const override { return "pipeline hazards"; }
+  QString description() const override {
+    return "total pipeline stalls/flushes/way hazards, and bubble stage cycles";
+  }
+  QVariant report(bool /*json*/) override {
+    // Stalls, flushes and way hazards are counted once, in the stage where
+    // they originate. Bubbles are counted in every stage they occupy.
+    uint64_t stalls = 0, flushes = 0, bubbles = 0, wayHazards = 0;
+    const auto &allStats = ProcessorHandler::getProcessor()->pipelineStats();
+    for (const auto &stats : allStats) {
+      stalls += stats.stalls;
+      flushes += stats.flushes;
+      bubbles += stats.bubbleCycles;
+      wayHazards += stats.wayHazards;
+    }
+    QVariantMap m;
+    m["stalls"] = static_cast<qulonglong>(stalls);
+    m["flushes"] = static_cast<qulonglong>(flushes);
+    m["bubble stage cycles"] = static_cast<qulonglong>(bubbles);
+    m["way hazards"] = static_cast<qulonglong>(wayHazards);
+    return m;
+  }
+};
+
+class StageStatsTelemetry : public PipelineStatsTelemetry {
+public:
+  QString key() const override { return "stagestats"; }
+  QString prettyKey() const override { return "pipeline stage statistics"; }
+  QString description() const override {
+    return "per-stage pipeline stall/flush/bubble/way hazard cycles";
+  }
+  QVariant report(bool json) override {
+    const auto &allStats = ProcessorHandler::getProcessor()->pipelineStats();
+    if (json) {
+      QVariantMap stageMap;
+      for (const auto &stats : allStats) {
+        QVariantMap m;
+        m["stall cycles"] = static_cast<qulonglong>(stats.stallCycles);
+        m["flush cycles"] = static_cast<qulonglong>(stats.flushCycles);
+        m["bubble cycles"] = static_cast<qulonglong>(stats.bubbleCycles);
+        m["way hazard cycles"] =
+            static_cast<qulonglong>(stats.wayHazardCycles);
+        stageMap[stageKey(stats.stage)] = m;
+      }
+      return stageMap;
+    } else {
+      QString outStr;
+      QTextStream out(&outStr);
+      out << "stage\tstalls\tflushes\tbubbles\tway hazards\n";
+      for (const auto &stats : allStats) {
+        out << stageKey(stats.stage) << "\t" << stats.stallCycles << "\t"
+            << stats.flushCycles << "\t" << stats.bubbleCycles << "\t"
+            << stats.wayHazardCycles << "\n";
+      }
+      return outStr;
+    }
+  }
+};
+
 class RegisterTelemetry : public Telemetry {
 public:
   QString key() const override { return "regs"; }
@@ -154,6 +249,7 @@ public:
   QVariant report(bool /*json*/) override {
     return QVariant::fromValue(m_elapsedMs);
   }
+  bool cacheable() const override { return false; }
   void setElapsedMs(qint64 ms) { m_elapsedMs = ms; }
 
 private:
@@ -178,7 +274,16 @@ public:
 
   QVariant report(bool /*json*/) override {
     QVariantMap m;
-    const auto add = [&m](const QString &prefix, CacheSim *c) {
+    const auto hex = [](AInt value) {
+      return "0x" + QString::number(value, 16);
+    };
+    const auto topList = [&hex](const auto &entries) {
+      QVariantList list;
+      for (const auto &[key, misses] : entries)
+        list.push_back(hex(key) + ": " + QString::number(misses));
+      return list;
+    };
+    const auto add = [&m, &topList](const QString &prefix, CacheSim *c) {
       const auto hits = c->getHits();
       const auto misses = c->getMisses();
       const auto total = hits + misses;
@@ -188,11 +293,59 @@ public:
       m[prefix + " writebacks"] = c->getWritebacks();
       m[prefix + " hit rate"] =
           total == 0 ? 0.0 : static_cast<double>(hits) / total;
+
+      // Miss classification and per-set breakdown
+      const auto stats = c->getTotalStats();
+      m[prefix + " compulsory misses"] = stats.compulsory;
+      m[prefix + " capacity misses"] = stats.capacity;
+      m[prefix + " conflict misses"] = stats.conflict;
+      QVariantList setHits, setMisses;
+      for (int i = 0; i < c->getLines(); ++i) {
+        const auto setStats = c->getSetStats(i);
+        setHits.push_back(setStats.hits);
+        setMisses.push_back(setStats.misses);
+      }
+      m[prefix + " set hits"] = setHits;
+      m[prefix + " set misses"] = setMisses;
+      m[prefix + " top miss PCs"] = topList(c->getTopMissPCs());
+      m[prefix + " top miss addresses"] = topList(c->getTopMissAddresses());
+
+      // Prefetching. Accuracy is the fraction of prefetches which were
+      // accessed; coverage the fraction of would-be misses which a prefetch
+      // removed.
+      const auto pf = c->getPrefetchStats();
+      m[prefix + " prefetches issued"] = pf.issued;
+      m[prefix + " useful prefetches"] = pf.useful;
+      m[prefix + " prefetch accuracy"] =
+          pf.issued == 0 ? 0.0 : static_cast<double>(pf.useful) / pf.issued;
+      m[prefix + " prefetch coverage"] =
+          pf.useful + misses == 0
+              ? 0.0
+              : static_cast<double>(pf.useful) / (pf.useful + misses);
+
+      m[prefix + " stall cycles"] =
+          static_cast<qulonglong>(c->getStallCycles());
     };
-    if (m_icache)
+    uint64_t stallCycles = 0;
+    if (m_icache) {
       add("L1i", m_icache.get());
-    if (m_dcache)
+      stallCycles += m_icache->getStallCycles();
+    }
+    if (m_dcache) {
       add("L1d", m_dcache.get());
+      stallCycles += m_dcache->getStallCycles();
+    }
+
+    // The effective CPI accounts for the memory stall cycles estimated from
+    // the cache timing, on top of the cycles simulated by the processor.
+    const auto cycleCount = ProcessorHandler::getProcessor()->getCycleCount();
+    const auto instrsRetired =
+        ProcessorHandler::getProcessor()->getInstructionsRetired();
+    m["memory stall cycles"] = static_cast<qulonglong>(stallCycles);
+    m["effective CPI"] =
+        instrsRetired == 0
+            ? 0.0
+            : static_cast<double>(cycleCount + stallCycles) / instrsRetired;
     return m;
   }
 
@@ -201,6 +354,49 @@ private:
   std::shared_ptr<CacheSim> m_dcache;
 };
 
+class ScreenHashTelemetry : public Telemetry {
+public:
+  QString key() const override { return "screenhash"; }
+  QString prettyKey() const override { return "screen frame hashes"; }
+  QString description() const override {
+    return "a 64-bit hash of each frame presented by the screen peripherals";
+  }
+
+  // Registers the hash sink attached to the screen peripheral named 'name'.
+  void addScreen(const QString &name,
+                 std::shared_ptr<ScreenFrameHashSink> sink) {
+    m_screens.push_back({name, std::move(sink)});
+  }
+
+  QVariant report(bool /*json*/) override {
+    QVariantMap m;
+    for (const auto &[name, sink] : m_screens) {
+      QStringList hashes;
+      for (const auto hash : sink->hashes())
+        hashes.push_back(hashString(hash));
+      m[name] = hashes;
+    }
+    return m;
+  }
+  bool writeReport(QTextStream &out) override {
+    // One line per frame.
+    for (const auto &[name, sink] : m_screens) {
+      const auto &hashes = sink->hashes();
+      for (size_t i = 0; i < hashes.size(); ++i)
+        out << name << " frame " << i << ": " << hashString(hashes[i]) << "\n";
+    }
+    return true;
+  }
+
+private:
+  static QString hashString(uint64_t hash) {
+    return QString::number(hash, 16).rightJustified(16, '0');
+  }
+
+  std::vector<std::pair<QString, std::shared_ptr<ScreenFrameHashSink>>>
+      m_screens;
+};
+
 class RunInfoTelemetry : public Telemetry {
 public:
   RunInfoTelemetry(QCommandLineParser *parser) {
@@ -213,11 +409,15 @@ public:
     return "simulation information (processor "
            "configuration, input file, ...)";
   }
+  bool cacheable() const override { return false; }
   QVariant report(bool /*json*/) override {
     QVariantMap m;
     m["processor"] = enumToString<ProcessorID>(ProcessorHandler::getID());
     m["ISA extensions"] = ProcessorHandler::currentISA()->enabledExtensions();
     m["source file"] = m_parser->value("src");
+    const auto freq = ProcessorHandler::virtualTimeFrequency();
+    m["time base"] = freq == 0 ? QStringLiteral("wall-clock")
+                               : "virtual (" + QString::number(freq) + " Hz)";
     return m;
   }
 
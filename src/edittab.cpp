@@ -8,6 +8,7 @@
 #include <QPushButton>
 
 #include "assembler/program.h"
+#include "assembler/programcache.h"
 
 #include "ccmanager.h"
 #include "cli/programutilities.h"
@@ -284,17 +285,23 @@ void EditTab::onProcessorChanged() {
   m_ui->codeEditor->setSourceType(
       m_currentSourceType, ProcessorHandler::getAssembler()->getOpcodes());
 
-  // Try reassembling
-  sourceCodeChanged();
+  // Try reassembling. Only unchanged programs, on startup and when switching
+  // between processors, are looked up in the program cache; edits are never
+  // cached.
+  processSourceCode(/*useProgramCache=*/true);
 }
 
 void EditTab::sourceCodeChanged() {
+  processSourceCode(/*useProgramCache=*/false);
+}
+
+void EditTab::processSourceCode(bool useProgramCache) {
   auto source = m_ui->codeEditor->document()->toPlainText();
   // Update the editor text setting for program persistance.
   RipesSettings::setValue(RIPES_SETTING_SOURCECODE, source);
   switch (m_currentSourceType) {
   case SourceType::Assembly:
-    assemble(source);
+    assemble(source, useProgramCache);
     break;
   default:
     // Do nothing, either some external program is loaded or, if compiling from
@@ -303,9 +310,16 @@ void EditTab::sourceCodeChanged() {
   }
 }
 
-void EditTab::assemble(const QString &source) {
-  auto res = ProcessorHandler::getAssembler()->assembleRaw(
-      source, &IOManager::get().assemblerSymbols());
+void EditTab::assemble(const QString &source, bool useProgramCache) {
+  static const Assembler::ProgramCache programCache(
+      Assembler::ProgramCache::defaultDirectory());
+  const auto *symbols = &IOManager::get().assemblerSymbols();
+  auto res =
+      useProgramCache &&
+              RipesSettings::value(RIPES_SETTING_ASSEMBLER_CACHE).toBool()
+          ? programCache.assemble(source, *ProcessorHandler::getAssembler(),
+                                  *ProcessorHandler::currentISA(), symbols)
+          : ProcessorHandler::getAssembler()->assembleRaw(source, symbols);
   *m_sourceErrors = res.errors;
   if (m_sourceErrors->size() == 0) {
     ProcessorHandler::loadProgram(std::make_shared<Program>(res.program));
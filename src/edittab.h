@@ -72,9 +72,12 @@ public slots:
   void on_disassembledViewButton_toggled();
 
 private:
+  // Stores the current source and, for assembly sources, reassembles it.
+  void processSourceCode(bool useProgramCache);
   // Assembles the provided text and updates the ProcessorHandler with the
-  // assembled program.
-  void assemble(const QString &sourceText);
+  // assembled program. If @p useProgramCache is set, the program may be served
+  // from (and is stored in) the program cache.
+  void assemble(const QString &sourceText, bool useProgramCache);
   void compile();
 
   void updateProgramViewer();
@@ -1,7 +1,7 @@
 ﻿#pragma once
 
+#include <QObject>
 #include <QVariant>
-#include <QWidget>
 #include <set>
 
 #include "assembler/program.h"
@@ -59,11 +59,17 @@ struct RegDesc {
   bool exported = false;
 };
 
-class IOBase : public QWidget {
+/**
+ * @brief The IOBase class
+ * The register/state model of an IO peripheral. An IOBase is independent of any
+ * GUI, and may thus be instantiated headless (e.g. in CLI mode). Visualization
+ * and user interaction is provided by a separate IOWidget (see iowidget.h).
+ */
+class IOBase : public QObject {
   Q_OBJECT
 
 public:
-  IOBase(unsigned IOType /*ioregistry.h::IOType*/, QWidget *parent);
+  IOBase(unsigned IOType /*ioregistry.h::IOType*/, QObject *parent);
   virtual ~IOBase() {
     assert(m_didUnregister &&
            "IO peripherals must call unregister() in their destructor!");
@@ -175,8 +181,9 @@ signals:
 
   /**
    * @brief scheduleUpdate
-   * Should be emitted when a peripheral requests to be repainted. We do this
-   * through signal/slot mechanisms to ensure that the actual update() is only
+   * Should be emitted when the state of a peripheral has changed such that its
+   * visualization should be repainted. We do this through signal/slot
+   * mechanisms to ensure that the actual update() of any IOWidget is only
    * performed on the GUI thread.
    */
   void scheduleUpdate();
@@ -1,19 +1,21 @@
 #include "ioclock.h"
 #include "ioregistry.h"
+#include "processorhandler.h"
 
 #include <QDateTime>
 #include <QVBoxLayout>
 
-#include <chrono>
-
 namespace Ripes {
 
-IOClock::IOClock(QWidget *parent) : IOBase(IOType::RTC, parent) {
+IOClock::IOClock(QObject *parent) : IOBase(IOType::RTC, parent) {
   m_regDescs = {
       RegDesc{"TIME_LO", RegDesc::RW::R, 32, TIME_LO * 4, true},
       RegDesc{"TIME_HI", RegDesc::RW::R, 32, TIME_HI * 4, true},
   };
+}
 
+IOClockWidget::IOClockWidget(IOClock *clock, QWidget *parent)
+    : IOWidget(clock, parent) {
   auto *layout = new QVBoxLayout(this);
   m_epochLabel = new QLabel(this);
   m_humanLabel = new QLabel(this);
@@ -27,20 +29,19 @@ IOClock::IOClock(QWidget *parent) : IOBase(IOType::RTC, parent) {
   // read, independently of this timer.
   m_displayTimer = new QTimer(this);
   m_displayTimer->setInterval(100);
-  connect(m_displayTimer, &QTimer::timeout, this, &IOClock::updateDisplay);
+  connect(m_displayTimer, &QTimer::timeout, this,
+          &IOClockWidget::updateDisplay);
   m_displayTimer->start();
   updateDisplay();
 }
 
-uint64_t IOClock::nowNanos() {
-  return static_cast<uint64_t>(
-      std::chrono::duration_cast<std::chrono::nanoseconds>(
-          std::chrono::system_clock::now().time_since_epoch())
-          .count());
-}
-
-void IOClock::updateDisplay() {
-  const uint64_t ns = nowNanos();
+void IOClockWidget::updateDisplay() {
+  const uint64_t ns = ProcessorHandler::timeNanos();
+  if (ProcessorHandler::virtualTimeFrequency() != 0) {
+    m_epochLabel->setText("Virtual time: " + QString::number(ns) + " ns");
+    m_humanLabel->setText(QString::number(ns / 1e9, 'f', 6) + " s");
+    return;
+  }
   m_epochLabel->setText("Epoch: " + QString::number(ns) + " ns");
   const auto ms = static_cast<qint64>(ns / 1000000ull);
   m_humanLabel->setText(
@@ -61,6 +62,10 @@ QString IOClock::description() const {
          "and latches the high word. Read TIME_LO first, then TIME_HI, to "
          "obtain a coherent 64-bit value without tearing. On 64-bit targets "
          "the whole value may be read with a single 8-byte access at offset 0.";
+  desc << "";
+  desc << "If virtual time is enabled in the simulator settings, the value is "
+          "instead the simulated time since processor reset, derived from the "
+          "cycle count.";
   return desc.join('\n');
 }
 
@@ -68,7 +73,7 @@ VInt IOClock::ioRead(AInt offset, unsigned size) {
   // A full-width (>= 8 byte) access returns the whole 64-bit value atomically;
   // no latching is required.
   if (size >= 8) {
-    return static_cast<VInt>(nowNanos());
+    return static_cast<VInt>(ProcessorHandler::timeNanos());
   }
 
   if (offset >= TIME_HI * 4) {
@@ -78,7 +83,7 @@ VInt IOClock::ioRead(AInt offset, unsigned size) {
 
   // Low-word read: sample the full 64-bit time, latch its high word for a
   // subsequent TIME_HI read, and return the low word.
-  const uint64_t ns = nowNanos();
+  const uint64_t ns = ProcessorHandler::timeNanos();
   m_latchedHigh = static_cast<uint32_t>(ns >> 32);
   return static_cast<VInt>(static_cast<uint32_t>(ns & 0xFFFFFFFFull));
 }
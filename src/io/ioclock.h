@@ -2,9 +2,9 @@
 
 #include <QLabel>
 #include <QTimer>
-#include <QWidget>
 
 #include "iobase.h"
+#include "iowidget.h"
 
 namespace Ripes {
 
@@ -16,8 +16,10 @@ namespace Ripes {
  * measuring real elapsed time).
  *
  * The clock value is the number of nanoseconds since the Unix epoch, sampled
- * fresh on every read, and exposed as a 64-bit value through two 32-bit
- * registers:
+ * fresh on every read. If virtual time is enabled (see
+ * ProcessorHandler::timeNanos), the value is instead the simulated time since
+ * processor reset, derived from the cycle count. The value is exposed as a
+ * 64-bit value through two 32-bit registers:
  *   - TIME_LO (offset 0): the low 32 bits.
  *   - TIME_HI (offset 4): the high 32 bits.
  *
@@ -32,7 +34,7 @@ class IOClock : public IOBase {
   Q_OBJECT
 
 public:
-  IOClock(QWidget *parent);
+  IOClock(QObject *parent);
   ~IOClock() { unregister(); }
 
   enum Registers { TIME_LO, TIME_HI, NREGISTERS };
@@ -55,17 +57,22 @@ protected:
   virtual void parameterChanged(unsigned) override { /* no parameters */ }
 
 private:
-  /// Returns the current wall-clock time as nanoseconds since the Unix epoch.
-  static uint64_t nowNanos();
-
-  /// Refreshes the human-readable time display.
-  void updateDisplay();
-
   std::vector<RegDesc> m_regDescs;
 
   /// High 32 bits of the most recent TIME_LO sample, returned by a subsequent
   /// read of TIME_HI (see class documentation).
   uint32_t m_latchedHigh = 0;
+};
+
+class IOClockWidget : public IOWidget {
+  Q_OBJECT
+
+public:
+  IOClockWidget(IOClock *clock, QWidget *parent);
+
+private:
+  /// Refreshes the human-readable time display.
+  void updateDisplay();
 
   QLabel *m_epochLabel = nullptr;
   QLabel *m_humanLabel = nullptr;
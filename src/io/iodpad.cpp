@@ -11,7 +11,7 @@
 
 namespace Ripes {
 
-IODPad::IODPad(QWidget *parent) : IOBase(IOType::DPAD, parent) {
+IODPad::IODPad(QObject *parent) : IOBase(IOType::DPAD, parent) {
   for (auto &b : m_down)
     b.store(false);
   for (auto &b : m_latched)
@@ -19,113 +19,179 @@ IODPad::IODPad(QWidget *parent) : IOBase(IOType::DPAD, parent) {
 
   for (unsigned i = 0; i < DIRECTIONS; ++i) {
     QString name;
-    Qt::ArrowType arrow;
     switch (i) {
     case UP:
       name = "UP";
-      arrow = Qt::UpArrow;
       break;
     case DOWN:
       name = "DOWN";
-      arrow = Qt::DownArrow;
       break;
     case LEFT:
       name = "LEFT";
-      arrow = Qt::LeftArrow;
       break;
     case RIGHT:
       name = "RIGHT";
+      break;
+    }
+    m_regDescs.push_back(RegDesc{name, RegDesc::RW::R, 1, i * 4, true});
+  }
+}
+
+unsigned IODPad::byteSize() const { return 4 * 4; }
+
+void IODPad::setDirection(IdxToDir dir, bool pressed) {
+  m_down[dir].store(pressed, std::memory_order_relaxed);
+  if (pressed) {
+    // Latch the press so that even a tap shorter than the program's polling
+    // interval is observed once (cleared on read in ioRead).
+    m_latched[dir].store(true, std::memory_order_relaxed);
+  }
+}
+
+QString IODPad::description() const {
+  QStringList desc;
+  desc << "Each button maps to a 32-bit register, with the least-significant "
+          "bit indicating the state of the "
+          "button.\n";
+  desc << "If the D-pad window is in focus, the buttons may be pressed using "
+          "the \"WASD\" or arrow keys of the keyboard.\n";
+  desc << "A button register reads as 1 if the button is currently held, or if "
+          "it was pressed at any point since the register was last read "
+          "(edge/press capture). Reading a register clears this captured "
+          "press, so brief taps between polls are not missed.";
+
+  return desc.join('\n');
+}
+
+VInt IODPad::ioRead(AInt offset, unsigned) {
+  const unsigned idx = static_cast<unsigned>(offset) / 4;
+  if (idx >= DIRECTIONS)
+    return 0;
+  const bool down = m_down[idx].load(std::memory_order_relaxed);
+  // Read-to-clear the captured press.
+  const bool latched =
+      m_latched[idx].exchange(false, std::memory_order_relaxed);
+  return (down || latched) ? 1 : 0;
+}
+
+void IODPad::ioWrite(AInt, VInt, unsigned) {
+  // Write-only
+}
+
+void IODPad::reset() {
+  for (unsigned i = 0; i < DIRECTIONS; ++i) {
+    m_down[i].store(false, std::memory_order_relaxed);
+    m_latched[i].store(false, std::memory_order_relaxed);
+  }
+  emit scheduleUpdate();
+}
+
+IODPadWidget::IODPadWidget(IODPad *dpad, QWidget *parent)
+    : IOWidget(dpad, parent), m_dpad(dpad) {
+  for (unsigned i = 0; i < IODPad::DIRECTIONS; ++i) {
+    Qt::ArrowType arrow;
+    switch (i) {
+    case IODPad::UP:
+      arrow = Qt::UpArrow;
+      break;
+    case IODPad::DOWN:
+      arrow = Qt::DownArrow;
+      break;
+    case IODPad::LEFT:
+      arrow = Qt::LeftArrow;
+      break;
+    case IODPad::RIGHT:
       arrow = Qt::RightArrow;
       break;
     }
     auto *button = new QToolButton();
-    m_buttons[static_cast<IdxToDir>(i)] = button;
+    const auto dir = static_cast<IODPad::IdxToDir>(i);
+    m_buttons[dir] = button;
     button->setArrowType(arrow);
     // Keep keyboard focus on the D-pad container (so WASD/arrow keys reach its
     // key handlers) rather than letting a button steal it.
     button->setFocusPolicy(Qt::NoFocus);
 
     // Drive the input state from mouse interaction with the button.
-    const auto dir = static_cast<IdxToDir>(i);
     connect(button, &QAbstractButton::pressed, this, [this, dir] {
       setFocus(Qt::MouseFocusReason);
       setDirection(dir, true);
     });
     connect(button, &QAbstractButton::released, this,
             [this, dir] { setDirection(dir, false); });
-
-    m_regDescs.push_back(RegDesc{name, RegDesc::RW::R, 1, i * 4, true});
   }
 
   auto *gridLayout = new QGridLayout();
-  gridLayout->addWidget(m_buttons[UP], 0, 1);
-  gridLayout->addWidget(m_buttons[DOWN], 2, 1);
-  gridLayout->addWidget(m_buttons[LEFT], 1, 0);
-  gridLayout->addWidget(m_buttons[RIGHT], 1, 2);
+  gridLayout->addWidget(m_buttons[IODPad::UP], 0, 1);
+  gridLayout->addWidget(m_buttons[IODPad::DOWN], 2, 1);
+  gridLayout->addWidget(m_buttons[IODPad::LEFT], 1, 0);
+  gridLayout->addWidget(m_buttons[IODPad::RIGHT], 1, 2);
 
   setLayout(gridLayout);
 
   // Accept keyboard focus so that WASD/arrow key presses are delivered to this
   // widget's key handlers once it has been clicked/highlighted.
   setFocusPolicy(Qt::StrongFocus);
-}
 
-unsigned IODPad::byteSize() const { return 4 * 4; }
+  // The peripheral requests an update when reset, upon which the buttons are
+  // released.
+  connect(dpad, &IOBase::scheduleUpdate, this, &IODPadWidget::updateButtons);
+}
 
-bool IODPad::keyToDirection(int key, IdxToDir &dir) const {
+bool IODPadWidget::keyToDirection(int key, IODPad::IdxToDir &dir) const {
   switch (key) {
   case Qt::Key_W:
   case Qt::Key_Up:
-    dir = UP;
+    dir = IODPad::UP;
     return true;
   case Qt::Key_S:
   case Qt::Key_Down:
-    dir = DOWN;
+    dir = IODPad::DOWN;
     return true;
   case Qt::Key_A:
   case Qt::Key_Left:
-    dir = LEFT;
+    dir = IODPad::LEFT;
     return true;
   case Qt::Key_D:
   case Qt::Key_Right:
-    dir = RIGHT;
+    dir = IODPad::RIGHT;
     return true;
   }
   return false;
 }
 
-void IODPad::setDirection(IdxToDir dir, bool pressed) {
-  m_down[dir].store(pressed, std::memory_order_relaxed);
-  if (pressed) {
-    // Latch the press so that even a tap shorter than the program's polling
-    // interval is observed once (cleared on read in ioRead).
-    m_latched[dir].store(true, std::memory_order_relaxed);
-  }
+void IODPadWidget::setDirection(IODPad::IdxToDir dir, bool pressed) {
+  m_dpad->setDirection(dir, pressed);
   auto it = m_buttons.find(dir);
   if (it != m_buttons.end())
     it->second->setDown(pressed);
 }
 
-void IODPad::mousePressEvent(QMouseEvent *e) {
+void IODPadWidget::updateButtons() {
+  for (const auto &it : m_buttons)
+    it.second->setDown(m_dpad->isDown(it.first));
+}
+
+void IODPadWidget::mousePressEvent(QMouseEvent *e) {
   // Ensure clicking anywhere on the D-pad gives it keyboard focus, so the
   // subsequent WASD/arrow keys are delivered here.
   setFocus(Qt::MouseFocusReason);
-  IOBase::mousePressEvent(e);
+  IOWidget::mousePressEvent(e);
 }
 
-void IODPad::keyPressEvent(QKeyEvent *e) {
-  IdxToDir dir;
+void IODPadWidget::keyPressEvent(QKeyEvent *e) {
+  IODPad::IdxToDir dir;
   if (keyToDirection(e->key(), dir)) {
     // Auto-repeat presses simply re-assert the held state, which is fine.
     setDirection(dir, true);
     e->accept();
     return;
   }
-  IOBase::keyPressEvent(e);
+  IOWidget::keyPressEvent(e);
 }
 
-void IODPad::keyReleaseEvent(QKeyEvent *e) {
-  IdxToDir dir;
+void IODPadWidget::keyReleaseEvent(QKeyEvent *e) {
+  IODPad::IdxToDir dir;
   if (keyToDirection(e->key(), dir)) {
     // Ignore synthetic auto-repeat releases (generated while a key is held on
     // some platforms) so a held direction does not flicker off between polls.
@@ -137,47 +203,7 @@ void IODPad::keyReleaseEvent(QKeyEvent *e) {
     e->accept();
     return;
   }
-  IOBase::keyReleaseEvent(e);
-}
-
-QString IODPad::description() const {
-  QStringList desc;
-  desc << "Each button maps to a 32-bit register, with the least-significant "
-          "bit indicating the state of the "
-          "button.\n";
-  desc << "If the D-pad window is in focus, the buttons may be pressed using "
-          "the \"WASD\" or arrow keys of the keyboard.\n";
-  desc << "A button register reads as 1 if the button is currently held, or if "
-          "it was pressed at any point since the register was last read "
-          "(edge/press capture). Reading a register clears this captured "
-          "press, so brief taps between polls are not missed.";
-
-  return desc.join('\n');
-}
-
-VInt IODPad::ioRead(AInt offset, unsigned) {
-  const unsigned idx = static_cast<unsigned>(offset) / 4;
-  if (idx >= DIRECTIONS)
-    return 0;
-  const bool down = m_down[idx].load(std::memory_order_relaxed);
-  // Read-to-clear the captured press.
-  const bool latched =
-      m_latched[idx].exchange(false, std::memory_order_relaxed);
-  return (down || latched) ? 1 : 0;
-}
-
-void IODPad::ioWrite(AInt, VInt, unsigned) {
-  // Write-only
-}
-
-void IODPad::reset() {
-  for (unsigned i = 0; i < DIRECTIONS; ++i) {
-    m_down[i].store(false, std::memory_order_relaxed);
-    m_latched[i].store(false, std::memory_order_relaxed);
-    auto it = m_buttons.find(static_cast<IdxToDir>(i));
-    if (it != m_buttons.end())
-      it->second->setDown(false);
-  }
+  IOWidget::keyReleaseEvent(e);
 }
 
 } // namespace Ripes
@@ -2,7 +2,6 @@
 
 #include <QPen>
 #include <QVariant>
-#include <QWidget>
 
 #include <array>
 #include <atomic>
@@ -10,16 +9,17 @@
 QT_FORWARD_DECLARE_CLASS(QAbstractButton);
 
 #include "iobase.h"
+#include "iowidget.h"
 
 namespace Ripes {
 
 class IODPad : public IOBase {
   Q_OBJECT
 
+public:
   enum IdxToDir { UP, DOWN, LEFT, RIGHT, DIRECTIONS };
 
-public:
-  IODPad(QWidget *parent);
+  IODPad(QObject *parent);
   ~IODPad() { unregister(); };
 
   virtual unsigned byteSize() const override;
@@ -38,25 +38,20 @@ public:
 
   virtual void reset() override;
 
+  /// Updates the pressed state of a direction, updating the current-state bit
+  /// and - on a press - the "pressed since last read" latch.
+  void setDirection(IdxToDir dir, bool pressed);
+
+  /// Returns whether direction @p dir is currently held.
+  bool isDown(IdxToDir dir) const {
+    return m_down[dir].load(std::memory_order_relaxed);
+  }
+
 protected:
   virtual void parameterChanged(unsigned) override { /* no parameters */ };
-  void keyPressEvent(QKeyEvent *e) override;
-  void keyReleaseEvent(QKeyEvent *e) override;
-  void mousePressEvent(QMouseEvent *e) override;
 
 private:
-  /// Maps a key code (WASD or arrow keys) to a direction. Returns true and sets
-  /// @p dir on a match.
-  bool keyToDirection(int key, IdxToDir &dir) const;
-
-  /// Updates the pressed state of a direction (from keyboard or mouse),
-  /// updating the button visual, the current-state bit, and - on a press - the
-  /// "pressed since last read" latch.
-  void setDirection(IdxToDir dir, bool pressed);
-
-  constexpr static unsigned m_maxSideWidth = 256;
   std::vector<RegDesc> m_regDescs;
-  std::map<IdxToDir, QAbstractButton *> m_buttons;
 
   // Input state shared between the GUI thread (which updates it from key/mouse
   // events) and the processor thread (which reads it via ioRead during a run),
@@ -71,4 +66,31 @@ private:
   std::array<std::atomic<bool>, DIRECTIONS> m_down;
   std::array<std::atomic<bool>, DIRECTIONS> m_latched;
 };
+
+class IODPadWidget : public IOWidget {
+  Q_OBJECT
+
+public:
+  IODPadWidget(IODPad *dpad, QWidget *parent);
+
+protected:
+  void keyPressEvent(QKeyEvent *e) override;
+  void keyReleaseEvent(QKeyEvent *e) override;
+  void mousePressEvent(QMouseEvent *e) override;
+
+private:
+  /// Maps a key code (WASD or arrow keys) to a direction. Returns true and sets
+  /// @p dir on a match.
+  bool keyToDirection(int key, IODPad::IdxToDir &dir) const;
+
+  /// Updates the pressed state of a direction (from keyboard or mouse) in the
+  /// peripheral, as well as the button visual.
+  void setDirection(IODPad::IdxToDir dir, bool pressed);
+
+  /// Synchronizes the button visuals with the peripheral state.
+  void updateButtons();
+
+  IODPad *m_dpad = nullptr;
+  std::map<IODPad::IdxToDir, QAbstractButton *> m_buttons;
+};
 } // namespace Ripes
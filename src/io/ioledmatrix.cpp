@@ -8,7 +8,7 @@
 
 namespace Ripes {
 
-IOLedMatrix::IOLedMatrix(QWidget *parent) : IOBase(IOType::LED_MATRIX, parent) {
+IOLedMatrix::IOLedMatrix(QObject *parent) : IOBase(IOType::LED_MATRIX, parent) {
   constexpr unsigned defaultWidth = 25;
 
   // Parameters
@@ -18,9 +18,6 @@ IOLedMatrix::IOLedMatrix(QWidget *parent) : IOBase(IOType::LED_MATRIX, parent) {
       IOParam(WIDTH, "Width", defaultWidth + 10, true, 1, m_maxSideWidth);
   m_parameters[SIZE] = IOParam(SIZE, "LED size", 8, true, 1, 100);
 
-  m_pen.setWidth(1);
-  m_pen.setColor(Qt::black);
-
   updateLEDRegs();
 }
 
@@ -83,31 +80,36 @@ void IOLedMatrix::updateLEDRegs() {
     mRegDesc.value() = regdesc;
   }
 
-  updateGeometry();
   emit regMapChanged();
 }
 
-QSize IOLedMatrix::minimumSizeHint() const {
-  const int width = m_parameters.at(WIDTH).value.toInt();
-  const int height = m_parameters.at(HEIGHT).value.toInt();
-  const int size = m_parameters.at(SIZE).value.toInt();
+IOLedMatrixWidget::IOLedMatrixWidget(IOLedMatrix *ledMatrix, QWidget *parent)
+    : IOWidget(ledMatrix, parent), m_ledMatrix(ledMatrix) {
+  m_pen.setWidth(1);
+  m_pen.setColor(Qt::black);
+}
+
+QSize IOLedMatrixWidget::minimumSizeHint() const {
+  const int width = m_ledMatrix->matrixWidth();
+  const int height = m_ledMatrix->matrixHeight();
+  const int size = m_ledMatrix->ledSize();
   const int pixelWidth = width * (size + m_pen.width());
   const int pixelHeight = height * (size + m_pen.width());
   return QSize(pixelWidth, pixelHeight);
 }
 
-void IOLedMatrix::paintEvent(QPaintEvent *) {
+void IOLedMatrixWidget::paintEvent(QPaintEvent *) {
   QPainter painter(this);
   painter.setRenderHint(QPainter::Antialiasing);
 
   painter.setPen(m_pen);
 
-  const int width = m_parameters[WIDTH].value.toInt();
-  const int height = m_parameters[HEIGHT].value.toInt();
-  const int size = m_parameters[SIZE].value.toInt();
+  const int width = m_ledMatrix->matrixWidth();
+  const int height = m_ledMatrix->matrixHeight();
+  const int size = m_ledMatrix->ledSize();
   for (int y = 0; y < height; y++) {
     for (int x = 0; x < width; x++) {
-      QBrush brush(regToColor(m_ledRegs.at(y * width + x)));
+      QBrush brush(regToColor(m_ledMatrix->ledValue(y * width + x)));
       painter.setBrush(brush);
 
       const unsigned xpos = x * (size + m_pen.width());
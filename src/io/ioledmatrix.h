@@ -2,9 +2,9 @@
 
 #include <QPen>
 #include <QVariant>
-#include <QWidget>
 
 #include "iobase.h"
+#include "iowidget.h"
 
 namespace Ripes {
 
@@ -14,7 +14,7 @@ class IOLedMatrix : public IOBase {
   enum Parameters { HEIGHT, WIDTH, SIZE };
 
 public:
-  IOLedMatrix(QWidget *parent);
+  IOLedMatrix(QObject *parent);
   ~IOLedMatrix() { unregister(); };
 
   virtual unsigned byteSize() const override;
@@ -38,15 +38,16 @@ public:
     std::fill(m_ledRegs.begin(), m_ledRegs.end(), 0);
   }
 
+  unsigned matrixWidth() const { return m_parameters.at(WIDTH).value.toUInt(); }
+  unsigned matrixHeight() const {
+    return m_parameters.at(HEIGHT).value.toUInt();
+  }
+  unsigned ledSize() const { return m_parameters.at(SIZE).value.toUInt(); }
+  uint32_t ledValue(unsigned idx) const { return m_ledRegs.at(idx); }
+
 protected:
   virtual void parameterChanged(unsigned) override { updateLEDRegs(); };
 
-  /**
-   * QWidget drawing
-   */
-  void paintEvent(QPaintEvent *event) override;
-  QSize minimumSizeHint() const override;
-
 private:
   VInt regRead(AInt offset) const;
   void updateLEDRegs();
@@ -55,7 +56,20 @@ private:
   std::vector<uint32_t> m_ledRegs;
   std::vector<RegDesc> m_regDescs;
   std::vector<IOSymbol> m_extraSymbols;
+};
 
+class IOLedMatrixWidget : public IOWidget {
+  Q_OBJECT
+
+public:
+  IOLedMatrixWidget(IOLedMatrix *ledMatrix, QWidget *parent);
+
+protected:
+  void paintEvent(QPaintEvent *event) override;
+  QSize minimumSizeHint() const override;
+
+private:
+  IOLedMatrix *m_ledMatrix = nullptr;
   QPen m_pen;
 };
 } // namespace Ripes
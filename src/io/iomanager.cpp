@@ -32,7 +32,7 @@ QString IOManager::cSymbolsHeaderpath() const {
 void IOManager::reset() {
   for (auto &device : m_peripherals) {
     device->reset();
-    device->update();
+    emit device->scheduleUpdate();
   }
 }
 
@@ -88,7 +88,7 @@ void IOManager::registerPeripheralWithProcessor(IOBase *peripheral) {
           }});
 
   peripheral->memWrite = [](AInt address, VInt value, unsigned size) {
-    ProcessorHandler::getMemory().writeMem(address, value, size);
+    ProcessorHandler::writeMem(address, value, size);
   };
   peripheral->memRead = [](AInt address, unsigned size) {
     return ProcessorHandler::getMemory().readMem(address, size);
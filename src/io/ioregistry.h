@@ -1,7 +1,7 @@
 #pragma once
 
 #include "iobase.h"
-#include <QWidget>
+#include "iowidget.h"
 
 #include "ioclock.h"
 #include "iodpad.h"
@@ -12,10 +12,12 @@
 /** @brief IORegistry
  *
  * This is where all peripherals should be registerred to be made available in
- * the UI. The peripheral must be registerred three times:
+ * the UI. The peripheral must be registerred four times:
  * - Add it to the IOType enum
  * - Add it to the IOTypeTitles map (Associate a name with the peripheral)
  * - Add it to the IOFactories map (Associate a constructor with the peripheral)
+ * - Add it to the IOWidgetFactories map (Associate a constructor of the
+ *   peripheral visualization with the peripheral)
  */
 
 namespace Ripes {
@@ -23,12 +25,23 @@ namespace Ripes {
 enum IOType { LED_MATRIX, SWITCHES, DPAD, RTC, SCREEN, NPERIPHERALS };
 
 template <typename T>
-IOBase *createIO(QWidget *parent) {
+IOBase *createIO(QObject *parent) {
   static_assert(std::is_base_of<IOBase, T>::value);
   return new T(parent);
 }
 
-using IOFactory = std::function<IOBase *(QWidget *parent)>;
+template <typename T, typename T_Widget>
+IOWidget *createIOWidget(IOBase *peripheral, QWidget *parent) {
+  static_assert(std::is_base_of<IOBase, T>::value);
+  static_assert(std::is_base_of<IOWidget, T_Widget>::value);
+  auto *typedPeripheral = dynamic_cast<T *>(peripheral);
+  assert(typedPeripheral && "Peripheral type does not match its widget");
+  return new T_Widget(typedPeripheral, parent);
+}
+
+using IOFactory = std::function<IOBase *(QObject *parent)>;
+using IOWidgetFactory =
+    std::function<IOWidget *(IOBase *peripheral, QWidget *parent)>;
 
 const static std::map<IOType, QString> IOTypeTitles = {
     {IOType::LED_MATRIX, "LED Matrix"},
@@ -42,6 +55,12 @@ const static std::map<IOType, IOFactory> IOFactories = {
     {IOType::DPAD, createIO<IODPad>},
     {IOType::RTC, createIO<IOClock>},
     {IOType::SCREEN, createIO<IOScreen>}};
+const static std::map<IOType, IOWidgetFactory> IOWidgetFactories = {
+    {IOType::LED_MATRIX, createIOWidget<IOLedMatrix, IOLedMatrixWidget>},
+    {IOType::SWITCHES, createIOWidget<IOSwitches, IOSwitchesWidget>},
+    {IOType::DPAD, createIOWidget<IODPad, IODPadWidget>},
+    {IOType::RTC, createIOWidget<IOClock, IOClockWidget>},
+    {IOType::SCREEN, createIOWidget<IOScreen, IOScreenWidget>}};
 
 } // namespace Ripes
 
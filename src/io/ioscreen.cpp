@@ -4,9 +4,78 @@
 
 #include "ioregistry.h"
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define RIPES_SCREEN_SSE2
+#endif
+#if (defined(__GNUC__) || defined(__clang__)) &&                               \
+    (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define RIPES_SCREEN_AVX2
+#endif
+
 namespace Ripes {
 
-IOScreen::IOScreen(QWidget *parent) : IOBase(IOType::SCREEN, parent) {
+namespace {
+
+// Converts 'count' framebuffer words into opaque RGB32 pixels. The upper byte
+// of a framebuffer word is ignored, such that the conversion is simply forcing
+// the alpha byte.
+void convertRowScalar(const uint32_t *src, QRgb *dst, unsigned count) {
+  for (unsigned i = 0; i < count; i++)
+    dst[i] = 0xFF000000u | src[i];
+}
+
+#ifdef RIPES_SCREEN_SSE2
+void convertRowSSE2(const uint32_t *src, QRgb *dst, unsigned count) {
+  const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+  unsigned i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const __m128i v =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i),
+                     _mm_or_si128(v, alpha));
+  }
+  convertRowScalar(src + i, dst + i, count - i);
+}
+#endif
+
+#ifdef RIPES_SCREEN_AVX2
+// Compiled for AVX2 regardless of the target flags of the build, and only
+// selected if the host CPU supports it.
+__attribute__((target("avx2"))) void
+convertRowAVX2(const uint32_t *src, QRgb *dst, unsigned count) {
+  const __m256i alpha = _mm256_set1_epi32(static_cast<int>(0xFF000000u));
+  unsigned i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const __m256i v =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i),
+                        _mm256_or_si256(v, alpha));
+  }
+  convertRowScalar(src + i, dst + i, count - i);
+}
+#endif
+
+using ConvertRowFn = void (*)(const uint32_t *, QRgb *, unsigned);
+
+ConvertRowFn selectConvertRow() {
+#ifdef RIPES_SCREEN_AVX2
+  if (__builtin_cpu_supports("avx2"))
+    return convertRowAVX2;
+#endif
+#ifdef RIPES_SCREEN_SSE2
+  return convertRowSSE2;
+#else
+  return convertRowScalar;
+#endif
+}
+
+const ConvertRowFn convertRow = selectConvertRow();
+
+} // namespace
+
+IOScreen::IOScreen(QObject *parent) : IOBase(IOType::SCREEN, parent) {
   constexpr unsigned defaultWidth = 64;
   constexpr unsigned defaultHeight = 48;
   constexpr unsigned maxSideWidth = 1024;
@@ -19,10 +88,19 @@ IOScreen::IOScreen(QWidget *parent) : IOBase(IOType::SCREEN, parent) {
   updateScreen();
 }
 
-unsigned IOScreen::pixelCount() const {
-  const unsigned width = m_parameters.at(WIDTH).value.toUInt();
-  const unsigned height = m_parameters.at(HEIGHT).value.toUInt();
-  return width * height;
+unsigned IOScreen::screenWidth() const {
+  return m_parameters.at(WIDTH).value.toUInt();
+}
+
+unsigned IOScreen::screenHeight() const {
+  return m_parameters.at(HEIGHT).value.toUInt();
+}
+
+unsigned IOScreen::pixelCount() const { return screenWidth() * screenHeight(); }
+
+QImage IOScreen::image() const {
+  QMutexLocker locker(&m_imageMutex);
+  return m_image; // Cheap: QImage is implicitly shared (copy-on-write).
 }
 
 AInt IOScreen::presentOffset() const { return pixelCount() * 4; }
@@ -65,8 +143,10 @@ void IOScreen::ioWrite(AInt offset, VInt value, unsigned) {
   }
   auto &buffer = m_buffers[m_backIdx];
   const size_t idx = offset / 4;
-  if (idx < buffer.size())
+  if (idx < buffer.size() && buffer[idx] != static_cast<uint32_t>(value)) {
     buffer[idx] = static_cast<uint32_t>(value);
+    m_dirtyRows[m_backIdx][idx / m_width] = 1;
+  }
   // Note: intentionally no repaint here; the display is only updated on
   // PRESENT.
 }
@@ -76,32 +156,60 @@ void IOScreen::present() {
   const unsigned height = m_parameters.at(HEIGHT).value.toUInt();
   const auto &buffer = m_buffers[m_backIdx];
 
-  QImage image(width, height, QImage::Format_RGB32);
-  for (unsigned y = 0; y < height; y++) {
-    auto *scanline = reinterpret_cast<QRgb *>(image.scanLine(y));
-    const unsigned rowBase = y * width;
-    for (unsigned x = 0; x < width; x++) {
-      // Force the alpha byte so the RGB32 image is fully opaque.
-      scanline[x] = 0xFF000000u | (buffer[rowBase + x] & 0x00FFFFFFu);
-    }
+  if (!m_frameSinks.empty()) {
+    // Headless: hand the back buffer directly to the sinks, skipping the image
+    // conversion and repaint.
+    for (const auto &sink : m_frameSinks)
+      sink->frame(buffer.data(), width, height, m_frameCount);
+    m_frameCount++;
+    m_backIdx ^= 1;
+    return;
   }
 
+  // Only convert the scanlines which may differ from the displayed image.
+  // Every scanline changed in the image must subsequently be considered dirty
+  // in the other buffer as well.
+  auto &dirty = m_dirtyRows[m_backIdx];
+  auto &otherDirty = m_dirtyRows[m_backIdx ^ 1];
+  int firstRow = -1;
+  int lastRow = -1;
   {
     QMutexLocker locker(&m_imageMutex);
-    m_image = image;
+    for (unsigned y = 0; y < height; y++) {
+      if (!dirty[y])
+        continue;
+      convertRow(buffer.data() + static_cast<size_t>(y) * width,
+                 reinterpret_cast<QRgb *>(m_image.scanLine(y)), width);
+      dirty[y] = 0;
+      otherDirty[y] = 1;
+      if (firstRow < 0)
+        firstRow = y;
+      lastRow = y;
+    }
   }
 
   // Flip buffers: the buffer we just presented becomes the front (displayed)
   // buffer, and software now draws into the other one.
+  m_frameCount++;
   m_backIdx ^= 1;
 
-  emit scheduleUpdate();
+  if (firstRow >= 0)
+    emit rowsPresented(firstRow, lastRow);
 }
 
+void IOScreen::addFrameSink(std::shared_ptr<ScreenFrameSink> sink) {
+  m_frameSinks.push_back(std::move(sink));
+}
+
+void IOScreen::clearFrameSinks() { m_frameSinks.clear(); }
+
 void IOScreen::reset() {
   for (auto &buffer : m_buffers)
     std::fill(buffer.begin(), buffer.end(), 0);
+  for (auto &dirty : m_dirtyRows)
+    std::fill(dirty.begin(), dirty.end(), 0);
   m_backIdx = 0;
+  m_frameCount = 0;
   {
     QMutexLocker locker(&m_imageMutex);
     m_image.fill(Qt::black);
@@ -116,7 +224,11 @@ void IOScreen::updateScreen() {
 
   for (auto &buffer : m_buffers)
     buffer.assign(nPixels, 0);
+  for (auto &dirty : m_dirtyRows)
+    dirty.assign(height, 0);
+  m_width = width;
   m_backIdx = 0;
+  m_frameCount = 0;
 
   {
     QMutexLocker locker(&m_imageMutex);
@@ -136,13 +248,18 @@ void IOScreen::updateScreen() {
                                static_cast<AInt>(nPixels) * 4,
                                /*exported=*/true});
 
-  updateGeometry();
   emit regMapChanged();
 }
 
-QSize IOScreen::minimumSizeHint() const {
-  const int width = m_parameters.at(WIDTH).value.toInt();
-  const int height = m_parameters.at(HEIGHT).value.toInt();
+IOScreenWidget::IOScreenWidget(IOScreen *screen, QWidget *parent)
+    : IOWidget(screen, parent), m_screen(screen) {
+  connect(screen, &IOScreen::rowsPresented, this,
+          &IOScreenWidget::rowsPresented);
+}
+
+QSize IOScreenWidget::minimumSizeHint() const {
+  const int width = m_screen->screenWidth();
+  const int height = m_screen->screenHeight();
 
   // Scale small screens up so they are comfortably visible, while keeping large
   // screens within a reasonable initial bound. The image is scaled to fill the
@@ -152,23 +269,40 @@ QSize IOScreen::minimumSizeHint() const {
   return QSize(width * scale, height * scale);
 }
 
-void IOScreen::paintEvent(QPaintEvent *) {
-  QImage image;
-  {
-    QMutexLocker locker(&m_imageMutex);
-    image = m_image; // Cheap: QImage is implicitly shared (copy-on-write).
-  }
+QRect IOScreenWidget::imageRect(const QSize &imageSize) const {
+  const QSize scaled = imageSize.scaled(size(), Qt::KeepAspectRatio);
+  // Center the scaled image within the widget.
+  return QRect(QPoint((width() - scaled.width()) / 2,
+                      (height() - scaled.height()) / 2),
+               scaled);
+}
+
+void IOScreenWidget::rowsPresented(unsigned firstRow, unsigned lastRow) {
+  const int rows = m_screen->screenHeight();
+  const QRect target = imageRect(QSize(m_screen->screenWidth(), rows));
+  if (rows == 0 || target.isEmpty())
+    return;
+
+  // Repaint only the widget area covering the changed scanlines (rounded
+  // outwards).
+  const int h = target.height();
+  const int top = target.top() + static_cast<int>(firstRow) * h / rows;
+  const int bottom =
+      target.top() + ((static_cast<int>(lastRow) + 1) * h + rows - 1) / rows;
+  update(QRect(target.left(), top, target.width(), bottom - top));
+}
+
+void IOScreenWidget::paintEvent(QPaintEvent *) {
+  const QImage image = m_screen->image();
   if (image.isNull())
     return;
 
   QPainter painter(this);
-  // Nearest-neighbor scaling keeps pixels crisp and is fast.
-  const QImage scaled =
-      image.scaled(size(), Qt::KeepAspectRatio, Qt::FastTransformation);
-  // Center the scaled image within the widget.
-  const int x = (width() - scaled.width()) / 2;
-  const int y = (height() - scaled.height()) / 2;
-  painter.drawImage(x, y, scaled);
+  // Draw the image scaled directly into its target area. Without
+  // SmoothPixmapTransform, scaling uses nearest-neighbor sampling (keeping
+  // pixels crisp), and only the part within the update region is rasterized,
+  // rather than rescaling the full image on every repaint.
+  painter.drawImage(imageRect(image.size()), image);
 }
 
 } // namespace Ripes
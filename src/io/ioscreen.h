@@ -3,13 +3,15 @@
 #include <QImage>
 #include <QMutex>
 #include <QVariant>
-#include <QWidget>
 
 #include <array>
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 #include "iobase.h"
+#include "iowidget.h"
+#include "screenframesink.h"
 
 namespace Ripes {
 
@@ -17,13 +19,17 @@ namespace Ripes {
  * @brief The IOScreen class
  * A raster screen peripheral.
  *
- *  - Rendering is done by blitting a single QImage (scaled to the widget),
- *    rather than drawing every pixel as an individual shape.
+ *  - Rendering (see IOScreenWidget) is done by blitting a single QImage
+ *    (scaled to the widget), rather than drawing every pixel as an individual
+ *    shape.
  *  - It is double buffered. Software always draws into the "back" buffer,
  *    mapped at the peripheral's base address. Pixel writes do NOT trigger a
  *    repaint. Only when software writes the PRESENT (doorbell) register is the
  *    back buffer scanned into an image, displayed, and the back/front buffers
  *    swapped. This avoids per-pixel repaint overhead and tearing.
+ *  - Writes are tracked per scanline. On PRESENT, only the scanlines which may
+ *    differ from the displayed image are converted (vectorized where
+ *    available), and only the corresponding part of the widget is repainted.
  *
  * Memory map (offsets from the peripheral base):
  *  - [0, width*height*4)          : framebuffer, one 24-bit RGB word per pixel
@@ -39,7 +45,7 @@ class IOScreen : public IOBase {
   enum Parameters { WIDTH, HEIGHT };
 
 public:
-  IOScreen(QWidget *parent);
+  IOScreen(QObject *parent);
   ~IOScreen() { unregister(); }
 
   virtual unsigned byteSize() const override;
@@ -61,14 +67,30 @@ public:
 
   virtual void reset() override;
 
-protected:
-  virtual void parameterChanged(unsigned) override { updateScreen(); }
+  unsigned screenWidth() const;
+  unsigned screenHeight() const;
+
+  /// Returns the most recently presented image. Thread-safe.
+  QImage image() const;
 
+  /// Attaches a frame sink. While any sink is attached, presented frames are
+  /// passed to the sinks rather than being converted into the displayed image.
+  void addFrameSink(std::shared_ptr<ScreenFrameSink> sink);
+  void clearFrameSinks();
+
+  /// Number of frames presented since the last reset.
+  uint64_t frameCount() const { return m_frameCount; }
+
+signals:
   /**
-   * QWidget drawing
+   * @brief rowsPresented
+   * Emitted when a presented frame changed the scanlines [firstRow, lastRow]
+   * of the image. May be emitted from a non-GUI thread.
    */
-  void paintEvent(QPaintEvent *event) override;
-  QSize minimumSizeHint() const override;
+  void rowsPresented(unsigned firstRow, unsigned lastRow);
+
+protected:
+  virtual void parameterChanged(unsigned) override { updateScreen(); }
 
 private:
   void updateScreen();
@@ -86,14 +108,42 @@ private:
   std::array<std::vector<uint32_t>, 2> m_buffers;
   unsigned m_backIdx = 0;
 
+  // Per-buffer scanline dirty flags. A scanline which is not flagged in
+  // m_dirtyRows[i] is guaranteed to be identical in m_buffers[i] and m_image.
+  std::array<std::vector<uint8_t>, 2> m_dirtyRows;
+  // Cached screen width, for mapping framebuffer writes to scanlines.
+  unsigned m_width = 1;
+  uint64_t m_frameCount = 0;
+
+  std::vector<std::shared_ptr<ScreenFrameSink>> m_frameSinks;
+
   // Presented image. Guarded by m_imageMutex since it is produced on the
   // processor thread (during a run) and consumed by paintEvent on the GUI
   // thread.
   QImage m_image;
-  QMutex m_imageMutex;
+  mutable QMutex m_imageMutex;
 
   std::vector<RegDesc> m_regDescs;
   std::vector<IOSymbol> m_extraSymbols;
 };
 
+class IOScreenWidget : public IOWidget {
+  Q_OBJECT
+
+public:
+  IOScreenWidget(IOScreen *screen, QWidget *parent);
+
+protected:
+  void paintEvent(QPaintEvent *event) override;
+  QSize minimumSizeHint() const override;
+
+private:
+  /// Returns the area of the widget which the (aspect-ratio preserving) scaled
+  /// screen image is drawn to.
+  QRect imageRect(const QSize &imageSize) const;
+  void rowsPresented(unsigned firstRow, unsigned lastRow);
+
+  IOScreen *m_screen = nullptr;
+};
+
 } // namespace Ripes
@@ -136,13 +136,10 @@ void ToggleButton::enterEvent(QEnterEvent *event) {
  * IO Switches
  */
 
-IOSwitches::IOSwitches(QWidget *parent) : IOBase(IOType::SWITCHES, parent) {
+IOSwitches::IOSwitches(QObject *parent) : IOBase(IOType::SWITCHES, parent) {
   // Parameters
   m_parameters[SWITCHES] = IOParam(SWITCHES, "# Switches", 8, true, 1, 32);
 
-  m_switchLayout = new QGridLayout(this);
-  setLayout(m_switchLayout);
-
   updateSwitches();
 }
 
@@ -155,21 +152,64 @@ QString IOSwitches::description() const {
   return desc.join('\n');
 }
 
+void IOSwitches::setSwitch(unsigned idx, bool on) {
+  if (on)
+    m_state.fetch_or(1u << idx, std::memory_order_relaxed);
+  else
+    m_state.fetch_and(~(1u << idx), std::memory_order_relaxed);
+}
+
 void IOSwitches::updateSwitches() {
-  const unsigned nSwitches = m_parameters.at(SWITCHES).value.toInt();
+  const unsigned nSwitches = switchCount();
+
+  m_extraSymbols.clear();
+  m_extraSymbols.push_back(IOSymbol{"N", nSwitches});
+
+  // Clear the state of any removed switches
+  if (nSwitches < 32)
+    m_state.fetch_and(vsrtl::generateBitmask(nSwitches),
+                      std::memory_order_relaxed);
+
+  // No reason to export the register, since the base pointer already points to
+  // it, and it is the only register of this component.
+  m_regDescs = {RegDesc{"Switches", RegDesc::RW::R, nSwitches, 0, false}};
+
+  emit regMapChanged();
+}
+
+VInt IOSwitches::ioRead(AInt, unsigned) {
+  return m_state.load(std::memory_order_relaxed);
+}
+
+void IOSwitches::ioWrite(AInt, VInt, unsigned) {
+  // Read-only
+  return;
+}
+
+IOSwitchesWidget::IOSwitchesWidget(IOSwitches *switches, QWidget *parent)
+    : IOWidget(switches, parent), m_switchesModel(switches) {
+  m_switchLayout = new QGridLayout(this);
+  setLayout(m_switchLayout);
+
+  peripheralChanged();
+}
+
+void IOSwitchesWidget::peripheralChanged() {
+  const unsigned nSwitches = m_switchesModel->switchCount();
   for (unsigned i = 0; i < nSwitches; ++i) {
     if (m_switches.count(i) == 0) {
       auto *sw = new ToggleButton(10, 8, true, this);
       auto *label = new QLabel(QString::number(i), this);
+      sw->setChecked(m_switchesModel->switchState(i));
+      connect(sw, &QAbstractButton::toggled, this, [this, i](bool checked) {
+        m_switchesModel->setSwitch(i, checked);
+      });
       m_switches[i] = {label, sw};
       m_switchLayout->addWidget(label, 0, i, Qt::AlignCenter);
       m_switchLayout->addWidget(sw, 1, i, Qt::AlignCenter);
     }
   }
 
-  m_extraSymbols.clear();
-  m_extraSymbols.push_back(IOSymbol{"N", nSwitches});
-
   // Remove extra switches if # of switches was reduced
   std::vector<unsigned> idxToDelete;
   for (const auto &it : m_switches) {
@@ -186,25 +226,7 @@ void IOSwitches::updateSwitches() {
     m_switches.erase(idx);
   }
 
-  // No reason to export the register, since the base pointer already points to
-  // it, and it is the only register of this component.
-  m_regDescs = {RegDesc{"Switches", RegDesc::RW::R, nSwitches, 0, false}};
-  updateGeometry();
-
-  emit regMapChanged();
-}
-
-VInt IOSwitches::ioRead(AInt, unsigned) {
-  return std::accumulate(m_switches.begin(), m_switches.end(), 0,
-                         [this](uint32_t acc, const auto &sw) {
-                           return acc | (sw.second.second->isChecked())
-                                            << sw.first;
-                         });
-}
-
-void IOSwitches::ioWrite(AInt, VInt, unsigned) {
-  // Read-only
-  return;
+  IOWidget::peripheralChanged();
 }
 
 } // namespace Ripes
@@ -8,7 +8,10 @@
 #include <QtCore/QPropertyAnimation>
 #include <QtWidgets/QAbstractButton>
 
+#include <atomic>
+
 #include "iobase.h"
+#include "iowidget.h"
 
 namespace Ripes {
 
@@ -27,6 +30,7 @@ public:
   ~ToggleButton();
 
   QSize sizeHint() const override;
+  void setChecked(bool checked);
 
 signals:
   void mOffsetChanged(int);
@@ -36,7 +40,6 @@ protected:
   void resizeEvent(QResizeEvent *) override;
   void mouseReleaseEvent(QMouseEvent *) override;
   void enterEvent(QEnterEvent *event) override;
-  void setChecked(bool checked);
 
   int offset();
   void setOffset(int value);
@@ -64,7 +67,7 @@ class IOSwitches : public IOBase {
   enum Parameters { SWITCHES };
 
 public:
-  IOSwitches(QWidget *parent);
+  IOSwitches(QObject *parent);
   ~IOSwitches() { unregister(); };
 
   virtual unsigned byteSize() const override { return 4; }
@@ -84,16 +87,39 @@ public:
   virtual VInt ioRead(AInt offset, unsigned size) override;
   virtual void ioWrite(AInt offset, VInt value, unsigned size) override;
 
+  unsigned switchCount() const {
+    return m_parameters.at(SWITCHES).value.toUInt();
+  }
+  bool switchState(unsigned idx) const {
+    return (m_state.load(std::memory_order_relaxed) >> idx) & 1;
+  }
+  void setSwitch(unsigned idx, bool on);
+
 protected:
   virtual void parameterChanged(unsigned) override { updateSwitches(); };
 
 private:
   void updateSwitches();
 
-  uint32_t regRead(AInt offset) const;
-  std::map<unsigned, std::pair<QLabel *, ToggleButton *>> m_switches;
-  QGridLayout *m_switchLayout;
+  // Switch state; bit n is the state of switch n. Written from the GUI thread
+  // and read from the processor thread, hence atomic.
+  std::atomic<uint32_t> m_state = 0;
   std::vector<RegDesc> m_regDescs;
   std::vector<IOSymbol> m_extraSymbols;
 };
+
+class IOSwitchesWidget : public IOWidget {
+  Q_OBJECT
+
+public:
+  IOSwitchesWidget(IOSwitches *switches, QWidget *parent);
+
+protected:
+  void peripheralChanged() override;
+
+private:
+  IOSwitches *m_switchesModel = nullptr;
+  std::map<unsigned, std::pair<QLabel *, ToggleButton *>> m_switches;
+  QGridLayout *m_switchLayout;
+};
 } // namespace Ripes
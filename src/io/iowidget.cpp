@@ -0,0 +1,14 @@
+#include "iowidget.h"
+
+namespace Ripes {
+
+IOWidget::IOWidget(IOBase *peripheral, QWidget *parent)
+    : QWidget(parent), m_peripheral(peripheral) {
+  peripheral->setParent(this);
+  connect(peripheral, &IOBase::scheduleUpdate, this,
+          QOverload<>::of(&QWidget::update));
+  connect(peripheral, &IOBase::paramsChanged, this,
+          [this] { peripheralChanged(); });
+}
+
+} // namespace Ripes
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QPointer>
+#include <QWidget>
+
+#include "iobase.h"
+
+namespace Ripes {
+
+/**
+ * @brief The IOWidget class
+ * Base class for the visualization of an IO peripheral model (IOBase). The
+ * widget takes ownership of its peripheral; deleting the widget deletes (and
+ * thereby unregisters) the peripheral.
+ * The widget is repainted whenever the peripheral emits scheduleUpdate(), and
+ * its geometry is updated whenever the peripheral parameters change.
+ */
+class IOWidget : public QWidget {
+  Q_OBJECT
+
+public:
+  IOWidget(IOBase *peripheral, QWidget *parent);
+
+  IOBase *peripheral() const { return m_peripheral; }
+
+protected:
+  /**
+   * @brief peripheralChanged
+   * Called after the parameters (and thereby possibly the register map) of
+   * the peripheral have changed.
+   */
+  virtual void peripheralChanged() { updateGeometry(); }
+
+private:
+  QPointer<IOBase> m_peripheral;
+};
+
+} // namespace Ripes
@@ -0,0 +1,53 @@
+#include "screenframesink.h"
+
+#include <QtEndian>
+
+namespace Ripes {
+
+ScreenFrameDumpSink::ScreenFrameDumpSink(const QString &path,
+                                         unsigned everyNth)
+    : m_file(path), m_everyNth(std::max(1u, everyNth)) {
+  m_file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+}
+
+void ScreenFrameDumpSink::frame(const uint32_t *pixels, unsigned width,
+                                unsigned height, uint64_t frameIndex) {
+  if (!m_file.isOpen() || frameIndex % m_everyNth != 0)
+    return;
+
+  // Mask and byte-swap (on big-endian hosts) one row at a time.
+  m_rowBuffer.resize(width);
+  for (unsigned y = 0; y < height; ++y) {
+    const uint32_t *row = pixels + static_cast<size_t>(y) * width;
+    for (unsigned x = 0; x < width; ++x)
+      m_rowBuffer[x] = qToLittleEndian(row[x] & 0x00FFFFFFu);
+    m_file.write(reinterpret_cast<const char *>(m_rowBuffer.data()),
+                 width * sizeof(uint32_t));
+  }
+  m_framesWritten++;
+}
+
+void ScreenFrameHashSink::frame(const uint32_t *pixels, unsigned width,
+                                unsigned height, uint64_t) {
+  m_hashes.push_back(hash(pixels, static_cast<size_t>(width) * height));
+}
+
+uint64_t ScreenFrameHashSink::hash(const uint32_t *pixels, size_t count) {
+  // 64-bit FNV-1a, consuming a full pixel per step rather than a single byte,
+  // followed by a final avalanche (splitmix64 finalizer) to spread the
+  // influence of the last pixels over all bits.
+  constexpr uint64_t fnvOffset = 0xcbf29ce484222325ull;
+  constexpr uint64_t fnvPrime = 0x100000001b3ull;
+  uint64_t h = fnvOffset;
+  for (size_t i = 0; i < count; ++i)
+    h = (h ^ (pixels[i] & 0x00FFFFFFu)) * fnvPrime;
+
+  h ^= h >> 30;
+  h *= 0xbf58476d1ce4e5b9ull;
+  h ^= h >> 27;
+  h *= 0x94d049bb133111ebull;
+  h ^= h >> 31;
+  return h;
+}
+
+} // namespace Ripes
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <QFile>
+#include <QString>
+
+#include <cstdint>
+#include <vector>
+
+namespace Ripes {
+
+/**
+ * @brief The ScreenFrameSink class
+ * Receives the frames presented by an IOScreen. When any sink is attached to a
+ * screen, presented frames are passed to the sinks instead of being converted
+ * into the displayed image, allowing frames to be verified headless at
+ * simulation speed.
+ * Frames are passed as the raw framebuffer words (row-major, one word per
+ * pixel); only the lower 24 bits (0xRRGGBB) of each word are significant.
+ * Sinks are invoked from the thread executing the processor.
+ */
+class ScreenFrameSink {
+public:
+  virtual ~ScreenFrameSink() = default;
+  virtual void frame(const uint32_t *pixels, unsigned width, unsigned height,
+                     uint64_t frameIndex) = 0;
+};
+
+/**
+ * @brief The ScreenFrameDumpSink class
+ * Streams every @p everyNth frame (starting at frame 0) to a file, as raw
+ * little-endian 32-bit 0x00RRGGBB pixel words, frames back to back.
+ */
+class ScreenFrameDumpSink : public ScreenFrameSink {
+public:
+  ScreenFrameDumpSink(const QString &path, unsigned everyNth = 1);
+
+  /// Returns true if the output file was opened successfully.
+  bool isOpen() const { return m_file.isOpen(); }
+  QString errorString() const { return m_file.errorString(); }
+  uint64_t framesWritten() const { return m_framesWritten; }
+
+  void frame(const uint32_t *pixels, unsigned width, unsigned height,
+             uint64_t frameIndex) override;
+
+private:
+  QFile m_file;
+  unsigned m_everyNth;
+  uint64_t m_framesWritten = 0;
+  std::vector<uint32_t> m_rowBuffer;
+};
+
+/**
+ * @brief The ScreenFrameHashSink class
+ * Records a 64-bit hash of the visible (24-bit) contents of each frame.
+ */
+class ScreenFrameHashSink : public ScreenFrameSink {
+public:
+  void frame(const uint32_t *pixels, unsigned width, unsigned height,
+             uint64_t frameIndex) override;
+
+  const std::vector<uint64_t> &hashes() const { return m_hashes; }
+
+  /// Hash of the 0x00RRGGBB values of @p count pixels. The hash is stable
+  /// across platforms and runs, such that it may be compared against
+  /// previously recorded reference values.
+  static uint64_t hash(const uint32_t *pixels, size_t count);
+
+private:
+  std::vector<uint64_t> m_hashes;
+};
+
+} // namespace Ripes
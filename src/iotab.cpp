@@ -66,14 +66,14 @@ IOTab::IOTab(QToolBar *toolbar, QWidget *parent)
             if (w == nullptr) {
               setPeripheralTabActive(nullptr);
             } else {
-              // MDI window -> QMainwindow -> QDockWidget -> IOBase widget...
+              // MDI window -> QMainwindow -> QDockWidget -> IOWidget...
               // Whew!
               auto *w1 = w->widget();
               auto *w2 = w1->findChildren<QDockWidget *>().at(0);
               auto *w3 = w2->widget();
-              auto *peripheral = dynamic_cast<IOBase *>(w3);
-              Q_ASSERT(peripheral != nullptr);
-              this->setPeripheralTabActive(peripheral);
+              auto *ioWidget = dynamic_cast<IOWidget *>(w3);
+              Q_ASSERT(ioWidget != nullptr);
+              this->setPeripheralTabActive(ioWidget->peripheral());
             }
           });
 
@@ -121,6 +121,8 @@ void IOTab::updateIOSymbolFilePreview() {
 
 IOBase *IOTab::createPeripheral(IOType type, int forcedID) {
   auto *peripheral = IOManager::get().createPeripheral(type, forcedID);
+  // The widget takes ownership of the peripheral.
+  auto *ioWidget = IOWidgetFactories.at(type)(peripheral, nullptr);
 
   // Create tab for peripheral
   auto *peripheralTab = new IOPeripheralTab(this, peripheral);
@@ -135,12 +137,12 @@ IOBase *IOTab::createPeripheral(IOType type, int forcedID) {
       mw); // Shouldn't be needed, but MDI windows aren't created without this?
   auto *dw = new QDockWidget();
   dw->setFeatures(dw->features() & ~QDockWidget::DockWidgetClosable);
-  dw->setWidget(peripheral);
+  dw->setWidget(ioWidget);
   dw->setAllowedAreas(Qt::AllDockWidgetAreas);
   mw->addDockWidget(Qt::TopDockWidgetArea, dw);
   auto *mdiw = m_ui->mdiArea->addSubWindow(mw);
   mdiw->setWindowTitle(peripheral->name());
-  peripheral->setFocus();
+  ioWidget->setFocus();
 
   /* The following ensures that the MDI window which a peripheral is contained
    * within is resized when the widget itself is resized. It seems a bit
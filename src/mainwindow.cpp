@@ -14,6 +14,7 @@
 #include "settingsdialog.h"
 #include "syscall/syscallviewer.h"
 #include "syscall/systemio.h"
+#include "utilities/startuptrace.h"
 #include "version/version.h"
 #include "wasmSupport.h"
 
@@ -46,18 +47,26 @@ static void clearSaveFile() {
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent), m_ui(new Ui::MainWindow) {
+  TraceSpan span("MainWindow");
   m_ui->setupUi(this);
   setWindowTitle("Ripes");
   setWindowIcon(QIcon(":/icons/logo.svg"));
   m_ui->actionOpen_wiki->setIcon(QIcon(":/icons/info.svg"));
 
   // Initialize processor handler
-  ProcessorHandler::get();
+  {
+    TraceSpan span("ProcessorHandler");
+    ProcessorHandler::get();
+  }
 
   // Initialize fonts
-  QFontDatabase::addApplicationFont(
-      ":/fonts/Inconsolata/Inconsolata-Regular.ttf");
-  QFontDatabase::addApplicationFont(":/fonts/Inconsolata/Inconsolata-Bold.ttf");
+  {
+    TraceSpan span("Fonts");
+    QFontDatabase::addApplicationFont(
+        ":/fonts/Inconsolata/Inconsolata-Regular.ttf");
+    QFontDatabase::addApplicationFont(
+        ":/fonts/Inconsolata/Inconsolata-Bold.ttf");
+  }
 
   // Create tabs
   m_stackedTabs = new QStackedWidget(this);
@@ -68,33 +77,57 @@ MainWindow::MainWindow(QWidget *parent)
 
   auto *editToolbar = addToolBar("Edit");
   editToolbar->setVisible(false);
-  auto *editTab = new EditTab(editToolbar, this);
+  EditTab *editTab;
+  {
+    TraceSpan span("EditTab");
+    editTab = new EditTab(editToolbar, this);
+  }
   m_stackedTabs->insertWidget(EditTabID, editTab);
   m_tabWidgets[EditTabID] = {editTab, editToolbar};
 
   auto *processorToolbar = addToolBar("Processor");
   processorToolbar->setVisible(false);
-  auto *processorTab = new ProcessorTab(controlToolbar, processorToolbar, this);
+  ProcessorTab *processorTab;
+  {
+    TraceSpan span("ProcessorTab");
+    processorTab = new ProcessorTab(controlToolbar, processorToolbar, this);
+  }
   m_stackedTabs->insertWidget(ProcessorTabID, processorTab);
   m_tabWidgets[ProcessorTabID] = {processorTab, processorToolbar};
 
+  // The cache tab owns the cache simulators, which must observe execution
+  // from the start; it is therefore always constructed.
   auto *cacheToolbar = addToolBar("Cache");
   cacheToolbar->setVisible(false);
-  auto *cacheTab = new CacheTab(cacheToolbar, this);
+  CacheTab *cacheTab;
+  {
+    TraceSpan span("CacheTab");
+    cacheTab = new CacheTab(cacheToolbar, this);
+  }
   m_stackedTabs->insertWidget(CacheTabID, cacheTab);
   m_tabWidgets[CacheTabID] = {cacheTab, cacheToolbar};
 
   auto *memoryToolbar = addToolBar("Memory");
   memoryToolbar->setVisible(false);
-  auto *memoryTab = new MemoryTab(memoryToolbar, this);
-  m_stackedTabs->insertWidget(MemoryTabID, memoryTab);
-  m_tabWidgets[MemoryTabID] = {memoryTab, memoryToolbar};
+  addLazyTab(MemoryTabID, memoryToolbar, [this, memoryToolbar] {
+    TraceSpan span("MemoryTab");
+    return new MemoryTab(memoryToolbar, this);
+  });
 
+  // The I/O tab restores the peripherals of the previous session upon
+  // construction, which must be mapped before any program is assembled. Only
+  // defer its construction if there is nothing to restore.
   auto *IOToolbar = addToolBar("I/O");
   IOToolbar->setVisible(false);
-  auto *IOTab = new class IOTab(IOToolbar, this);
-  m_stackedTabs->insertWidget(IOTabID, IOTab);
-  m_tabWidgets[IOTabID] = {IOTab, IOToolbar};
+  auto IOTabFactory = [this, IOToolbar] {
+    TraceSpan span("IOTab");
+    return new class IOTab(IOToolbar, this);
+  };
+  addLazyTab(IOTabID, IOToolbar, IOTabFactory);
+  if (!RipesSettings::value(RIPES_SETTING_PERIPHERAL_SETTINGS)
+           .toString()
+           .isEmpty())
+    tab(IOTabID);
 
   // Setup tab bar.
   m_ui->tabbar->addFancyTab(style()->standardIcon(QStyle::SP_FileIcon),
@@ -109,13 +142,19 @@ MainWindow::MainWindow(QWidget *parent)
           &QStackedWidget::setCurrentIndex);
   connect(m_ui->tabbar, &FancyTabBar::activeIndexChanged, editTab,
           &EditTab::updateProgramViewerHighlighting);
-  setupMenus();
+  {
+    TraceSpan span("Menus");
+    setupMenus();
+  }
 
   // setup and connect widgets
   connect(editTab, &EditTab::editorStateChanged, [this] { clearSaveFile(); });
 
   // Setup status bar
-  setupStatusBar();
+  {
+    TraceSpan span("Status bar");
+    setupStatusBar();
+  }
 
   // Reset and program reload signals
   connect(ProcessorHandler::get(), &ProcessorHandler::processorReset,
@@ -130,8 +169,11 @@ MainWindow::MainWindow(QWidget *parent)
   connect(m_ui->actionSettings, &QAction::triggered, this,
           &MainWindow::settingsTriggered);
 
-  connect(cacheTab, &CacheTab::focusAddressChanged, memoryTab,
-          &MemoryTab::setCentralAddress);
+  connect(cacheTab, &CacheTab::focusAddressChanged, this,
+          [this](AInt address) {
+            static_cast<MemoryTab *>(tab(MemoryTabID))
+                ->setCentralAddress(address);
+          });
 
   connect(this, &MainWindow::prepareSave, editTab, &EditTab::onSave);
 
@@ -200,7 +242,26 @@ void MainWindow::tabChanged(int index) {
   m_tabWidgets.at(m_currentTabID).tab->tabVisibilityChanged(false);
   m_currentTabID = static_cast<TabIndex>(index);
   m_tabWidgets.at(m_currentTabID).toolbar->setVisible(true);
-  m_tabWidgets.at(m_currentTabID).tab->tabVisibilityChanged(true);
+  tab(m_currentTabID)->tabVisibilityChanged(true);
+}
+
+void MainWindow::addLazyTab(TabIndex id, QToolBar *toolbar,
+                            std::function<RipesTab *()> factory) {
+  // Reserve the tab's index in the stacked widget until it is constructed.
+  m_stackedTabs->insertWidget(id, new QWidget(this));
+  m_tabWidgets[id] = {nullptr, toolbar, std::move(factory)};
+}
+
+RipesTab *MainWindow::tab(TabIndex id) {
+  auto &tabWidgets = m_tabWidgets.at(id);
+  if (!tabWidgets.tab) {
+    tabWidgets.tab = tabWidgets.factory();
+    QWidget *placeholder = m_stackedTabs->widget(id);
+    m_stackedTabs->removeWidget(placeholder);
+    placeholder->deleteLater();
+    m_stackedTabs->insertWidget(id, tabWidgets.tab);
+  }
+  return tabWidgets.tab;
 }
 
 void MainWindow::fitToView() {
@@ -2,6 +2,8 @@
 
 #include <QMainWindow>
 
+#include <functional>
+
 #include "assembler/program.h"
 #include "statusmanager.h"
 
@@ -24,8 +26,11 @@ class RipesTab;
 struct LoadFileParams;
 
 struct TabWidgets {
+  // nullptr until constructed, for lazily constructed tabs.
   RipesTab *tab;
   QToolBar *toolbar;
+  // Constructs the tab upon first use, for lazily constructed tabs.
+  std::function<RipesTab *()> factory = {};
 };
 
 class MainWindow : public QMainWindow {
@@ -80,6 +85,14 @@ private:
   void setupMenus();
   void setupExamplesMenu(QMenu *parent);
 
+  /// Returns the tab with the given ID, constructing it if it was deferred.
+  /// Tabs which do not own simulation state, and are not initially visible,
+  /// are only constructed once first shown (or otherwise used), to reduce
+  /// startup time.
+  RipesTab *tab(TabIndex id);
+  void addLazyTab(TabIndex id, QToolBar *toolbar,
+                  std::function<RipesTab *()> factory);
+
   Ui::MainWindow *m_ui = nullptr;
   QActionGroup *m_binaryStoreAction;
   QToolBar *m_toolbar = nullptr;
@@ -3,7 +3,10 @@
 #include <QBrush>
 #include <QFont>
 
+#include <algorithm>
+
 #include "fonts.h"
+#include "io/iomanager.h"
 #include "processorhandler.h"
 
 namespace Ripes {
@@ -17,12 +20,67 @@ int MemoryModel::columnCount(const QModelIndex &) const {
 
 int MemoryModel::rowCount(const QModelIndex &) const { return m_rowsVisible; }
 
-void MemoryModel::processorWasClocked() {
-  // Reload model
+void MemoryModel::reload() {
   beginResetModel();
+  m_rowCache.assign(m_rowsVisible, RowData());
+  m_writeGeneration = ProcessorHandler::memoryWriteSet().generation();
   endResetModel();
 }
 
+void MemoryModel::processorWasClocked() {
+  const auto changes =
+      ProcessorHandler::memoryWriteSet().changesSince(m_writeGeneration);
+  if (changes.all) {
+    reload();
+    return;
+  }
+  m_writeGeneration = changes.generation;
+
+  std::vector<bool> dirtyRows(m_rowsVisible, false);
+  for (const auto &range : changes.ranges)
+    markDirtyRows(dirtyRows, range.start, range.end);
+  // Memory mapped peripherals may change state independently of the processor,
+  // and are therefore always refreshed.
+  for (const auto &entry : IOManager::get().memoryMap())
+    markDirtyRows(dirtyRows, entry.second.startAddr, entry.second.end());
+
+  // Emit a dataChanged signal for each contiguous block of modified rows.
+  for (int row = 0; row < m_rowsVisible; ++row) {
+    if (!dirtyRows[row])
+      continue;
+    const int first = row;
+    while (row + 1 < m_rowsVisible && dirtyRows[row + 1])
+      ++row;
+    for (int i = first; i <= row; ++i)
+      m_rowCache[i].cached = false;
+    emit dataChanged(index(first, 0), index(row, columnCount() - 1));
+  }
+}
+
+void MemoryModel::markDirtyRows(std::vector<bool> &dirtyRows, AInt start,
+                                AInt end) const {
+  if (m_rowsVisible == 0 || end <= start)
+    return;
+  // Rows are ordered by decreasing address.
+  const unsigned bytes = ProcessorHandler::currentISA()->bytes();
+  const AInt top = rowAddress(0) + bytes - 1;
+  const AInt bottom = rowAddress(m_rowsVisible - 1);
+  if (bottom > top) {
+    // The visible address range wraps around the address space; be
+    // conservative.
+    std::fill(dirtyRows.begin(), dirtyRows.end(), true);
+    return;
+  }
+  if (end - 1 < bottom || start > top)
+    return;
+  const AInt first = std::max(start, bottom);
+  const AInt last = std::min(end - 1, top);
+  const auto firstRow = static_cast<int>((top - last) / bytes);
+  const auto lastRow = static_cast<int>((top - first) / bytes);
+  for (int row = firstRow; row <= lastRow; ++row)
+    dirtyRows[row] = true;
+}
+
 AInt maxAddress() {
   return vsrtl::generateBitmask(ProcessorHandler::currentISA()->bits());
 }
@@ -30,7 +88,7 @@ AInt maxAddress() {
 void MemoryModel::setCentralAddress(AInt address) {
   address = address - (address % ProcessorHandler::currentISA()->bytes());
   m_centralAddress = address;
-  processorWasClocked();
+  reload();
 }
 
 // Checks whether an overflow or underflow error occurred when calculating the
@@ -56,7 +114,7 @@ void MemoryModel::offsetCentralAddress(int rowOffset) {
   m_centralAddress = validAddressChange(m_centralAddress, newCenterAddress)
                          ? newCenterAddress
                          : m_centralAddress;
-  processorWasClocked();
+  reload();
 }
 
 QVariant MemoryModel::headerData(int section, Qt::Orientation orientation,
@@ -76,7 +134,7 @@ QVariant MemoryModel::headerData(int section, Qt::Orientation orientation,
 
 void MemoryModel::setRowsVisible(int rows) {
   m_rowsVisible = rows;
-  processorWasClocked();
+  reload();
 }
 
 QVariant MemoryModel::data(const QModelIndex &index, int role) const {
@@ -91,61 +149,29 @@ QVariant MemoryModel::data(const QModelIndex &index, int role) const {
     return QFont(Fonts::monospace, 11);
   }
 
-  const auto bytes = ProcessorHandler::currentISA()->bytes();
-  // Calculate the word-aligned address corresponding to the row of the current
-  // index. If the central address is at one of its two extrema, based on the
-  // address space of the processor, the aligned address is invalid.
-  /*
-  AInt alignedAddress;
-  bool validAddress = true;
-  if (m_centralAddress == 0x0) {
-      validAddress &= index.row() < m_rowsVisible / 2;
-  }
-  if (m_centralAddress >= maxAddress()) {
-      validAddress &= index.row() > m_rowsVisible / 2;
-  }
-  if (validAddress) {
-      alignedAddress = static_cast<AInt>(m_centralAddress) + ((((m_rowsVisible *
-  bytes) / 2) / bytes) * bytes) - (index.row() * bytes);
-  }
-*/
-
-  const AInt alignedAddress =
-      static_cast<AInt>(m_centralAddress) +
-      ((((m_rowsVisible * bytes) / 2) / bytes) * bytes) - (index.row() * bytes);
-  const bool validAddress =
-      validAddressChange(m_centralAddress, alignedAddress);
-
+  const RowData &row = rowData(index.row());
   const unsigned byteOffset = index.column() - FIXED_COLUMNS_CNT;
 
   if (index.column() == Column::Address) {
     if (role == Qt::DisplayRole) {
-      return addrData(alignedAddress, validAddress);
+      return addrData(row);
     } else if (role == Qt::ForegroundRole) {
-      // Assign a brush if one of the byte-indexed address covered by the
+      // Assign a brush if none of the byte-indexed addresses covered by the
       // aligned address has been written to
-      QVariant unusedAddressBrush;
-      for (unsigned i = 0; i < ProcessorHandler::currentISA()->bytes(); ++i) {
-        QVariant addressBrush = fgColorData(alignedAddress, i, validAddress);
-        if (addressBrush.isNull()) {
-          return addressBrush;
-        } else {
-          unusedAddressBrush = addressBrush;
-        }
-      }
-      return unusedAddressBrush;
+      if (!row.validAddress || row.presentMask == 0)
+        return QBrush(Qt::lightGray);
+      return QVariant();
     }
   } else {
     switch (role) {
     case Qt::ForegroundRole:
-      return fgColorData(alignedAddress,
-                         index.column() == Column::WordValue ? 0 : byteOffset,
-                         validAddress);
+      return fgColorData(
+          row, index.column() == Column::WordValue ? 0 : byteOffset);
     case Qt::DisplayRole:
       if (index.column() == Column::WordValue) {
-        return wordData(alignedAddress, validAddress);
+        return wordData(row);
       } else {
-        return byteData(alignedAddress, byteOffset, validAddress);
+        return byteData(row, byteOffset);
       }
     default:
       break;
@@ -155,56 +181,82 @@ QVariant MemoryModel::data(const QModelIndex &index, int role) const {
   return QVariant();
 }
 
+AInt MemoryModel::rowAddress(int row) const {
+  const auto bytes = ProcessorHandler::currentISA()->bytes();
+  return static_cast<AInt>(m_centralAddress) +
+         ((((m_rowsVisible * bytes) / 2) / bytes) * bytes) - (row * bytes);
+}
+
+const MemoryModel::RowData &MemoryModel::rowData(int row) const {
+  if (m_rowCache.size() != static_cast<size_t>(m_rowsVisible))
+    m_rowCache.assign(m_rowsVisible, RowData());
+  RowData &data = m_rowCache.at(row);
+  if (data.cached)
+    return data;
+
+  data = RowData();
+  data.cached = true;
+  data.address = rowAddress(row);
+  // If the central address is at one of its two extrema, based on the address
+  // space of the processor, the aligned address is invalid.
+  data.validAddress = validAddressChange(m_centralAddress, data.address);
+  if (!data.validAddress)
+    return data;
+
+  // Don't read bytes which are not present in memory (this would create an
+  // entry in the memory); these are displayed as X's.
+  auto &mem = ProcessorHandler::getMemory();
+  const unsigned bytes = ProcessorHandler::currentISA()->bytes();
+  for (unsigned i = 0; i < bytes; ++i)
+    if (mem.contains(data.address + i))
+      data.presentMask |= 1u << i;
+  if (data.presentMask != 0)
+    data.value = mem.readMemConst(data.address, bytes);
+  return data;
+}
+
 void MemoryModel::setRadix(Radix r) {
   m_radix = r;
-  processorWasClocked();
+  reload();
 }
 
-QVariant MemoryModel::addrData(AInt address, bool validAddress) const {
-  if (!validAddress) {
+QVariant MemoryModel::addrData(const RowData &row) const {
+  if (!row.validAddress) {
     return "-";
   }
-  return encodeRadixValue(address, Radix::Hex,
+  return encodeRadixValue(row.address, Radix::Hex,
                           ProcessorHandler::currentISA()->bytes());
 }
 
-QVariant MemoryModel::fgColorData(AInt address, AInt byteOffset,
-                                  bool validAddress) const {
-  if (!validAddress ||
-      !ProcessorHandler::getMemory().contains(address + byteOffset)) {
+QVariant MemoryModel::fgColorData(const RowData &row,
+                                  unsigned byteOffset) const {
+  if (!row.validAddress || !(row.presentMask & (1u << byteOffset))) {
     return QBrush(Qt::lightGray);
   } else {
     return QVariant(); // default
   }
 }
 
-QVariant MemoryModel::byteData(AInt address, AInt byteOffset,
-                               bool validAddress) const {
-  if (!validAddress) {
+QVariant MemoryModel::byteData(const RowData &row, unsigned byteOffset) const {
+  if (!row.validAddress) {
     return "-";
-  } else if (!ProcessorHandler::getMemory().contains(address + byteOffset)) {
-    // Dont read the memory (this will create an entry in the memory if done
-    // so). Instead, create a "fake" entry in the memory model, containing X's.
+  } else if (!(row.presentMask & (1u << byteOffset))) {
     return "X";
   } else {
-    VInt value =
-        ProcessorHandler::getMemory().readMemConst(address + byteOffset, 1);
-    return encodeRadixValue(value & 0xFF, m_radix, 1);
+    // Memory words are little-endian byte sequences.
+    return encodeRadixValue((row.value >> (byteOffset * 8)) & 0xFF, m_radix,
+                            1);
   }
 }
 
-QVariant MemoryModel::wordData(AInt address, bool validAddress) const {
-  if (!validAddress) {
+QVariant MemoryModel::wordData(const RowData &row) const {
+  if (!row.validAddress) {
     return "-";
-  } else if (!ProcessorHandler::getMemory().contains(address)) {
-    // Dont read the memory (this will create an entry in the memory if done
-    // so). Instead, create a "fake" entry in the memory model, containing X's.
+  } else if (!(row.presentMask & 1u)) {
     return "X";
   } else {
-    unsigned bytes = ProcessorHandler::currentISA()->bytes();
-    return encodeRadixValue(
-        ProcessorHandler::getMemory().readMemConst(address, bytes), m_radix,
-        bytes);
+    return encodeRadixValue(row.value, m_radix,
+                            ProcessorHandler::currentISA()->bytes());
   }
 }
 
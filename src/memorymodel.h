@@ -2,6 +2,9 @@
 
 #include <QAbstractTableModel>
 
+#include <vector>
+
+#include "memorywriteset.h"
 #include "radix.h"
 
 namespace Ripes {
@@ -26,21 +29,44 @@ public:
   Radix getRadix() const { return m_radix; }
 
 public slots:
+  /// Refreshes the rows of the model whose memory was modified since the last
+  /// refresh.
   void processorWasClocked();
   void setRowsVisible(int rows);
   void offsetCentralAddress(int rowOffset);
   void setCentralAddress(Ripes::AInt address);
 
 private:
-  QVariant addrData(AInt address, bool validAddress) const;
-  QVariant byteData(AInt address, AInt byteOffset, bool validAddress) const;
-  QVariant wordData(AInt address, bool validAddress) const;
-  QVariant fgColorData(AInt address, AInt byteOffset, bool validAddress) const;
+  /// The contents of a row, read from memory once per refresh of the row.
+  struct RowData {
+    bool cached = false;
+    bool validAddress = false;
+    AInt address = 0;
+    // Bit i is set if byte i of the row is present in memory.
+    unsigned presentMask = 0;
+    VInt value = 0;
+  };
+
+  /// Resets the model, invalidating all rows.
+  void reload();
+  AInt rowAddress(int row) const;
+  const RowData &rowData(int row) const;
+  /// Marks the rows in @p dirtyRows which cover any address in [start, end).
+  void markDirtyRows(std::vector<bool> &dirtyRows, AInt start, AInt end) const;
+
+  QVariant addrData(const RowData &row) const;
+  QVariant byteData(const RowData &row, unsigned byteOffset) const;
+  QVariant wordData(const RowData &row) const;
+  QVariant fgColorData(const RowData &row, unsigned byteOffset) const;
 
   Radix m_radix = Radix::Hex;
 
   AInt m_centralAddress = 0; // Memory address at the center of the model
   int m_rowsVisible = 0;     // Number of rows currently visible in the view
                              // associated with the model
+
+  mutable std::vector<RowData> m_rowCache;
+  // Generation of the memory write set at the last refresh.
+  MemoryWriteSet::Generation m_writeGeneration = 0;
 };
 } // namespace Ripes
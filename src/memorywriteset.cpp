@@ -0,0 +1,54 @@
+#include "memorywriteset.h"
+
+namespace Ripes {
+
+void MemoryWriteSet::recordWrite(AInt address, unsigned bytes) {
+  if (bytes == 0)
+    return;
+  std::lock_guard lock(m_lock);
+  ++m_generation;
+
+  // Consecutive writes to the same location (e.g. a loop storing to a single
+  // variable) only need to be retained once.
+  const Range range{address, address + bytes};
+  if (!m_entries.empty()) {
+    auto &last = m_entries.back();
+    if (last.range.start == range.start && last.range.end == range.end) {
+      last.generation = m_generation;
+      return;
+    }
+  }
+
+  m_entries.push_back({m_generation, range});
+  if (m_entries.size() > c_maxEntries) {
+    m_validSince = m_entries.front().generation;
+    m_entries.pop_front();
+  }
+}
+
+void MemoryWriteSet::invalidate() {
+  std::lock_guard lock(m_lock);
+  ++m_generation;
+  m_validSince = m_generation;
+  m_entries.clear();
+}
+
+MemoryWriteSet::Generation MemoryWriteSet::generation() const {
+  std::lock_guard lock(m_lock);
+  return m_generation;
+}
+
+MemoryWriteSet::Changes MemoryWriteSet::changesSince(Generation since) const {
+  std::lock_guard lock(m_lock);
+  Changes changes{m_generation, since < m_validSince, {}};
+  if (changes.all)
+    return changes;
+
+  // Entries are ordered by generation; collect those newer than since.
+  for (auto it = m_entries.rbegin();
+       it != m_entries.rend() && it->generation > since; ++it)
+    changes.ranges.push_back(it->range);
+  return changes;
+}
+
+} // namespace Ripes
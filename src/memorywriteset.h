@@ -0,0 +1,70 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "isa/isa_types.h"
+
+namespace Ripes {
+
+/**
+ * @brief The MemoryWriteSet class
+ * A bounded history of the memory address ranges written to by the processor
+ * (and by Ripes itself, e.g. through system calls), allowing memory views to
+ * refresh only the addresses which changed since they were last refreshed.
+ * Each view keeps track of the generation of the write set at its last refresh,
+ * and queries the writes since that generation. Writes may be recorded from the
+ * simulation thread while being queried from the GUI thread.
+ *
+ * If the history since a generation is not available (the history was
+ * truncated, or the memory was modified in a way which is not tracked, such as
+ * a processor reset, reversal or run), all memory must be considered modified.
+ */
+class MemoryWriteSet {
+public:
+  using Generation = uint64_t;
+  struct Range {
+    AInt start;
+    AInt end; // exclusive
+  };
+  struct Changes {
+    /// Generation of the write set at the time of the query.
+    Generation generation;
+    /// If set, all memory must be considered modified, and ranges is empty.
+    bool all;
+    std::vector<Range> ranges;
+  };
+
+  /// Records a write of @p bytes bytes at @p address.
+  void recordWrite(AInt address, unsigned bytes);
+
+  /// Marks all memory as modified.
+  void invalidate();
+
+  /// Returns the current generation of the write set.
+  Generation generation() const;
+
+  /// Returns the address ranges written since @p since. A default-initialized
+  /// (0) generation always yields all memory as modified.
+  Changes changesSince(Generation since) const;
+
+private:
+  struct Entry {
+    Generation generation;
+    Range range;
+  };
+
+  // Upper bound on the number of retained writes. Views lagging further behind
+  // than this are refreshed in their entirety.
+  static constexpr size_t c_maxEntries = 4096;
+
+  mutable std::mutex m_lock;
+  std::deque<Entry> m_entries;
+  Generation m_generation = 1;
+  // Queries for generations older than this cannot be answered precisely.
+  Generation m_validSince = 1;
+};
+
+} // namespace Ripes
@@ -3,18 +3,10 @@
 #include "processorhandler.h"
 #include "ripessettings.h"
 
-#include <vector>
+#include <algorithm>
 
 namespace Ripes {
 
-static AInt indexToAddress(unsigned index) {
-  if (auto spt = ProcessorHandler::getProgram()) {
-    return (index * ProcessorHandler::currentISA()->instrBytes()) +
-           spt->getSection(TEXT_SECTION_NAME)->address;
-  }
-  return 0;
-}
-
 PipelineDiagramModel::PipelineDiagramModel(QObject *parent)
     : QAbstractTableModel(parent) {
   // Cache the max-cycles setting and keep it up to date via its observer,
@@ -29,6 +21,8 @@ PipelineDiagramModel::PipelineDiagramModel(QObject *parent)
           &PipelineDiagramModel::processorWasClocked, Qt::DirectConnection);
   connect(ProcessorHandler::get(), &ProcessorHandler::processorReset, this,
           &PipelineDiagramModel::reset);
+
+  reset();
 }
 
 QVariant PipelineDiagramModel::headerData(int section,
@@ -38,10 +32,20 @@ QVariant PipelineDiagramModel::headerData(int section,
     return QVariant();
   if (orientation == Qt::Horizontal) {
     // Cycle number
-    return QString::number(section);
+    return QString::number(m_firstCycle + section);
   } else {
-    const auto addr = indexToAddress(section);
-    return ProcessorHandler::disassembleInstr(addr);
+    // Disassembling an instruction is comparatively expensive, and row headers
+    // are queried repeatedly by views; disassemble each row only once.
+    if (section < 0)
+      return QVariant();
+    if (static_cast<size_t>(section) >= m_rowLabels.size())
+      m_rowLabels.resize(std::max(rowCount(), section + 1));
+    auto &label = m_rowLabels.at(section);
+    if (label.isNull()) {
+      const AInt addr = m_textStart + static_cast<AInt>(section) * m_instrBytes;
+      label = ProcessorHandler::disassembleInstr(addr);
+    }
+    return label;
   }
 }
 
@@ -51,7 +55,7 @@ int PipelineDiagramModel::rowCount(const QModelIndex &) const {
 }
 
 int PipelineDiagramModel::columnCount(const QModelIndex &) const {
-  return m_cycleStageInfos.size();
+  return static_cast<int>(m_size);
 }
 
 void PipelineDiagramModel::processorWasClocked() {
@@ -70,30 +74,36 @@ void PipelineDiagramModel::processorWasClocked() {
   if (cycleCount >= maxCycles) {
     m_atMaxCycles = true;
   }
+}
 
-  // Implement sliding window to prevent continuously growing memory usage
-  // during long simulations. Only cleanup when significantly over the limit to
-  // reduce performance impact.
-  const size_t cleanupThreshold =
-      static_cast<size_t>(maxCycles * 1.2); // 20% over limit
-  if (m_cycleStageInfos.size() > cleanupThreshold) {
-    // Notify model views before data changes
-    beginResetModel();
+void PipelineDiagramModel::reset() {
+  m_atMaxCycles = false;
 
-    // Keep only the most recent maxCycles entries
-    const size_t targetSize = static_cast<size_t>(maxCycles);
-    auto it = m_cycleStageInfos.begin();
-    std::advance(it, m_cycleStageInfos.size() - targetSize);
-    m_cycleStageInfos.erase(m_cycleStageInfos.begin(), it);
+  // The ring buffer holds the configured number of cycles (+ the initial
+  // cycle). Columns grow on demand, so a large limit does not imply a large
+  // up-front allocation.
+  m_capacity = static_cast<size_t>(std::max(m_maxCycles, 0)) + 1;
+  m_head = 0;
+  m_size = 0;
+  m_firstCycle = 0;
 
-    // Notify model views after data changes
-    endResetModel();
+  m_stages.clear();
+  m_stageNames.clear();
+  const auto *proc = ProcessorHandler::getProcessor();
+  for (auto idx : proc->structure().stageIt()) {
+    m_stages.push_back(idx);
+    m_stageNames.push_back(proc->stageName(idx));
   }
-}
+  m_stageColumns.assign(m_stages.size(), {});
+
+  m_namedStates = {QString()};
+  m_namedStateIds.clear();
+
+  m_textStart = ProcessorHandler::getTextStart();
+  m_textEnd = m_textStart + ProcessorHandler::getCurrentProgramSize();
+  m_instrBytes = ProcessorHandler::currentISA()->instrBytes();
+  m_rowLabels.clear();
 
-void PipelineDiagramModel::reset() {
-  m_atMaxCycles = false;
-  m_cycleStageInfos.clear();
   gatherStageInfo();
 }
 
@@ -102,17 +112,81 @@ void PipelineDiagramModel::prepareForView() {
   endResetModel();
 }
 
+uint16_t PipelineDiagramModel::internNamedState(const QString &namedState) {
+  if (namedState.isEmpty())
+    return 0;
+  auto it = m_namedStateIds.constFind(namedState);
+  if (it != m_namedStateIds.constEnd())
+    return it.value();
+  if (m_namedStates.size() > UINT16_MAX) {
+    // Out of named state indices; the state is recorded without its name.
+    return 0;
+  }
+  const auto id = static_cast<uint16_t>(m_namedStates.size());
+  m_namedStates.push_back(namedState);
+  m_namedStateIds.insert(namedState, id);
+  return id;
+}
+
+uint32_t PipelineDiagramModel::pcToRow(AInt pc) const {
+  if (pc < m_textStart || pc >= m_textEnd)
+    return PackedStageEntry::c_invalidRow;
+  const AInt offset = pc - m_textStart;
+  if (offset % m_instrBytes != 0)
+    return PackedStageEntry::c_invalidRow;
+  return static_cast<uint32_t>(offset / m_instrBytes);
+}
+
 void PipelineDiagramModel::gatherStageInfo() {
-  long long cycleCount = ProcessorHandler::getProcessor()->getCycleCount();
-  auto stageInfoForCycle = m_cycleStageInfos.find(cycleCount);
-  if (stageInfoForCycle != m_cycleStageInfos.end()) {
+  const long long cycleCount =
+      ProcessorHandler::getProcessor()->getCycleCount();
+  const long long nextCycle = m_firstCycle + static_cast<long long>(m_size);
+  if (m_size != 0 && cycleCount >= m_firstCycle && cycleCount < nextCycle) {
     // Already gathered stage info for this cycle.
     return;
   }
-  m_cycleStageInfos[cycleCount];
-  for (auto idx : ProcessorHandler::getProcessor()->structure().stageIt())
-    m_cycleStageInfos[cycleCount][idx] =
-        ProcessorHandler::getProcessor()->stageInfo(idx);
+
+  if (m_size == 0 || cycleCount != nextCycle) {
+    // Either nothing has been recorded yet, or the recorded cycles are not
+    // contiguous with the current cycle. Restart the recording from here.
+    m_head = 0;
+    m_size = 0;
+    m_firstCycle = cycleCount;
+    for (auto &column : m_stageColumns)
+      column.clear();
+  }
+
+  size_t slot;
+  const bool wraps = m_size == m_capacity;
+  if (wraps) {
+    // Overwrite the oldest cycle.
+    beginResetModel();
+    slot = m_head;
+    m_head = (m_head + 1) % m_capacity;
+    m_firstCycle++;
+  } else {
+    slot = (m_head + m_size) % m_capacity;
+    m_size++;
+  }
+
+  const auto *proc = ProcessorHandler::getProcessor();
+  for (size_t i = 0; i < m_stages.size(); ++i) {
+    const auto info = proc->stageInfo(m_stages[i]);
+    PackedStageEntry entry;
+    entry.row = pcToRow(info.pc);
+    entry.namedState = internNamedState(info.namedState);
+    entry.state = static_cast<uint8_t>(info.state);
+    entry.valid = info.stage_valid;
+
+    auto &column = m_stageColumns[i];
+    if (slot == column.size())
+      column.push_back(entry);
+    else
+      column[slot] = entry;
+  }
+
+  if (wraps)
+    endResetModel();
 }
 
 QVariant PipelineDiagramModel::data(const QModelIndex &index, int role) const {
@@ -126,40 +200,39 @@ QVariant PipelineDiagramModel::data(const QModelIndex &index, int role) const {
   if (role != Qt::DisplayRole)
     return QVariant();
 
-  if (!m_cycleStageInfos.count(index.column()))
+  const QString text = cellText(index.row(), index.column());
+  if (text.isEmpty())
     return QVariant();
+  return text;
+}
+
+QString PipelineDiagramModel::cellText(int row, int column) const {
+  if (row < 0 || column < 0 || column >= columnCount())
+    return QString();
 
-  const AInt addr = indexToAddress(index.row());
-  const auto &stageInfo = m_cycleStageInfos.at(index.column());
+  const auto rowIdx = static_cast<uint32_t>(row);
+  const size_t slot = columnToSlot(column);
+  const bool hasPrevCycle = column > 0;
+  const size_t prevSlot = hasPrevCycle ? columnToSlot(column - 1) : 0;
 
   QStringList stagesForAddr;
-  QString stageStr;
-  for (const auto &si : stageInfo) {
-    if (si.second.pc == addr && si.second.stage_valid &&
-        si.second.state == StageInfo::State::None) {
-      if (m_cycleStageInfos.count(index.column() - 1)) {
-        const auto &prevCycleStageInfo =
-            m_cycleStageInfos.at(index.column() - 1);
-        if (prevCycleStageInfo.at(si.first).stage_valid &&
-            prevCycleStageInfo.at(si.first).pc == si.second.pc) {
-          stageStr = "-";
-          if (!si.second.namedState.isEmpty()) {
-            stageStr += " (" + si.second.namedState + ")";
-          }
-          stagesForAddr << stageStr;
-          continue;
-        }
-      }
-      stageStr = ProcessorHandler::getProcessor()->stageName(si.first);
-      if (!si.second.namedState.isEmpty()) {
-        stageStr += " (" + si.second.namedState + ")";
-      }
-      stagesForAddr << stageStr;
-    }
-  }
+  for (size_t i = 0; i < m_stages.size(); ++i) {
+    const auto &entry = m_stageColumns[i][slot];
+    if (entry.row != rowIdx || !entry.valid ||
+        entry.state != static_cast<uint8_t>(StageInfo::State::None))
+      continue;
 
-  if (stagesForAddr.size() == 0) {
-    return QVariant();
+    QString stageStr;
+    if (hasPrevCycle) {
+      const auto &prevEntry = m_stageColumns[i][prevSlot];
+      if (prevEntry.valid && prevEntry.row == entry.row)
+        stageStr = "-";
+    }
+    if (stageStr.isEmpty())
+      stageStr = m_stageNames[i];
+    if (entry.namedState != 0)
+      stageStr += " (" + m_namedStates[entry.namedState] + ")";
+    stagesForAddr << stageStr;
   }
 
   return stagesForAddr.join('/');
@@ -167,25 +240,52 @@ QVariant PipelineDiagramModel::data(const QModelIndex &index, int role) const {
 
 QString PipelineDiagramModel::toString() const {
   QString textualRepr;
+  QTextStream out(&textualRepr);
+  writeDiagram(out);
+  out.flush();
+  return textualRepr;
+}
 
-  // Copy headers
-  textualRepr.append('\t');
-  for (int j = 0; j < columnCount(); j++) {
-    textualRepr.append(headerData(j, Qt::Horizontal).toString());
-    textualRepr.append('\t');
+static QString csvEscape(const QString &field) {
+  if (!field.contains(',') && !field.contains('"') && !field.contains('\n'))
+    return field;
+  QString escaped = field;
+  escaped.replace('"', "\"\"");
+  return '"' + escaped + '"';
+}
+
+void PipelineDiagramModel::writeDiagram(QTextStream &out,
+                                        QChar separator) const {
+  const bool csv = separator == ',';
+  const auto field = [&](const QString &str) -> QString {
+    return csv ? csvEscape(str) : str;
+  };
+  const int nColumns = columnCount();
+  const int nRows = rowCount();
+
+  // Headers
+  QString line;
+  line.append(separator);
+  for (int j = 0; j < nColumns; j++) {
+    line.append(field(headerData(j, Qt::Horizontal).toString()));
+    line.append(separator);
   }
-  textualRepr.append('\n');
-  // Copy data
-  for (int i = 0; i < rowCount(); ++i) {
-    textualRepr.append(headerData(i, Qt::Vertical).toString());
-    textualRepr.append('\t');
-    for (int j = 0; j < columnCount(); j++) {
-      textualRepr.append(data(index(i, j)).toString());
-      textualRepr.append('\t');
+  line.append('\n');
+  out << line;
+
+  // Data. Each row is written as soon as it has been formatted, leaving the
+  // buffering to the stream.
+  for (int i = 0; i < nRows; ++i) {
+    line.clear();
+    line.append(field(headerData(i, Qt::Vertical).toString()));
+    line.append(separator);
+    for (int j = 0; j < nColumns; j++) {
+      line.append(field(cellText(i, j)));
+      line.append(separator);
     }
-    textualRepr.append('\n');
+    line.append('\n');
+    out << line;
   }
-  return textualRepr;
 }
 
 } // namespace Ripes
@@ -2,6 +2,10 @@
 
 #include "processors/interface/ripesprocessor.h"
 #include <QAbstractTableModel>
+#include <QHash>
+#include <QTextStream>
+
+#include <vector>
 
 namespace Ripes {
 
@@ -20,21 +24,83 @@ public:
                       int role = Qt::DisplayRole) const override;
   void prepareForView();
 
+  /// Returns the text of the diagram cell at (@p row, @p column). This is the
+  /// DisplayRole data of the cell, without the QModelIndex/QVariant overhead.
+  QString cellText(int row, int column) const;
+
   /// Returns a tab-separated stringified version of this pipeline diagram.
   QString toString() const;
 
+  /// Writes the pipeline diagram (including headers) to @p out, one row at a
+  /// time, with fields separated by @p separator. If @p separator is ',', the
+  /// output is CSV-formatted (fields are quoted where necessary). This avoids
+  /// materializing the whole diagram in memory, and should be preferred over
+  /// toString() for large diagrams.
+  void writeDiagram(QTextStream &out, QChar separator = '\t') const;
+
 public slots:
   void processorWasClocked();
   void reset();
 
 private:
+  /**
+   * @brief The PackedStageEntry struct
+   * Compact representation of the StageInfo of a single stage in a single
+   * cycle. Instead of the PC, the diagram row (instruction index within the
+   * .text section) is stored. Named states are stored as an index into
+   * m_namedStates.
+   */
+  struct PackedStageEntry {
+    static constexpr uint32_t c_invalidRow = UINT32_MAX;
+    uint32_t row = c_invalidRow;
+    uint16_t namedState = 0;
+    uint8_t state = 0;
+    uint8_t valid = 0;
+  };
+  static_assert(sizeof(PackedStageEntry) == 8,
+                "PackedStageEntry should stay compact");
+
   void gatherStageInfo();
 
+  /// Returns the index of @p namedState in m_namedStates, inserting it if not
+  /// already present.
+  uint16_t internNamedState(const QString &namedState);
+
+  /// Maps a PC to a diagram row, or PackedStageEntry::c_invalidRow if the PC
+  /// does not correspond to an instruction of the .text section.
+  uint32_t pcToRow(AInt pc) const;
+
+  /// Maps a column (0 = oldest recorded cycle) to a ring buffer slot.
+  size_t columnToSlot(int column) const {
+    return (m_head + static_cast<size_t>(column)) % m_capacity;
+  }
+
   /**
-   * @brief m_cycleStageInfos
-   * map<cycle, map<stageId, stageInfo>>
+   * @brief m_stageColumns
+   * Columnar ring buffer of recorded stage information; one column per stage
+   * (indexed as in m_stages), with one entry per recorded cycle. The oldest
+   * recorded cycle is located at slot m_head.
    */
-  std::map<long long, std::map<StageIndex, StageInfo>> m_cycleStageInfos;
+  std::vector<std::vector<PackedStageEntry>> m_stageColumns;
+  std::vector<StageIndex> m_stages;
+  std::vector<QString> m_stageNames;
+  size_t m_head = 0;
+  size_t m_size = 0;
+  size_t m_capacity = 1;
+  // Cycle number of the oldest recorded cycle (column 0).
+  long long m_firstCycle = 0;
+
+  // Interned named states. Index 0 is always the empty string.
+  std::vector<QString> m_namedStates;
+  QHash<QString, uint16_t> m_namedStateIds;
+
+  // Parameters of the PC to row mapping, cached upon reset.
+  AInt m_textStart = 0;
+  AInt m_textEnd = 0;
+  unsigned m_instrBytes = 4;
+
+  // Lazily disassembled row labels.
+  mutable std::vector<QString> m_rowLabels;
 
   /**
    * @brief m_atMaxCycles
@@ -0,0 +1,205 @@
+#include "pipelinediagramview.h"
+
+#include <QPaintEvent>
+#include <QPainter>
+#include <QScrollBar>
+
+#include <algorithm>
+
+#include "pipelinediagrammodel.h"
+
+namespace Ripes {
+
+PipelineDiagramView::PipelineDiagramView(QWidget *parent)
+    : QAbstractScrollArea(parent) {
+  // Each tile holds at most c_tileSize^2 (mostly empty) cell strings; keep
+  // enough tiles around to cover a few screens worth of scrolling.
+  m_tiles.setMaxCost(256);
+  updateCellMetrics();
+}
+
+void PipelineDiagramView::setModel(PipelineDiagramModel *model) {
+  if (m_model)
+    m_model->disconnect(this);
+  m_model = model;
+  if (m_model) {
+    connect(m_model, &QAbstractItemModel::modelReset, this,
+            &PipelineDiagramView::reload);
+    connect(m_model, &QAbstractItemModel::layoutChanged, this,
+            &PipelineDiagramView::reload);
+  }
+  reload();
+}
+
+void PipelineDiagramView::reload() {
+  m_tiles.clear();
+  m_rows = m_model ? m_model->rowCount() : 0;
+  m_columns = m_model ? m_model->columnCount() : 0;
+  updateCellMetrics();
+  updateScrollBars();
+  viewport()->update();
+}
+
+void PipelineDiagramView::updateCellMetrics() {
+  const QFontMetrics fm(font());
+  const int margin = fm.horizontalAdvance(' ') * 2;
+  // Cells are uniformly sized, such that the visible window can be determined
+  // without inspecting cell contents. Wide enough for stage names such as
+  // "MEM/WB" and for cycle numbers up to 7 digits.
+  m_cellWidth = fm.horizontalAdvance(QStringLiteral("0000000")) + margin;
+  m_cellHeight = fm.height() + margin / 2;
+  m_columnHeaderHeight = m_cellHeight;
+  // Disassembled instructions are elided to fit the row header.
+  m_rowHeaderWidth = fm.horizontalAdvance(QString(28, '0')) + margin;
+}
+
+void PipelineDiagramView::updateScrollBars() {
+  const int visibleWidth = viewport()->width() - m_rowHeaderWidth;
+  const int visibleHeight = viewport()->height() - m_columnHeaderHeight;
+
+  horizontalScrollBar()->setSingleStep(m_cellWidth);
+  horizontalScrollBar()->setPageStep(std::max(visibleWidth, m_cellWidth));
+  horizontalScrollBar()->setRange(
+      0, std::max(0, m_columns * m_cellWidth - visibleWidth));
+
+  verticalScrollBar()->setSingleStep(m_cellHeight);
+  verticalScrollBar()->setPageStep(std::max(visibleHeight, m_cellHeight));
+  verticalScrollBar()->setRange(
+      0, std::max(0, m_rows * m_cellHeight - visibleHeight));
+}
+
+void PipelineDiagramView::resizeEvent(QResizeEvent *event) {
+  QAbstractScrollArea::resizeEvent(event);
+  updateScrollBars();
+}
+
+void PipelineDiagramView::scrollContentsBy(int, int) {
+  viewport()->update();
+}
+
+const PipelineDiagramView::Tile &PipelineDiagramView::tile(int tileRow,
+                                                           int tileColumn) {
+  const quint64 key = (static_cast<quint64>(tileRow) << 32) |
+                      static_cast<quint32>(tileColumn);
+  if (auto *cached = m_tiles.object(key))
+    return *cached;
+
+  auto *t = new Tile();
+  t->cells.resize(c_tileSize * c_tileSize);
+  const int rowStart = tileRow * c_tileSize;
+  const int colStart = tileColumn * c_tileSize;
+  const int rowEnd = std::min(rowStart + c_tileSize, m_rows);
+  const int colEnd = std::min(colStart + c_tileSize, m_columns);
+  for (int r = rowStart; r < rowEnd; ++r)
+    for (int c = colStart; c < colEnd; ++c)
+      t->cells[(r - rowStart) * c_tileSize + (c - colStart)] =
+          m_model->cellText(r, c);
+
+  m_tiles.insert(key, t, 1);
+  return *m_tiles.object(key);
+}
+
+void PipelineDiagramView::paintEvent(QPaintEvent *event) {
+  QPainter painter(viewport());
+  painter.fillRect(event->rect(), palette().base());
+  if (!m_model || m_rows == 0)
+    return;
+
+  const int xOffset = horizontalScrollBar()->value();
+  const int yOffset = verticalScrollBar()->value();
+  const int areaWidth = viewport()->width() - m_rowHeaderWidth;
+  const int areaHeight = viewport()->height() - m_columnHeaderHeight;
+  if (areaWidth <= 0 || areaHeight <= 0)
+    return;
+
+  // The visible window of cells.
+  const int firstRow = yOffset / m_cellHeight;
+  const int lastRow =
+      std::min(m_rows - 1, (yOffset + areaHeight) / m_cellHeight);
+  const int firstCol = xOffset / m_cellWidth;
+  const int lastCol =
+      std::min(m_columns - 1, (xOffset + areaWidth) / m_cellWidth);
+
+  const auto cellRect = [&](int row, int col) {
+    return QRect(m_rowHeaderWidth + col * m_cellWidth - xOffset,
+                 m_columnHeaderHeight + row * m_cellHeight - yOffset,
+                 m_cellWidth, m_cellHeight);
+  };
+
+  // Cells
+  const QPen gridPen(palette().mid().color());
+  painter.save();
+  painter.setClipRect(QRect(m_rowHeaderWidth, m_columnHeaderHeight, areaWidth,
+                            areaHeight));
+  painter.setPen(gridPen);
+  for (int row = firstRow; row <= lastRow; ++row) {
+    const QRect r = cellRect(row, 0);
+    painter.drawLine(m_rowHeaderWidth, r.bottom(),
+                     m_rowHeaderWidth + areaWidth, r.bottom());
+  }
+  for (int col = firstCol; col <= lastCol; ++col) {
+    const QRect r = cellRect(0, col);
+    painter.drawLine(r.right(), m_columnHeaderHeight, r.right(),
+                     m_columnHeaderHeight + areaHeight);
+  }
+
+  painter.setPen(palette().text().color());
+  for (int tileRow = firstRow / c_tileSize; tileRow <= lastRow / c_tileSize;
+       ++tileRow) {
+    for (int tileCol = firstCol / c_tileSize; tileCol <= lastCol / c_tileSize;
+         ++tileCol) {
+      const Tile &t = tile(tileRow, tileCol);
+      const int rowStart = std::max(firstRow, tileRow * c_tileSize);
+      const int rowEnd = std::min(lastRow, (tileRow + 1) * c_tileSize - 1);
+      const int colStart = std::max(firstCol, tileCol * c_tileSize);
+      const int colEnd = std::min(lastCol, (tileCol + 1) * c_tileSize - 1);
+      for (int row = rowStart; row <= rowEnd; ++row) {
+        for (int col = colStart; col <= colEnd; ++col) {
+          const QString &text =
+              t.cells[(row - tileRow * c_tileSize) * c_tileSize +
+                      (col - tileCol * c_tileSize)];
+          if (!text.isEmpty())
+            painter.drawText(cellRect(row, col), Qt::AlignCenter, text);
+        }
+      }
+    }
+  }
+  painter.restore();
+
+  // Headers
+  const QFontMetrics fm(font());
+  const QBrush headerBrush = palette().button();
+  painter.fillRect(QRect(0, 0, viewport()->width(), m_columnHeaderHeight),
+                   headerBrush);
+  painter.fillRect(QRect(0, 0, m_rowHeaderWidth, viewport()->height()),
+                   headerBrush);
+  painter.setPen(palette().buttonText().color());
+
+  painter.save();
+  painter.setClipRect(
+      QRect(m_rowHeaderWidth, 0, areaWidth, m_columnHeaderHeight));
+  for (int col = firstCol; col <= lastCol; ++col) {
+    QRect r = cellRect(0, col);
+    r.moveTop(0);
+    painter.drawText(r, Qt::AlignCenter,
+                     m_model->headerData(col, Qt::Horizontal).toString());
+  }
+  painter.restore();
+
+  painter.save();
+  painter.setClipRect(
+      QRect(0, m_columnHeaderHeight, m_rowHeaderWidth, areaHeight));
+  const int labelMargin = fm.horizontalAdvance(' ');
+  for (int row = firstRow; row <= lastRow; ++row) {
+    QRect r = cellRect(row, 0);
+    r.setLeft(labelMargin);
+    r.setWidth(m_rowHeaderWidth - 2 * labelMargin);
+    const QString label = fm.elidedText(
+        m_model->headerData(row, Qt::Vertical).toString(), Qt::ElideRight,
+        r.width());
+    painter.drawText(r, Qt::AlignLeft | Qt::AlignVCenter, label);
+  }
+  painter.restore();
+}
+
+} // namespace Ripes
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <QAbstractScrollArea>
+#include <QCache>
+
+#include <vector>
+
+namespace Ripes {
+class PipelineDiagramModel;
+
+/**
+ * @brief The PipelineDiagramView class
+ * A virtualized view of a PipelineDiagramModel. Unlike a QTableView, which
+ * maintains per-section header state and may query every cell for sizing, this
+ * view uses uniform cell sizes and only queries and paints the cells within the
+ * visible cycle/instruction window. Cell contents are fetched in tiles of
+ * c_tileSize x c_tileSize cells, which are cached, such that scrolling over
+ * previously visited areas does not re-query the model.
+ */
+class PipelineDiagramView : public QAbstractScrollArea {
+  Q_OBJECT
+
+public:
+  PipelineDiagramView(QWidget *parent = nullptr);
+
+  void setModel(PipelineDiagramModel *model);
+
+public slots:
+  /// Re-reads the model dimensions and drops all cached tiles.
+  void reload();
+
+protected:
+  void paintEvent(QPaintEvent *event) override;
+  void resizeEvent(QResizeEvent *event) override;
+  void scrollContentsBy(int dx, int dy) override;
+
+private:
+  static constexpr int c_tileSize = 32;
+
+  /// A tile of c_tileSize x c_tileSize cell texts (row-major).
+  struct Tile {
+    std::vector<QString> cells;
+  };
+
+  void updateCellMetrics();
+  void updateScrollBars();
+  const Tile &tile(int tileRow, int tileColumn);
+
+  PipelineDiagramModel *m_model = nullptr;
+  QCache<quint64, Tile> m_tiles;
+
+  int m_rows = 0;
+  int m_columns = 0;
+  int m_cellWidth = 0;
+  int m_cellHeight = 0;
+  int m_rowHeaderWidth = 0;
+  int m_columnHeaderHeight = 0;
+};
+
+} // namespace Ripes
@@ -2,7 +2,8 @@
 #include "ui_pipelinediagramwidget.h"
 
 #include <QClipboard>
-#include <QHeaderView>
+#include <QFileDialog>
+#include <QMessageBox>
 
 #include "pipelinediagrammodel.h"
 #include "ripessettings.h"
@@ -17,8 +18,8 @@ PipelineDiagramWidget::PipelineDiagramWidget(PipelineDiagramModel *model,
   m_stageModel = model;
   m_ui->pipelineDiagramView->setModel(m_stageModel);
 
-  m_ui->pipelineDiagramView->resizeColumnsToContents();
   m_ui->copy->setIcon(QIcon(":/icons/documents.svg"));
+  m_ui->exportDiagram->setIcon(QIcon(":/icons/saveas.svg"));
 
   m_stageModel->prepareForView();
 }
@@ -28,26 +29,31 @@ PipelineDiagramWidget::~PipelineDiagramWidget() { delete m_ui; }
 void PipelineDiagramWidget::on_copy_clicked() {
   // Copy entire table to clipboard, including headers
   Q_ASSERT(m_stageModel != nullptr);
-  QString textualRepr;
+  QApplication::clipboard()->setText(m_stageModel->toString());
+}
 
-  // Copy headers
-  textualRepr.append('\t');
-  for (int j = 0; j < m_stageModel->columnCount(); j++) {
-    textualRepr.append(m_stageModel->headerData(j, Qt::Horizontal).toString());
-    textualRepr.append('\t');
-  }
-  textualRepr.append('\n');
-  // Copy data
-  for (int i = 0; i < m_stageModel->rowCount(); ++i) {
-    textualRepr.append(m_stageModel->headerData(i, Qt::Vertical).toString());
-    textualRepr.append('\t');
-    for (int j = 0; j < m_stageModel->columnCount(); j++) {
-      textualRepr.append(
-          m_stageModel->data(m_stageModel->index(i, j)).toString());
-      textualRepr.append('\t');
-    }
-    textualRepr.append('\n');
+void PipelineDiagramWidget::on_exportDiagram_clicked() {
+  Q_ASSERT(m_stageModel != nullptr);
+  QString selectedFilter;
+  const QString fileName = QFileDialog::getSaveFileName(
+      this, "Export pipeline diagram", "",
+      "Tab separated (*.txt *.tsv);;CSV (*.csv)", &selectedFilter);
+  if (fileName.isEmpty())
+    return;
+
+  QFile file(fileName);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate |
+                 QIODevice::Text)) {
+    QMessageBox::warning(this, "Export pipeline diagram",
+                         "Could not open file '" + fileName + "'.");
+    return;
   }
-  QApplication::clipboard()->setText(textualRepr);
+
+  // The diagram is streamed to the file, such that large diagrams do not have
+  // to be materialized in memory.
+  const bool csv = selectedFilter.startsWith("CSV") ||
+                   fileName.endsWith(".csv", Qt::CaseInsensitive);
+  QTextStream out(&file);
+  m_stageModel->writeDiagram(out, csv ? ',' : '\t');
 }
 } // namespace Ripes
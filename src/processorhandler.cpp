@@ -10,10 +10,16 @@
 #include "io/iomanager.h"
 
 #include "syscall/riscv_syscall.h"
+#include "syscall/systemio.h"
 
+#include <QElapsedTimer>
 #include <QMessageBox>
 #include <QtConcurrent/QtConcurrent>
 
+#include <chrono>
+#include <climits>
+#include <utility>
+
 namespace Ripes {
 
 ProcessorHandler::ProcessorHandler() {
@@ -77,6 +83,19 @@ ProcessorHandler::ProcessorHandler() {
   connect(&m_runWatcher, &QFutureWatcher<void>::finished, this,
           [] { ProcessorStatusManager::clearStatus(); });
 
+  // Keep the segment base pointers of the current assembler up to date with
+  // the settings
+  for (const auto *setting :
+       {RIPES_SETTING_ASSEMBLER_TEXTSTART, RIPES_SETTING_ASSEMBLER_DATASTART,
+        RIPES_SETTING_ASSEMBLER_BSSSTART}) {
+    connect(RipesSettings::getObserver(setting), &SettingObserver::modified,
+            this, [this] {
+              if (m_currentAssembler)
+                m_currentAssembler->setSegmentBases(
+                    Assembler::segmentBasesFromSettings());
+            });
+  }
+
   // Connect relevant settings changes to VSRTL
   connect(RipesSettings::getObserver(RIPES_SETTING_REWINDSTACKSIZE),
           &SettingObserver::modified, this, [this](const auto &size) {
@@ -104,11 +123,26 @@ ProcessorHandler::ProcessorHandler() {
   // Reset VCD trace status.
   RipesSettings::getObserver(RIPES_SETTING_VCD_TRACE_FILE)->trigger();
 
+  connect(RipesSettings::getObserver(RIPES_SETTING_VIRTUAL_TIME_FREQ),
+          &SettingObserver::modified, this, [](const auto &freq) {
+            setVirtualTimeFrequency(freq.toULongLong());
+          });
+  m_virtualTimeFreq =
+      RipesSettings::value(RIPES_SETTING_VIRTUAL_TIME_FREQ).toULongLong();
+
+  // Memory modifications which are not tracked per write.
+  for (auto signal :
+       {&ProcessorHandler::processorReset, &ProcessorHandler::processorReversed,
+        &ProcessorHandler::runFinished, &ProcessorHandler::programChanged,
+        &ProcessorHandler::processorChanged})
+    connect(this, signal, this, [this] { m_memoryWriteSet.invalidate(); });
+
   // Reset request handling
   connect(RipesSettings::getObserver(RIPES_GLOBALSIGNAL_REQRESET),
           &SettingObserver::modified, this, &ProcessorHandler::_reset);
 
-  m_syscallManager = std::make_unique<RISCVSyscallManager>();
+  m_syscallManager =
+      std::make_unique<RISCVSyscallManager>(m_syscallEnvironment);
   m_constructing = false;
 }
 
@@ -163,6 +197,45 @@ void ProcessorHandler::_loadProgram(const std::shared_ptr<Program> &p) {
 
 void ProcessorHandler::_writeMem(AInt address, VInt value, int size) {
   m_currentProcessor->getMemory().writeMem(address, value, size);
+  m_memoryWriteSet.recordWrite(address, size);
+}
+
+void ProcessorHandler::_readMemBlock(AInt address, char *dst, size_t size) {
+  auto &mem = m_currentProcessor->getMemory();
+  size_t i = 0;
+  // Unaligned head
+  for (; i < size && (address + i) % sizeof(VInt) != 0; ++i)
+    dst[i] = static_cast<char>(mem.readMemConst(address + i, 1) & 0xFF);
+  // Aligned words. Memory words are little-endian byte sequences.
+  for (; i + sizeof(VInt) <= size; i += sizeof(VInt)) {
+    const VInt word = mem.readMemConst(address + i, sizeof(VInt));
+    for (unsigned b = 0; b < sizeof(VInt); ++b)
+      dst[i + b] = static_cast<char>((word >> (b * CHAR_BIT)) & 0xFF);
+  }
+  // Tail
+  for (; i < size; ++i)
+    dst[i] = static_cast<char>(mem.readMemConst(address + i, 1) & 0xFF);
+}
+
+void ProcessorHandler::_writeMemBlock(AInt address, const char *src,
+                                      size_t size) {
+  auto &mem = m_currentProcessor->getMemory();
+  size_t i = 0;
+  // Unaligned head
+  for (; i < size && (address + i) % sizeof(VInt) != 0; ++i)
+    mem.writeMem(address + i, static_cast<uint8_t>(src[i]), 1);
+  // Aligned words. Memory words are little-endian byte sequences.
+  for (; i + sizeof(VInt) <= size; i += sizeof(VInt)) {
+    VInt word = 0;
+    for (unsigned b = 0; b < sizeof(VInt); ++b)
+      word |= static_cast<VInt>(static_cast<uint8_t>(src[i + b]))
+              << (b * CHAR_BIT);
+    mem.writeMem(address + i, word, sizeof(VInt));
+  }
+  // Tail
+  for (; i < size; ++i)
+    mem.writeMem(address + i, static_cast<uint8_t>(src[i]), 1);
+  m_memoryWriteSet.recordWrite(address, size);
 }
 
 vsrtl::core::AddressSpaceMM &ProcessorHandler::_getMemory() {
@@ -206,6 +279,15 @@ void ProcessorHandler::_clock() {
   }
 }
 
+void ProcessorHandler::_reverse() {
+  std::unique_lock l(m_clockLock);
+  m_currentProcessor->reverseProcessor();
+}
+
+bool ProcessorHandler::_isReversible() const {
+  return m_currentProcessor->canReverseProcessor();
+}
+
 void ProcessorHandler::_run() {
   ProcessorStatusManager::setStatusTimed("Running...");
   emit runStarted();
@@ -230,6 +312,7 @@ void ProcessorHandler::_run() {
       m_currentProcessor->clockUnguarded();
     }
 
+    _syncPendingDataAccess();
     m_running.store(false, std::memory_order_relaxed);
 
     if (vsrtl_proc) {
@@ -239,6 +322,52 @@ void ProcessorHandler::_run() {
   }));
 }
 
+bool ProcessorHandler::_runBlocking(unsigned timeoutMs,
+                                    const std::function<void()> &progress,
+                                    unsigned progressIntervalMs) {
+  auto *vsrtl_proc = dynamic_cast<vsrtl::SimDesign *>(m_currentProcessor.get());
+  if (vsrtl_proc)
+    vsrtl_proc->setEnableSignals(false);
+  m_running.store(true, std::memory_order_relaxed);
+  m_blockingRun.store(true, std::memory_order_relaxed);
+
+  // The timeout and progress deadlines are only checked once per batch of
+  // cycles, to keep clock reads out of the simulation loop.
+  constexpr unsigned cyclesPerCheck = 1 << 14;
+  QElapsedTimer elapsed;
+  elapsed.start();
+  qint64 nextProgressMs = progressIntervalMs;
+  bool timedOut = false;
+  bool stopped = false;
+  while (!stopped) {
+    for (unsigned i = 0; i < cyclesPerCheck; ++i) {
+      if (_checkBreakpoint() || m_currentProcessor->finished() ||
+          m_stopRunningFlag) {
+        stopped = true;
+        break;
+      }
+      m_currentProcessor->clockUnguarded();
+    }
+    const qint64 elapsedMs = elapsed.elapsed();
+    if (!stopped && timeoutMs != 0 && elapsedMs >= timeoutMs) {
+      timedOut = true;
+      break;
+    }
+    if (progress && elapsedMs >= nextProgressMs) {
+      progress();
+      nextProgressMs = elapsedMs + progressIntervalMs;
+    }
+  }
+
+  _syncPendingDataAccess();
+  m_running.store(false, std::memory_order_relaxed);
+  m_blockingRun.store(false, std::memory_order_relaxed);
+  if (vsrtl_proc)
+    vsrtl_proc->setEnableSignals(true);
+  m_stopRunningFlag = false;
+  return !timedOut;
+}
+
 void ProcessorHandler::_relayClockedNonRun() {
   // Invoked (via Gallant) on every processor clock, potentially from the run
   // worker thread. During a Run we must not post a per-cycle event to the GUI
@@ -248,6 +377,16 @@ void ProcessorHandler::_relayClockedNonRun() {
   if (m_running.load(std::memory_order_relaxed))
     return;
 
+  // Record the data memory write committed by the cycle which just completed.
+  // Processors with a clocked data memory report the access to be committed at
+  // the next clock edge, i.e. the committed access was reported following the
+  // previous cycle.
+  MemoryAccess committed = m_currentProcessor->dataMemAccess();
+  if (m_currentProcessor->dataMemAccessPending())
+    std::swap(committed, m_pendingDataAccess);
+  if (committed.type == MemoryAccess::Write)
+    m_memoryWriteSet.recordWrite(committed.address, committed.bytes);
+
   // Not running (e.g. single-stepping), which may still occur on a thread-pool
   // thread; hop to this object's thread safely before touching GUI state.
   QMetaObject::invokeMethod(
@@ -259,6 +398,10 @@ void ProcessorHandler::_relayClockedNonRun() {
       Qt::AutoConnection);
 }
 
+void ProcessorHandler::_syncPendingDataAccess() {
+  m_pendingDataAccess = m_currentProcessor->dataMemAccess();
+}
+
 void ProcessorHandler::_setBreakpoint(const AInt address, bool enabled) {
   if (enabled && _isExecutableAddress(address)) {
     m_breakpoints.insert(address);
@@ -304,7 +447,10 @@ void ProcessorHandler::_clearBreakpoints() { m_breakpoints.clear(); }
 
 void ProcessorHandler::createAssemblerForCurrentISA() {
   m_currentAssembler =
-      Assembler::constructAssemblerDynamic(m_currentProcessor->implementsISA());
+      Assembler::getCachedAssembler(m_currentProcessor->implementsISA());
+  // The assembler is shared; the settings may have changed since it was last
+  // used by this handler.
+  m_currentAssembler->setSegmentBases(Assembler::segmentBasesFromSettings());
 }
 
 void ProcessorHandler::_reset() {
@@ -314,6 +460,8 @@ void ProcessorHandler::_reset() {
 
   SystemIO::abortSyscall();
   getProcessorNonConst()->resetProcessor();
+  m_hostInputObserved = false;
+  m_hostFilesAccessed = false;
 
   // Rewrite register initializations
   for (const auto &regFileInit : m_currentRegInits) {
@@ -381,6 +529,12 @@ void ProcessorHandler::_selectProcessor(const ProcessorID &id,
   // and out of order.
   m_currentProcessor->processorWasClocked.Connect(
       this, &ProcessorHandler::processorClocked);
+  // The pending data memory access must be known before the next clock, and is
+  // thus updated directly.
+  m_currentProcessor->processorWasReset.Connect(
+      this, &ProcessorHandler::_syncPendingDataAccess);
+  m_currentProcessor->processorWasReversed.Connect(
+      this, &ProcessorHandler::_syncPendingDataAccess);
 
   m_signalWrappers.push_back(std::unique_ptr<vsrtl::GallantSignalWrapperBase>(
       new vsrtl::GallantSignalWrapper(
@@ -439,25 +593,44 @@ QString ProcessorHandler::_disassembleInstr(const AInt addr) const {
 }
 
 void ProcessorHandler::syscallTrap() {
-  auto futureWatcher = QFutureWatcher<bool>();
-  futureWatcher.setFuture(QtConcurrent::run([this] {
-    if (auto reg = _currentISA()->syscallReg(); reg.has_value()) {
-      const unsigned int function =
-          m_currentProcessor->getRegister(reg->file->regFileName(), reg->index);
-      return m_syscallManager->execute(function);
+  bool success = false;
+  if (auto reg = _currentISA()->syscallReg(); reg.has_value()) {
+    const unsigned int function =
+        m_currentProcessor->getRegister(reg->file->regFileName(), reg->index);
+    const Syscall *syscall = m_syscallManager->lookup(function);
+    if (syscall && syscall->mayBlock()) {
+      // Blocking syscalls wait on input which is provided through the GUI
+      // thread; execute these on a separate thread.
+      auto futureWatcher = QFutureWatcher<bool>();
+      futureWatcher.setFuture(QtConcurrent::run(
+          [this, function] { return m_syscallManager->execute(function); }));
+      futureWatcher.waitForFinished();
+      success = futureWatcher.result();
     } else {
-      return false;
+      // All other syscalls are executed directly, avoiding a thread hop for
+      // each ecall.
+      success = m_syscallManager->execute(function);
     }
-  }));
+  }
 
-  futureWatcher.waitForFinished();
-  if (!futureWatcher.result()) {
+  if (!success) {
     // Syscall handling failed, stop running processor
     setStopRunFlag();
   }
 }
 
-bool ProcessorHandler::_isRunning() { return !m_runWatcher.isFinished(); }
+bool ProcessorHandler::_isRunning() {
+  return !m_runWatcher.isFinished() ||
+         m_blockingRun.load(std::memory_order_relaxed);
+}
+
+uint64_t ProcessorHandler::_timeNanos() const {
+  if (m_virtualTimeFreq == 0)
+    m_hostInputObserved = true;
+  return SyscallEnvironment::timeNanos(
+      static_cast<uint64_t>(m_currentProcessor->getCycleCount()),
+      m_virtualTimeFreq);
+}
 
 void ProcessorHandler::_checkProcessorFinished() {
   if (m_currentProcessor->finished())
@@ -466,7 +639,8 @@ void ProcessorHandler::_checkProcessorFinished() {
 
 void ProcessorHandler::setStopRunFlag() {
   emit stopping();
-  if (m_runWatcher.isRunning()) {
+  if (m_runWatcher.isRunning() ||
+      m_blockingRun.load(std::memory_order_relaxed)) {
     m_stopRunningFlag = true;
     // We might be currently trapping for user I/O. Signal to abort the trap, in
     // this avoiding a deadlock.
@@ -4,11 +4,13 @@
 #include <QFutureWatcher>
 #include <QObject>
 #include <atomic>
+#include <functional>
 #include <memory>
 
 #include "VSRTL/graphics/gallantsignalwrapper.h"
 #include "assembler/assembler.h"
 #include "assembler/program.h"
+#include "memorywriteset.h"
 #include "processorregistry.h"
 #include "processors/interface/ripesprocessor.h"
 #include "syscall/ripes_syscall.h"
@@ -143,6 +145,14 @@ public:
     return get()->_getMemory();
   }
 
+  /**
+   * @brief memoryWriteSet
+   * returns the history of memory writes, used by memory views to only refresh
+   * the addresses which were modified. Writes performed directly on
+   * getMemory() are not tracked, and must be recorded by the writer.
+   */
+  static MemoryWriteSet &memoryWriteSet() { return get()->m_memoryWriteSet; }
+
   /**
    * @brief setRegisterValue
    * Set the value of register @param idx to @param value.
@@ -160,6 +170,26 @@ public:
     get()->_writeMem(address, value, size);
   }
 
+  /**
+   * @brief readMemBlock
+   * Copies @p size bytes of simulator memory, starting at @p address, into
+   * @p dst. The memory is accessed in naturally aligned words rather than
+   * byte by byte.
+   */
+  static void readMemBlock(AInt address, char *dst, size_t size) {
+    get()->_readMemBlock(address, dst, size);
+  }
+
+  /**
+   * @brief writeMemBlock
+   * Copies @p size bytes from @p src into simulator memory, starting at
+   * @p address. The memory is accessed in naturally aligned words rather than
+   * byte by byte.
+   */
+  static void writeMemBlock(AInt address, const char *src, size_t size) {
+    get()->_writeMemBlock(address, src, size);
+  }
+
   /**
    * @brief getRegisterValue
    * @returns value of register @param idx
@@ -200,6 +230,44 @@ public:
   /// Returns true if the simulator is currently in "run" mode.
   static bool isRunning() { return get()->_isRunning(); }
 
+  /**
+   * @brief timeNanos
+   * Returns the current time in nanoseconds, as observed by the simulated
+   * program (the RTC peripheral and time system calls). By default, this is the
+   * host wall-clock time since the Unix epoch. If virtual time is enabled, time
+   * is instead derived from the processor cycle count at the virtual time
+   * frequency, starting at 0 when the processor is reset. Virtual time is
+   * independent of host speed and load, making runs reproducible.
+   */
+  static uint64_t timeNanos() { return get()->_timeNanos(); }
+
+  /// Upper bound on the virtual time frequency (Hz), accepted by both the
+  /// settings dialog and the CLI. Fits the (int) range of the settings spin
+  /// box.
+  static constexpr uint64_t s_maxVirtualTimeFreq = 2000000000;
+
+  /// Enables virtual time at @p frequencyHz (the simulated core frequency), or
+  /// selects wall-clock time if 0. Initialized from
+  /// RIPES_SETTING_VIRTUAL_TIME_FREQ.
+  static void setVirtualTimeFrequency(uint64_t frequencyHz) {
+    get()->m_virtualTimeFreq = frequencyHz;
+  }
+  static uint64_t virtualTimeFrequency() { return get()->m_virtualTimeFreq; }
+
+  /// Returns true if the program observed input from the host since the
+  /// processor was last reset: data read from stdin, or the wall-clock time
+  /// (see timeNanos()). The results of such a run are not determined by the
+  /// program and the processor configuration alone.
+  static bool hostInputObserved() { return get()->m_hostInputObserved; }
+  /// Records that the program observed input from the host.
+  static void recordHostInput() { get()->m_hostInputObserved = true; }
+  /// Returns true if the program opened a file on the host since the
+  /// processor was last reset. The contents of such files are not part of
+  /// the program, and writing them is a side effect of the run.
+  static bool hostFilesAccessed() { return get()->m_hostFilesAccessed; }
+  /// Records that the program opened a file on the host.
+  static void recordHostFileAccess() { get()->m_hostFilesAccessed = true; }
+
   static void setMemoryFocusAddress(AInt address) {
     emit get() -> memoryFocusAddressChanged(address);
   }
@@ -213,8 +281,32 @@ public:
    */
   static void run() { get()->_run(); }
 
+  /**
+   * @brief runBlocking
+   * Runs the current processor on the calling thread, under the same stop
+   * conditions as run(). No event loop, thread pool or signals are involved,
+   * which makes this suitable for headless execution. If @p timeoutMs is
+   * non-zero, the run is stopped once @p timeoutMs milliseconds have elapsed.
+   * If provided, @p progress is called about every @p progressIntervalMs
+   * milliseconds during the run.
+   * @returns false if the run was stopped due to the timeout.
+   */
+  static bool runBlocking(unsigned timeoutMs = 0,
+                          const std::function<void()> &progress = {},
+                          unsigned progressIntervalMs = 1000) {
+    return get()->_runBlocking(timeoutMs, progress, progressIntervalMs);
+  }
+
   static void clock() { get()->_clock(); }
 
+  /// Reverses the current processor by a clock cycle. This goes through the
+  /// processor rather than the VSRTL widget, which may not (yet) have a design
+  /// loaded.
+  static void reverse() { get()->_reverse(); }
+
+  /// Returns true if the current processor can be reversed.
+  static bool isReversible() { return get()->_isReversible(); }
+
   /**
    * @brief stopRun
    * Sets the m_stopRunningFlag, and waits for any currently running
@@ -319,6 +411,8 @@ private:
   void _setRegisterValue(const std::string_view &rfid, const unsigned idx,
                          VInt value);
   void _writeMem(AInt address, VInt value, int size = sizeof(VInt));
+  void _readMemBlock(AInt address, char *dst, size_t size);
+  void _writeMemBlock(AInt address, const char *src, size_t size);
   VInt _getRegisterValue(const std::string_view &rfid,
                          const unsigned idx) const;
   bool _checkBreakpoint();
@@ -329,9 +423,14 @@ private:
   void _checkProcessorFinished();
   bool _isRunning();
   void _run();
+  bool _runBlocking(unsigned timeoutMs, const std::function<void()> &progress,
+                    unsigned progressIntervalMs);
   void _clock();
+  void _reverse();
+  bool _isReversible() const;
   void _reset();
   void _stopRun();
+  uint64_t _timeNanos() const;
   void _triggerProcStateChangeTimer();
 
   /// Gallant-connected handler for the processor's per-cycle "clocked" signal,
@@ -341,6 +440,9 @@ private:
   /// immediately during a run - avoiding a very expensive per-cycle
   /// cross-thread event post.
   void _relayClockedNonRun();
+  /// Records the data memory access currently reported by the processor as
+  /// pending, following a reset, reversal or run; see _relayClockedNonRun().
+  void _syncPendingDataAccess();
 
   void createAssemblerForCurrentISA();
   void setStopRunFlag();
@@ -352,6 +454,7 @@ private:
   ProcessorID m_currentID;
   RegisterInitialization m_currentRegInits;
   std::unique_ptr<RipesProcessor> m_currentProcessor;
+  ProcessorHandlerSyscallEnvironment m_syscallEnvironment;
   std::unique_ptr<SyscallManager> m_syscallManager;
   std::shared_ptr<Assembler::AssemblerBase> m_currentAssembler;
 
@@ -374,10 +477,25 @@ private:
   QFutureWatcher<void> m_runWatcher;
   bool m_stopRunningFlag = false;
 
+  MemoryWriteSet m_memoryWriteSet;
+  // The data memory access to be committed by the next clock cycle, for
+  // processors reporting pending accesses; see _relayClockedNonRun().
+  MemoryAccess m_pendingDataAccess;
+
+  // Virtual time frequency (Hz); 0 if programs observe wall-clock time.
+  std::atomic<uint64_t> m_virtualTimeFreq{0};
+  // See hostInputObserved(). Set from the thread executing the program.
+  mutable std::atomic<bool> m_hostInputObserved{false};
+  // See hostFilesAccessed(). Set from the thread executing the program.
+  std::atomic<bool> m_hostFilesAccessed{false};
+
   // Fast, thread-safe indicator that the processor is currently in a Run (as
   // opposed to single-stepping). Checked on the per-cycle clocked-signal hot
   // path to avoid cross-thread event posting during a run.
   std::atomic<bool> m_running{false};
+  // Set for the duration of a runBlocking() call, which does not go through
+  // m_runWatcher.
+  std::atomic<bool> m_blockingRun{false};
 
   std::mutex m_clockLock;
 
@@ -265,6 +265,7 @@ public:
   }
 
   void reverse() override {
+    revertPipelineStats();
     if (control->inFirstState())
       m_instructionsRetired--;
 
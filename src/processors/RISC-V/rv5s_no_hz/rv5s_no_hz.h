@@ -451,6 +451,7 @@ public:
   }
 
   void reverse() override {
+    revertPipelineStats();
     if (m_syscallExitCycle != -1 && m_cycleCount == m_syscallExitCycle) {
       // We are about to undo an exit syscall instruction. In this case, the
       // syscall exiting sequence should be terminate
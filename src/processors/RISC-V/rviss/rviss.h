@@ -102,6 +102,7 @@ public:
   }
 
   MemoryAccess dataMemAccess() const override { return m_lastDataAccess; }
+  bool dataMemAccessPending() const override { return false; }
   MemoryAccess instrMemAccess() const override { return m_lastInstrAccess; }
 
   void finalize(FinalizeReason fr) override {
@@ -121,6 +122,7 @@ public:
     m_lastDataAccess = MemoryAccess();
     m_lastInstrAccess = MemoryAccess();
     m_regs.fill(0);
+    resetPipelineStats();
     // Resets the registered address spaces (reloading the program) and the box
     // component.
     reset();
@@ -223,6 +223,7 @@ public:
   }
 
   void reverse() override {
+    revertPipelineStats();
     m_instructionsRetired--;
     Design::reverse();
     // Ensure that reverses performed when we expected to finish in the
@@ -4,6 +4,7 @@
 
 #include "Signal.h"
 #include "VSRTL/core/vsrtl_design.h"
+#include <deque>
 #include <map>
 
 #include "../isa/isa_types.h"
@@ -109,6 +110,33 @@ struct ProcessorStructure : public std::map<unsigned, unsigned> {
   }
 };
 
+/**
+ * @brief The PipelineStageStats struct
+ * Per-stage counters of pipeline events, accumulated cycle-by-cycle from the
+ * StageInfo of the stage.
+ *  - stallCycles: cycles where the stage was stalled.
+ *  - flushCycles: cycles where the stage contents were flushed.
+ *  - bubbleCycles: cycles where the stage held no valid instruction, for
+ *    reasons other than a stall or a flush (pipeline fill/drain, unused lanes).
+ *  - wayHazardCycles: cycles where a way hazard was detected in the stage
+ *    (dual-issue processors).
+ * A stalled or flushed slot travels down the pipeline, and is thus counted in
+ * the cycle counters of each stage it passes. The stalls, flushes and
+ * wayHazards counters instead count each event once, in the stage where it
+ * originates: cycles where the stage is in the state, unless the preceding
+ * stage of its lane was in the same state in the previous cycle.
+ */
+struct PipelineStageStats {
+  StageIndex stage;
+  uint64_t stallCycles = 0;
+  uint64_t flushCycles = 0;
+  uint64_t bubbleCycles = 0;
+  uint64_t wayHazardCycles = 0;
+  uint64_t stalls = 0;
+  uint64_t flushes = 0;
+  uint64_t wayHazards = 0;
+};
+
 /**
  * @brief The RipesProcessor class
  * Interface for all Ripes processors. This interface is intended to be
@@ -234,6 +262,14 @@ public:
   virtual MemoryAccess dataMemAccess() const = 0;
   virtual MemoryAccess instrMemAccess() const = 0;
 
+  /**
+   * @brief dataMemAccessPending
+   * @returns true if dataMemAccess() reports the access to be committed at the
+   * next clock edge (the inputs of a clocked memory), rather than the access
+   * performed by the latest clock cycle.
+   */
+  virtual bool dataMemAccessPending() const { return true; }
+
   /**
    * @brief getRegister
    * @param rfid: register file identifier
@@ -280,8 +316,11 @@ public:
    * Clocks the processor.
    */
   void clock() {
-    if (!finished())
+    if (!finished()) {
       clockProcessor();
+      if (m_pipelineStatsEnabled)
+        recordPipelineStats(1);
+    }
   }
 
   /**
@@ -292,7 +331,33 @@ public:
    * a redundant (per-cycle) finished() evaluation, which for some models
    * involves a non-trivial executable-address lookup.
    */
-  void clockUnguarded() { clockProcessor(); }
+  void clockUnguarded() {
+    clockProcessor();
+    if (m_pipelineStatsEnabled)
+      recordPipelineStats(1);
+  }
+
+  /**
+   * @brief setPipelineStatsEnabled
+   * Enables or disables the accumulation of per-stage pipeline statistics.
+   * Gathering the statistics requires a stageInfo() query for every stage in
+   * every cycle, and is therefore disabled by default. Enabling the statistics
+   * clears any previously accumulated values.
+   */
+  void setPipelineStatsEnabled(bool enabled) {
+    m_pipelineStatsEnabled = enabled;
+    resetPipelineStats();
+  }
+  bool pipelineStatsEnabled() const { return m_pipelineStatsEnabled; }
+
+  /**
+   * @brief pipelineStats
+   * @returns the per-stage pipeline statistics accumulated since the last
+   * processor reset. Stages are ordered as in structure().stageIt().
+   */
+  const std::vector<PipelineStageStats> &pipelineStats() const {
+    return m_pipelineStats;
+  }
 
   /**
    * @brief finalize
@@ -361,6 +426,11 @@ public:
    * Reverses the processor, undoing the latest clock cycle
    */
   virtual void reverseProcessor() {}
+  /**
+   * @brief canReverseProcessor
+   * Returns true if the processor has a clock cycle which can be reversed.
+   */
+  virtual bool canReverseProcessor() const { return false; }
   /**
    * @brief setMaxReverseCycles
    * @p cycles denotes the maximum number of cycles that the processor is
@@ -377,9 +447,125 @@ protected:
    */
   virtual void clockProcessor() = 0;
 
+  /**
+   * @brief resetPipelineStats
+   * Clears the accumulated pipeline statistics. Must be called by implementing
+   * processors upon reset.
+   */
+  void resetPipelineStats() {
+    m_pipelineStats.clear();
+    m_stageStateHistory.clear();
+    for (auto idx : structure().stageIt())
+      m_pipelineStats.push_back({idx});
+  }
+
+  /**
+   * @brief setPipelineStatsHistoryDepth
+   * Sets the number of cycles that the pipeline statistics can be reverted by
+   * (see revertPipelineStats()). Must be at least the number of cycles that the
+   * processor can reverse.
+   */
+  void setPipelineStatsHistoryDepth(unsigned cycles) {
+    m_stageStateHistoryDepth = cycles;
+    while (m_stageStateHistory.size() > m_stageStateHistoryDepth + 1)
+      m_stageStateHistory.pop_front();
+  }
+
+  /**
+   * @brief revertPipelineStats
+   * Removes the contribution of the current cycle from the pipeline statistics.
+   * Must be called by reversible processors before undoing a clock cycle.
+   */
+  void revertPipelineStats() {
+    if (m_pipelineStatsEnabled)
+      recordPipelineStats(-1);
+  }
+
   // m_features should be adjusted accordingly during processor construction
   unsigned m_features;
   bool m_emitsSignals = true;
+
+private:
+  /**
+   * @brief recordPipelineStats
+   * When clocking (@p direction = +1), classifies the current state of each
+   * stage and increments the matching counters. When reversing (@p direction =
+   * -1), decrements the counters incremented for the latest cycle.
+   */
+  void recordPipelineStats(int direction) {
+    if (m_pipelineStats.empty())
+      resetPipelineStats();
+
+    if (direction > 0) {
+      std::vector<StageInfo> states;
+      states.reserve(m_pipelineStats.size());
+      for (auto idx : structure().stageIt())
+        states.push_back(stageInfo(idx));
+      const auto *prevStates =
+          m_stageStateHistory.empty() ? nullptr : &m_stageStateHistory.back();
+      countPipelineStats(states, prevStates, 1);
+      m_stageStateHistory.push_back(std::move(states));
+      if (m_stageStateHistory.size() > m_stageStateHistoryDepth + 1)
+        m_stageStateHistory.pop_front();
+    } else {
+      if (m_stageStateHistory.empty())
+        return;
+      const std::vector<StageInfo> states =
+          std::move(m_stageStateHistory.back());
+      m_stageStateHistory.pop_back();
+      const auto *prevStates =
+          m_stageStateHistory.empty() ? nullptr : &m_stageStateHistory.back();
+      countPipelineStats(states, prevStates, -1);
+    }
+  }
+
+  /// Adds @p direction to the counters matching the stage states of a cycle,
+  /// @p states, given the stage states of the previous cycle, @p prevStates
+  /// (if known).
+  void countPipelineStats(const std::vector<StageInfo> &states,
+                          const std::vector<StageInfo> *prevStates,
+                          int direction) {
+    const auto add = [direction](uint64_t &counter) {
+      direction > 0 ? ++counter : --counter;
+    };
+    for (unsigned i = 0; i < states.size(); ++i) {
+      const StageInfo &info = states[i];
+      auto &stats = m_pipelineStats[i];
+      // Stages of a lane are consecutive, so the preceding stage of the lane
+      // is the preceding entry.
+      const bool propagated = prevStates && stats.stage.index() > 0 &&
+                              (*prevStates)[i - 1].state == info.state;
+      switch (info.state) {
+      case StageInfo::State::Stalled:
+        add(stats.stallCycles);
+        if (!propagated)
+          add(stats.stalls);
+        break;
+      case StageInfo::State::Flushed:
+        add(stats.flushCycles);
+        if (!propagated)
+          add(stats.flushes);
+        break;
+      case StageInfo::State::WayHazard:
+        add(stats.wayHazardCycles);
+        if (!propagated)
+          add(stats.wayHazards);
+        break;
+      case StageInfo::State::None:
+      case StageInfo::State::Unused:
+        if (!info.stage_valid)
+          add(stats.bubbleCycles);
+        break;
+      }
+    }
+  }
+
+  bool m_pipelineStatsEnabled = false;
+  std::vector<PipelineStageStats> m_pipelineStats;
+  // The stage states of the latest cycles, oldest first, for reverting the
+  // pipeline statistics.
+  std::deque<std::vector<StageInfo>> m_stageStateHistory;
+  unsigned m_stageStateHistoryDepth = 100;
 };
 
 } // namespace Ripes
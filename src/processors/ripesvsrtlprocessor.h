@@ -25,10 +25,12 @@ public:
 
   virtual void resetProcessor() override {
     m_instructionsRetired = 0;
+    resetPipelineStats();
     reset();
   }
 
   virtual void reverseProcessor() override { reverse(); }
+  bool canReverseProcessor() const override { return canReverse(); }
 
   virtual void vcdTrace(bool enable, const QString &filename) override {
     vsrtl::core::Design::vcdTrace(enable, filename.toStdString());
@@ -40,6 +42,7 @@ public:
   long long getCycleCount() const override { return m_cycleCount; }
   void setMaxReverseCycles(unsigned cycles) override {
     setReverseStackSize(cycles);
+    setPipelineStatsHistoryDepth(cycles);
   }
 
   void postConstruct() override {
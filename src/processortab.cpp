@@ -10,6 +10,7 @@
 #include <QPixmap>
 #include <QPushButton>
 #include <QScrollBar>
+#include <QShowEvent>
 #include <QSpinBox>
 #include <QStyle>
 #include <QTemporaryFile>
@@ -29,6 +30,7 @@
 #include "registermodel.h"
 #include "ripessettings.h"
 #include "syscall/systemio.h"
+#include "utilities/startuptrace.h"
 
 #include "VSRTL/graphics/vsrtl_widget.h"
 
@@ -212,10 +214,10 @@ ProcessorTab::ProcessorTab(QToolBar *controlToolbar,
     if (layouts.size() > layoutID) {
       layout = &layouts.at(layoutID);
     }
-    loadProcessorToWidget(layout);
-
-    // By default, lock the VSRTL widget
-    m_vsrtlWidget->setLocked(true);
+    // Placing, routing and loading the layout of the processor is deferred
+    // until the tab is first shown; see showEvent().
+    m_pendingLayout = layout;
+    m_processorLoadPending = true;
   }
 
   m_stageModel = new PipelineDiagramModel(this);
@@ -227,7 +229,7 @@ ProcessorTab::ProcessorTab(QToolBar *controlToolbar,
           this, &ProcessorTab::updateInstructionLabels);
   connect(ProcessorHandler::get(), &ProcessorHandler::procStateChangedNonRun,
           this, [this] {
-            m_reverseAction->setEnabled(m_vsrtlWidget->isReversible() &&
+            m_reverseAction->setEnabled(ProcessorHandler::isReversible() &&
                                         !m_autoClockAction->isChecked());
           });
 
@@ -252,7 +254,7 @@ ProcessorTab::ProcessorTab(QToolBar *controlToolbar,
   // simulator is reversible
   connect(RipesSettings::getObserver(RIPES_SETTING_REWINDSTACKSIZE),
           &SettingObserver::modified, m_reverseAction, [this](const auto &) {
-            m_reverseAction->setEnabled(m_vsrtlWidget->isReversible());
+            m_reverseAction->setEnabled(ProcessorHandler::isReversible());
           });
 
   // Connect the global reset request signal to reset()
@@ -502,11 +504,23 @@ void ProcessorTab::resetClockRateEstimate() {
 void ProcessorTab::pause() {
   m_autoClockAction->setChecked(false);
   m_runAction->setChecked(false);
-  m_reverseAction->setEnabled(m_vsrtlWidget->isReversible());
+  m_reverseAction->setEnabled(ProcessorHandler::isReversible());
 }
 
 void ProcessorTab::fitToScreen() { m_vsrtlWidget->zoomToFit(); }
 
+void ProcessorTab::showEvent(QShowEvent *event) {
+  if (m_processorLoadPending) {
+    m_processorLoadPending = false;
+    TraceSpan span("Processor layout");
+    loadProcessorToWidget(m_pendingLayout);
+
+    // By default, lock the VSRTL widget
+    m_vsrtlWidget->setLocked(true);
+  }
+  RipesTab::showEvent(event);
+}
+
 void ProcessorTab::loadProcessorToWidget(const Layout *layout) {
   const bool doPlaceAndRoute = layout != nullptr;
   ProcessorHandler::loadProcessorToWidget(m_vsrtlWidget, doPlaceAndRoute);
@@ -535,6 +549,7 @@ void ProcessorTab::processorSelection() {
   ProcessorSelectionDialog diag;
   if (diag.exec()) {
     // New processor model was selected
+    m_processorLoadPending = false;
     m_vsrtlWidget->clearDesign();
     m_stageInstructionLabels.clear();
     ProcessorHandler::selectProcessor(diag.getSelectedId(),
@@ -623,7 +638,7 @@ void ProcessorTab::enableSimulatorControls() {
   m_clockAction->setEnabled(true);
   m_autoClockAction->setEnabled(true);
   m_runAction->setEnabled(true);
-  m_reverseAction->setEnabled(m_vsrtlWidget->isReversible());
+  m_reverseAction->setEnabled(ProcessorHandler::isReversible());
   m_resetAction->setEnabled(true);
   m_pipelineDiagramAction->setEnabled(true);
 }
@@ -680,7 +695,8 @@ void ProcessorTab::setInstructionViewCenterRow(int row) {
 void ProcessorTab::runFinished() {
   pause();
   ProcessorHandler::checkProcessorFinished();
-  m_vsrtlWidget->sync();
+  if (!m_processorLoadPending)
+    m_vsrtlWidget->sync();
   m_statUpdateTimer->stop();
 }
 
@@ -748,7 +764,7 @@ void ProcessorTab::run(bool state) {
 }
 
 void ProcessorTab::reverse() {
-  m_vsrtlWidget->reverse();
+  ProcessorHandler::reverse();
   enableSimulatorControls();
 }
 
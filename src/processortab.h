@@ -57,6 +57,9 @@ public slots:
 
   void processorSelection();
 
+protected:
+  void showEvent(QShowEvent *event) override;
+
 private slots:
   void run(bool state);
   void autoClock(bool state);
@@ -84,6 +87,9 @@ private:
   PipelineDiagramModel *m_stageModel = nullptr;
 
   vsrtl::VSRTLWidget *m_vsrtlWidget = nullptr;
+  // The layout to load into m_vsrtlWidget once the tab is first shown.
+  const Layout *m_pendingLayout = nullptr;
+  bool m_processorLoadPending = false;
 
   std::map<StageIndex, vsrtl::Label *> m_stageInstructionLabels;
 
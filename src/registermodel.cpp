@@ -36,20 +36,40 @@ int RegisterModel::rowCount(const QModelIndex &) const {
 }
 
 void RegisterModel::processorWasClocked() {
-  // Reload model
-  beginResetModel();
-  endResetModel();
   const auto newRegValues = gatherRegisterValues();
-  if (m_regValues.size() != 0) {
-    for (auto newRegVal : llvm::enumerate(newRegValues)) {
-      if (m_regValues[newRegVal.index()] != newRegVal.value()) {
-        m_mostRecentlyModifiedReg = newRegVal.index();
-        emit registerChanged(newRegVal.index());
-        break;
-      }
+  if (m_regValues.size() != newRegValues.size()) {
+    // Reload model
+    beginResetModel();
+    m_regValues = newRegValues;
+    endResetModel();
+    return;
+  }
+
+  // Only refresh the values of registers which were modified. The registers
+  // are compared against the values of the previous refresh, such that
+  // modifications from any source (processor, system calls, user edits) are
+  // detected.
+  const int prevMostRecentlyModifiedReg = m_mostRecentlyModifiedReg;
+  bool foundMostRecentlyModified = false;
+  for (auto newRegVal : llvm::enumerate(newRegValues)) {
+    const int idx = newRegVal.index();
+    if (m_regValues[idx] == newRegVal.value())
+      continue;
+    m_regValues[idx] = newRegVal.value();
+    if (!foundMostRecentlyModified) {
+      foundMostRecentlyModified = true;
+      m_mostRecentlyModifiedReg = idx;
+      emit registerChanged(idx);
     }
+    emit dataChanged(index(idx, Column::Value), index(idx, Column::Value));
+  }
+
+  // The most recently modified register is highlighted across all columns.
+  if (m_mostRecentlyModifiedReg != prevMostRecentlyModifiedReg) {
+    for (int idx : {prevMostRecentlyModifiedReg, m_mostRecentlyModifiedReg})
+      if (idx >= 0)
+        emit dataChanged(index(idx, 0), index(idx, NColumns - 1));
   }
-  m_regValues = newRegValues;
 }
 
 bool RegisterModel::setData(const QModelIndex &index, const QVariant &value,
@@ -60,6 +80,8 @@ bool RegisterModel::setData(const QModelIndex &index, const QVariant &value,
     VInt v = decodeRadixValue(value.toString(), &ok);
     if (ok) {
       ProcessorHandler::setRegisterValue(m_rft, i, v);
+      if (static_cast<size_t>(i) < m_regValues.size())
+        m_regValues[i] = ProcessorHandler::getRegisterValue(m_rft, i);
       emit dataChanged(index, index);
       return true;
     }
@@ -139,7 +161,9 @@ QVariant RegisterModel::data(const QModelIndex &index, int role) const {
 
 void RegisterModel::setRadix(Ripes::Radix r) {
   m_radix = r;
-  processorWasClocked();
+  if (rowCount() > 0)
+    emit dataChanged(index(0, Column::Value),
+                     index(rowCount() - 1, Column::Value));
 }
 
 QVariant RegisterModel::nameData(unsigned idx) const {
@@ -169,6 +193,9 @@ QVariant RegisterModel::tooltipData(unsigned idx) const {
 }
 
 VInt RegisterModel::registerData(unsigned idx) const {
+  // Served from the values gathered upon the last refresh.
+  if (idx < m_regValues.size())
+    return m_regValues[idx];
   return ProcessorHandler::getRegisterValue(m_rft, idx);
 }
 
@@ -23,6 +23,7 @@ const std::map<QString, QVariant> s_defaultSettings = {
     {RIPES_SETTING_LDARGS,
      "-static -lm"}, // Ensure statically linked executable + link with math
                      // library
+    {RIPES_SETTING_CCCACHE, false},
     {RIPES_SETTING_CONSOLEECHO, "true"},
     {RIPES_SETTING_INDENTAMT, 4},
     {RIPES_SETTING_UIUPDATEPS, 25},
@@ -31,12 +32,14 @@ const std::map<QString, QVariant> s_defaultSettings = {
     {RIPES_SETTING_ASSEMBLER_TEXTSTART, 0x0},
     {RIPES_SETTING_ASSEMBLER_DATASTART, 0x10000000},
     {RIPES_SETTING_ASSEMBLER_BSSSTART, 0x11000000},
+    {RIPES_SETTING_ASSEMBLER_CACHE, true},
     {RIPES_SETTING_PERIPHERALS_START, static_cast<unsigned>(0xF0000000)},
     {RIPES_SETTING_EDITORREGS, true},
     {RIPES_SETTING_EDITORCONSOLE, true},
     {RIPES_SETTING_EDITORSTAGEHIGHLIGHTING, true},
     {RIPES_SETTING_VCD_TRACE_FILE, "ripes.vcd"},
     {RIPES_SETTING_VCD_TRACE, false},
+    {RIPES_SETTING_VIRTUAL_TIME_FREQ, 0},
 
     {RIPES_SETTING_PIPEDIAGRAM_MAXCYCLES, 100},
     {RIPES_SETTING_CACHE_MAXCYCLES, 10000},
@@ -82,6 +85,11 @@ const std::map<QString, QVariant> s_defaultSettings = {
     {RIPES_SETTING_COLORSCHEME, static_cast<int>(ColorScheme::System)}};
 
 void SettingObserver::setValue(const QVariant &v) {
+  if (m_volatile) {
+    m_value = v;
+    emit modified(value());
+    return;
+  }
   QSettings settings;
   Q_ASSERT(settings.contains(m_key));
   settings.setValue(m_key, v);
@@ -91,16 +99,30 @@ void SettingObserver::setValue(const QVariant &v) {
 
 void SettingObserver::trigger() { setValue(value()); }
 
+bool RipesSettings::s_volatile = false;
+
 RipesSettings::~RipesSettings() {}
 
+void RipesSettings::setVolatile() { s_volatile = true; }
+
 RipesSettings::RipesSettings() {
   // Create a global organization & application name for QSettings to refer to
   QCoreApplication::setOrganizationName("Ripes");
   QCoreApplication::setOrganizationDomain("https://github.com/mortbopet/Ripes");
   QCoreApplication::setApplicationName("Ripes");
 
-  // Populate settings with default values if settings value is not found
   QSettings settings;
+  if (s_volatile) {
+    for (const auto &setting : s_defaultSettings) {
+      auto &observer =
+          m_observers.emplace(setting.first, setting.first).first->second;
+      observer.m_volatile = true;
+      observer.m_value = settings.value(setting.first, setting.second);
+    }
+    return;
+  }
+
+  // Populate settings with default values if settings value is not found
   for (const auto &setting : s_defaultSettings) {
     if (!settings.contains(setting.first)) {
       settings.setValue(setting.first, setting.second);
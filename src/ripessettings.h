@@ -17,6 +17,7 @@ namespace Ripes {
 #define RIPES_SETTING_FORMAT_ON_SAVE ("format_on_save")
 #define RIPES_SETTING_FORMATTER_ARGS ("formatter_args")
 #define RIPES_SETTING_LDARGS ("linker_args")
+#define RIPES_SETTING_CCCACHE ("compiler_cache")
 #define RIPES_SETTING_CONSOLEECHO ("console_echo")
 #define RIPES_SETTING_INDENTAMT ("editor_indent")
 #define RIPES_SETTING_UIUPDATEPS ("ui_update_ps")
@@ -25,6 +26,7 @@ namespace Ripes {
 #define RIPES_SETTING_ASSEMBLER_TEXTSTART ("text_start")
 #define RIPES_SETTING_ASSEMBLER_DATASTART ("data_start")
 #define RIPES_SETTING_ASSEMBLER_BSSSTART ("bss_start")
+#define RIPES_SETTING_ASSEMBLER_CACHE ("assembler_cache")
 
 #define RIPES_SETTING_PIPEDIAGRAM_MAXCYCLES ("pipelinediagram_maxcycles")
 #define RIPES_SETTING_PERIPHERALS_START ("peripheral_start")
@@ -35,6 +37,7 @@ namespace Ripes {
 #define RIPES_SETTING_PERIPHERAL_SETTINGS ("peripheral_settings")
 #define RIPES_SETTING_VCD_TRACE ("enable_vcd_trace")
 #define RIPES_SETTING_VCD_TRACE_FILE ("vcd_trace_file")
+#define RIPES_SETTING_VIRTUAL_TIME_FREQ ("virtual_time_freq")
 
 // This is not really a setting, but instead a method to leverage the static
 // observer objects that are generated for a setting. Used for other objects to
@@ -138,6 +141,8 @@ public:
 
   template <typename T = QVariant>
   T value() const {
+    if (m_volatile)
+      return m_value.value<T>();
     QSettings settings;
     Q_ASSERT(settings.contains(m_key));
     return settings.value(m_key).value<T>();
@@ -152,6 +157,10 @@ public slots:
 
 private:
   QString m_key;
+  // In volatile mode (see RipesSettings::setVolatile()), the value of the
+  // setting is held here rather than in the persistent settings store.
+  bool m_volatile = false;
+  QVariant m_value;
 };
 
 class RipesSettings : public QSettings {
@@ -172,6 +181,16 @@ public:
    */
   static SettingObserver *getObserver(const QString &key);
 
+  /**
+   * @brief setVolatile
+   * Reads all settings from the persistent settings store once, and
+   * subsequently keeps any modifications in memory only. Used in CLI mode, to
+   * avoid accessing the settings store on every read, and to not let command
+   * line runs modify the settings of the GUI. Must be called before any
+   * setting is accessed.
+   */
+  static void setVolatile();
+
 private:
   static RipesSettings &get() {
     static RipesSettings inst;
@@ -181,6 +200,7 @@ private:
   ~RipesSettings();
 
   std::map<QString, SettingObserver> m_observers;
+  static bool s_volatile;
 };
 
 } // namespace Ripes
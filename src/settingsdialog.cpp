@@ -3,6 +3,7 @@
 
 #include "ccmanager.h"
 #include "formattermanager.h"
+#include "processorhandler.h"
 #include "ripessettings.h"
 
 #include <QCheckBox>
@@ -243,6 +244,17 @@ QWidget *SettingsDialog::createCompilerPage() {
   connect(ldArgs, &QLineEdit::textChanged, ccpath,
           [=, ccpath = ccpath] { emit ccpath->textChanged(ccpath->text()); });
 
+  // Setting: RIPES_SETTING_CCCACHE
+  auto [ccCacheLabel, ccCache] = createSettingsWidgets<QCheckBox>(
+      RIPES_SETTING_CCCACHE, "Cache compiled programs:");
+  ccCache->setToolTip("Reuse the previously compiled executable when a "
+                      "program is recompiled with an unchanged source, "
+                      "included headers, compiler and compiler arguments.");
+  auto *CCCacheHLayout = new QHBoxLayout();
+  CCCacheHLayout->addWidget(ccCacheLabel);
+  CCCacheHLayout->addWidget(ccCache);
+  CCLayout->addLayout(CCCacheHLayout);
+
   // Add effective compile command line view
   auto *CCCLineHLayout = new QHBoxLayout();
   m_compileInfoHeader = new QLabel();
@@ -281,6 +293,12 @@ QWidget *SettingsDialog::createCompilerPage() {
       createSettingsWidgets<HexSpinBox>(RIPES_SETTING_ASSEMBLER_BSSSTART,
                                         ".bss section start address:"),
       ASMLayout);
+  appendToLayout(
+      createSettingsWidgets<QCheckBox>(RIPES_SETTING_ASSEMBLER_CACHE,
+                                       "Cache assembled programs:"),
+      ASMLayout,
+      "Reuse the previously assembled program when an unchanged program is "
+      "loaded on startup or when switching processors.");
 
   pageLayout->addWidget(ASMGroupBox);
 
@@ -345,6 +363,18 @@ QWidget *SettingsDialog::createSimulatorPage() {
   appendToLayout({vcdEnableLabel, vcdEnable}, pageLayout);
   appendToLayout({vcdTraceFileLabel, vcdTraceFile}, pageLayout);
 
+  // Setting: RIPES_SETTING_VIRTUAL_TIME_FREQ
+  auto [virtualTimeLabel, virtualTimeSpinbox] = createSettingsWidgets<QSpinBox>(
+      RIPES_SETTING_VIRTUAL_TIME_FREQ, "Virtual time frequency (Hz):");
+  virtualTimeSpinbox->setRange(
+      0, static_cast<int>(ProcessorHandler::s_maxVirtualTimeFreq));
+  appendToLayout(
+      {virtualTimeLabel, virtualTimeSpinbox}, pageLayout,
+      "If non-zero, the real-time clock peripheral and time system calls "
+      "report virtual time, derived from the processor cycle count at this "
+      "core frequency, instead of the host wall-clock time. This makes "
+      "timing-dependent programs behave identically on every run.");
+
   return pageWidget;
 }
 
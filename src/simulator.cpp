@@ -0,0 +1,185 @@
+#include "simulator.h"
+
+#include "assembler/assembler.h"
+#include "syscall/riscv_syscall.h"
+
+#include <algorithm>
+
+namespace Ripes {
+
+/**
+ * @brief The Simulator::Environment class
+ * Executes system calls on the processor of a Simulator, with program I/O
+ * through the buffers of the Simulator.
+ */
+class Simulator::Environment : public SyscallEnvironment {
+public:
+  explicit Environment(Simulator &sim) : m_sim(sim) {}
+
+  const ISAInfoBase &isa() const override { return *m_sim.m_isa; }
+  RipesProcessor &processor() override { return *m_sim.m_processor; }
+
+  VInt getRegister(std::string_view rfid, unsigned idx) const override {
+    return m_sim.getRegister(rfid, idx);
+  }
+  void setRegister(std::string_view rfid, unsigned idx, VInt value) override {
+    m_sim.setRegister(rfid, idx, value);
+  }
+  VInt readMem(AInt address, unsigned bytes) const override {
+    return m_sim.readMemory(address, bytes);
+  }
+  void writeMem(AInt address, VInt value, unsigned bytes) override {
+    m_sim.writeMemory(address, value, bytes);
+  }
+
+  uint64_t timeNanos() const override {
+    return SyscallEnvironment::timeNanos(
+        static_cast<uint64_t>(m_sim.cycleCount()),
+        m_sim.m_config.virtualTimeFreq);
+  }
+
+  void print(const char *data, size_t size) override {
+    m_sim.m_output.append(data, size);
+  }
+  int openFile(const QString &, unsigned) override { return -1; }
+  void closeFile(int) override {}
+  int seek(int, int, int) override { return -1; }
+  int readFromFile(int fd, QByteArray &buffer, int length) override {
+    if (fd != STDIN || length < 0)
+      return -1;
+    buffer = m_sim.m_input.mid(m_sim.m_inputPos, length);
+    m_sim.m_inputPos += buffer.size();
+    return buffer.size();
+  }
+  int writeToFile(int fd, const QByteArray &buffer, int length) override {
+    if ((fd != STDOUT && fd != STDERR) || length < 0)
+      return -1;
+    const int size = std::min<int>(length, buffer.size());
+    print(buffer.constData(), size);
+    return size;
+  }
+
+  void exit(VInt code) override {
+    m_sim.m_exitCode = code;
+    processor().finalize(RipesProcessor::FinalizeReason::exitSyscall);
+  }
+  void unknownSyscall(int id) override {
+    m_sim.m_error = "Unsupported system call: " + QString::number(id);
+  }
+
+private:
+  enum STDIO { STDIN = 0, STDOUT = 1, STDERR = 2 };
+  Simulator &m_sim;
+};
+
+Simulator::Simulator(const SimulatorConfig &config) : m_config(config) {
+  const auto &desc = ProcessorRegistry::getDescription(m_config.processor);
+  m_regInit = desc.defaultRegisterVals;
+  for (const auto &regFileInit : m_config.regInit)
+    for (const auto &kv : regFileInit.second)
+      m_regInit[regFileInit.first][kv.first] = kv.second;
+
+  m_processor = ProcessorRegistry::constructProcessor(m_config.processor,
+                                                      m_config.extensions);
+  m_processor->isExecutableAddress = [this](AInt address) {
+    return isExecutableAddress(address);
+  };
+  m_processor->trapHandler = [this] { handleTrap(); };
+  m_processor->postConstruct();
+  m_isa = m_processor->implementsISA();
+  m_syscallEnvironment = std::make_unique<Environment>(*this);
+  m_syscallManager =
+      std::make_unique<RISCVSyscallManager>(*m_syscallEnvironment);
+  reset();
+}
+
+Simulator::~Simulator() = default;
+
+Errors Simulator::loadAssembly(const QString &source) {
+  auto res = Assembler::getCachedAssembler(m_isa)->assembleRaw(
+      source, nullptr, &m_config.segmentBases);
+  if (res.errors.empty())
+    loadProgram(std::make_shared<const Program>(std::move(res.program)));
+  return res.errors;
+}
+
+void Simulator::loadProgram(const std::shared_ptr<const Program> &program) {
+  m_program = program;
+  m_textStart = m_textEnd = 0;
+  auto &mem = m_processor->getMemory();
+  mem.clearInitializationMemories();
+  if (m_program) {
+    if (auto *text = m_program->getSection(TEXT_SECTION_NAME)) {
+      m_textStart = text->address;
+      m_textEnd = text->address + text->data.length();
+    }
+    // The initialization memories refer to the section data, which is kept
+    // alive by m_program.
+    for (const auto &seg : m_program->sections)
+      mem.addInitializationMemory(seg.second.address, seg.second.data.data(),
+                                  seg.second.data.length());
+    m_processor->setPCInitialValue(m_program->entryPoint);
+  }
+  reset();
+}
+
+void Simulator::reset() {
+  m_processor->resetProcessor();
+  for (const auto &regFileInit : m_regInit)
+    for (const auto &kv : regFileInit.second)
+      m_processor->setRegister(regFileInit.first, kv.first, kv.second);
+  m_output.clear();
+  m_inputPos = 0;
+  m_exitCode.reset();
+  m_error.clear();
+}
+
+void Simulator::step() {
+  if (!m_processor->finished())
+    m_processor->clockUnguarded();
+}
+
+Simulator::RunResult Simulator::run(long long maxCycles) {
+  while (!m_processor->finished()) {
+    if (!m_error.isEmpty())
+      return RunResult::Error;
+    if (maxCycles != 0 && m_processor->getCycleCount() >= maxCycles)
+      return RunResult::CycleLimit;
+    m_processor->clockUnguarded();
+  }
+  return m_error.isEmpty() ? RunResult::Finished : RunResult::Error;
+}
+
+VInt Simulator::getRegister(std::string_view regFile, unsigned index) const {
+  return m_processor->getRegister(regFile, index);
+}
+
+void Simulator::setRegister(std::string_view regFile, unsigned index,
+                            VInt value) {
+  m_processor->setRegister(regFile, index, value);
+}
+
+VInt Simulator::readMemory(AInt address, unsigned bytes) const {
+  return m_processor->getMemory().readMemConst(address, bytes);
+}
+
+void Simulator::writeMemory(AInt address, VInt value, unsigned bytes) {
+  m_processor->getMemory().writeMem(address, value, bytes);
+}
+
+void Simulator::setInput(const QByteArray &input) {
+  m_input = input;
+  m_inputPos = 0;
+}
+
+bool Simulator::isExecutableAddress(AInt address) const {
+  return m_textStart <= address && address < m_textEnd;
+}
+
+void Simulator::handleTrap() {
+  if (const auto reg = m_isa->syscallReg(); reg.has_value())
+    m_syscallManager->execute(
+        m_processor->getRegister(reg->file->regFileName(), reg->index));
+}
+
+} // namespace Ripes
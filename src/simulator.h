@@ -0,0 +1,133 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+
+#include <memory>
+#include <optional>
+
+#include "assembler/assembler_defines.h"
+#include "assembler/program.h"
+#include "processorregistry.h"
+#include "processors/interface/ripesprocessor.h"
+
+namespace Ripes {
+
+struct SimulatorConfig {
+  ProcessorID processor = ProcessorID::RV32_5S;
+  QStringList extensions = {"M"};
+  /// Register initializations, applied on top of the default register
+  /// initializations of the processor.
+  RegisterInitialization regInit = {};
+  /// Segment base addresses used when assembling programs through
+  /// Simulator::loadAssembly().
+  Assembler::SegmentBases segmentBases = {
+      {".text", 0x0}, {".data", 0x10000000}, {".bss", 0x11000000}};
+  /// Clock frequency (in Hz) of the simulated time seen by the time system
+  /// calls. If 0, the host time is used.
+  uint64_t virtualTimeFreq = 0;
+};
+
+class SyscallManager;
+
+/**
+ * @brief The Simulator class
+ * A self-contained simulation instance, for embedding Ripes as a library (test
+ * harnesses, batch runs, ...). Each Simulator owns its processor (and thereby
+ * its memory and registers), its loaded program, its configuration, and its
+ * system call manager and I/O; none of the ProcessorHandler, SystemIO,
+ * IOManager or RipesSettings singletons are involved. Independent Simulator
+ * instances may therefore run concurrently on separate threads. A single
+ * instance is not thread-safe.
+ *
+ * System calls are executed by the same system call implementations as in the
+ * GUI, on an environment private to this instance. Program output to stdout and
+ * stderr is collected in output(), and program input is read from setInput().
+ * Opening files is not supported, and memory-mapped peripherals are not
+ * available.
+ */
+class Simulator {
+public:
+  enum class RunResult {
+    /// The program exited, or execution left the .text section.
+    Finished,
+    /// The cycle limit was reached before the program finished.
+    CycleLimit,
+    /// An unsupported system call was executed; see error().
+    Error
+  };
+
+  explicit Simulator(const SimulatorConfig &config = SimulatorConfig());
+  ~Simulator();
+  Simulator(const Simulator &) = delete;
+  Simulator &operator=(const Simulator &) = delete;
+
+  /// Assembles @p source for the ISA of this simulator and loads the resulting
+  /// program. @returns the assembler errors, if any; in which case no program
+  /// is loaded.
+  Errors loadAssembly(const QString &source);
+
+  /// Loads @p program and resets the simulator.
+  void loadProgram(const std::shared_ptr<const Program> &program);
+
+  /// Resets the processor, registers and system call I/O state, keeping the
+  /// loaded program.
+  void reset();
+
+  /// Clocks the processor once, unless it has finished.
+  void step();
+
+  /// Runs until the program finishes, or until @p maxCycles cycles have been
+  /// executed in total (if non-zero).
+  RunResult run(long long maxCycles = 0);
+
+  bool finished() const { return m_processor->finished(); }
+  long long cycleCount() const { return m_processor->getCycleCount(); }
+  long long instructionsRetired() const {
+    return m_processor->getInstructionsRetired();
+  }
+
+  VInt getRegister(std::string_view regFile, unsigned index) const;
+  void setRegister(std::string_view regFile, unsigned index, VInt value);
+  VInt readMemory(AInt address, unsigned bytes = 4) const;
+  void writeMemory(AInt address, VInt value, unsigned bytes = 4);
+
+  /// Data written to stdout and stderr by the program. Unlike in the GUI, the
+  /// exit code is not printed; see exitCode().
+  const QByteArray &output() const { return m_output; }
+  /// Sets the data which is read from stdin by the program.
+  void setInput(const QByteArray &input);
+  /// Exit code of the program, if it exited through an exit system call.
+  std::optional<VInt> exitCode() const { return m_exitCode; }
+  /// Description of the error which stopped the last run, if any.
+  const QString &error() const { return m_error; }
+
+  const RipesProcessor &processor() const { return *m_processor; }
+  RipesProcessor &processor() { return *m_processor; }
+  const std::shared_ptr<const Program> &program() const { return m_program; }
+
+private:
+  class Environment;
+
+  bool isExecutableAddress(AInt address) const;
+  void handleTrap();
+
+  SimulatorConfig m_config;
+  RegisterInitialization m_regInit;
+  std::unique_ptr<RipesProcessor> m_processor;
+  std::shared_ptr<ISAInfoBase> m_isa;
+  std::shared_ptr<const Program> m_program;
+  AInt m_textStart = 0;
+  AInt m_textEnd = 0;
+  std::unique_ptr<Environment> m_syscallEnvironment;
+  std::unique_ptr<SyscallManager> m_syscallManager;
+
+  QByteArray m_output;
+  QByteArray m_input;
+  qsizetype m_inputPos = 0;
+  std::optional<VInt> m_exitCode;
+  QString m_error;
+};
+
+} // namespace Ripes
@@ -13,12 +13,14 @@ namespace Ripes {
 /**
  * @brief postToGUIThread
  * Schedules the execution of @param fun in the GUI thread if it exists.
+ * In headless (QCoreApplication) mode there is no GUI thread, and @param fun is
+ * dropped rather than left queued for an event loop which may never run.
  * @param connection type.
  */
 template <typename F>
 static void postToGUIThread(F &&fun,
                             Qt::ConnectionType type = Qt::QueuedConnection) {
-  if (qApp) {
+  if (qobject_cast<QGuiApplication *>(QCoreApplication::instance())) {
     auto *obj = QAbstractEventDispatcher::instance(qApp->thread());
     Q_ASSERT(obj);
     QMetaObject::invokeMethod(obj, std::forward<F>(fun), type);
@@ -2,9 +2,7 @@
 
 #include <type_traits>
 
-#include "processorhandler.h"
 #include "ripes_syscall.h"
-#include "systemio.h"
 
 namespace Ripes {
 
@@ -15,9 +13,7 @@ class ExitSyscall : public BaseSyscall {
 public:
   ExitSyscall() : BaseSyscall("Exit", "Exits the program with code 0") {}
   void execute() {
-    SystemIO::printString("\nProgram exited with code: 0\n");
-    ProcessorHandler::getProcessorNonConst()->finalize(
-        RipesProcessor::FinalizeReason::exitSyscall);
+    BaseSyscall::env().exit(0);
   }
 };
 
@@ -30,11 +26,7 @@ public:
       : BaseSyscall("Exit2", "Exits the program with a code",
                     {{0, "the number to exit with"}}) {}
   void execute() {
-    SystemIO::printString(
-        "\nProgram exited with code: " +
-        QString::number(BaseSyscall::getArg(BaseSyscall::REG_FILE, 0)) + "\n");
-    ProcessorHandler::getProcessorNonConst()->finalize(
-        RipesProcessor::FinalizeReason::exitSyscall);
+    BaseSyscall::env().exit(BaseSyscall::getArg(BaseSyscall::REG_FILE, 0));
   }
 };
 
@@ -59,11 +51,11 @@ public:
 
     // Retrieves the argument of the brk syscall, the new program break
     uint64_t newBreak = BaseSyscall::getArg(BaseSyscall::REG_FILE, 0);
-    // Retrieve the current stack pointer from the processor handler
+    // Retrieve the current stack pointer
     uint64_t stackPointer =
-        ProcessorHandler::getProcessor()->getRegister(BaseSyscall::REG_FILE, 2);
+        BaseSyscall::env().getRegister(BaseSyscall::REG_FILE, 2);
     if (newBreak >= stackPointer) {
-      SystemIO::printString(
+      BaseSyscall::env().print(
           "Error: Attempted to allocate memory overlapping stack segment\n");
       BaseSyscall::setRet(BaseSyscall::REG_FILE, 0, -1); // Syscall error code
       return;
@@ -1,10 +1,10 @@
 #pragma once
 
+#include <QDir>
+
 #include <type_traits>
 
-#include "processorhandler.h"
 #include "ripes_syscall.h"
-#include "systemio.h"
 
 namespace Ripes {
 
@@ -22,18 +22,9 @@ public:
   void execute() {
     const AInt arg0 = BaseSyscall::getArg(BaseSyscall::REG_FILE, 0);
     const AInt arg1 = BaseSyscall::getArg(BaseSyscall::REG_FILE, 1);
-    QByteArray string;
-    char byte;
-    unsigned int address = arg0;
-    do {
-      byte = static_cast<char>(
-          ProcessorHandler::getMemory().readMemConst(address++, 1) & 0xFF);
-      string.append(byte);
-    } while (byte != '\0');
-    if (string.endsWith('\0'))
-      string.removeLast(); // Remove null-byte
-
-    int ret = SystemIO::openFile(QString::fromUtf8(string), arg1);
+    const QByteArray string = BaseSyscall::env().readString(arg0);
+
+    int ret = BaseSyscall::env().openFile(QString::fromUtf8(string), arg1);
 
     BaseSyscall::setRet(BaseSyscall::REG_FILE, 0, ret);
   }
@@ -49,7 +40,7 @@ public:
                     {{0, "the file descriptor to close"}}) {}
   void execute() {
     const VInt arg0 = BaseSyscall::getArg(BaseSyscall::REG_FILE, 0);
-    SystemIO::closeFile(arg0);
+    BaseSyscall::env().closeFile(arg0);
   }
 };
 
@@ -67,7 +58,8 @@ public:
                     {{0, "the selected position from the beginning of the file "
                          "or -1 if an error occurred"}}) {}
   void execute() {
-    int result = SystemIO::seek(BaseSyscall::getArg(BaseSyscall::REG_FILE, 0),
+    int result =
+        BaseSyscall::env().seek(BaseSyscall::getArg(BaseSyscall::REG_FILE, 0),
                                 BaseSyscall::getArg(BaseSyscall::REG_FILE, 1),
                                 BaseSyscall::getArg(BaseSyscall::REG_FILE, 2));
     BaseSyscall::setRet(BaseSyscall::REG_FILE, 0, result);
@@ -85,6 +77,10 @@ public:
                      {1, "address of the buffer"},
                      {2, "maximum number of bytes to read"}},
                     {{0, "number of read bytes or -1 if an error occurred"}}) {}
+  bool mayBlock() const override {
+    // Reading from STDIN (fd 0) blocks until input has been provided.
+    return BaseSyscall::getArg(BaseSyscall::REG_FILE, 0) == 0;
+  }
   void execute() {
     const int fd = BaseSyscall::getArg(BaseSyscall::REG_FILE, 0);
     long byteAddress = BaseSyscall::getArg(
@@ -92,18 +88,13 @@ public:
     const int length = BaseSyscall::getArg(BaseSyscall::REG_FILE, 2);
     QByteArray buffer;
 
-    int retLength = SystemIO::readFromFile(fd, buffer, length);
+    int retLength = BaseSyscall::env().readFromFile(fd, buffer, length);
     BaseSyscall::setRet(BaseSyscall::REG_FILE, 0, retLength);
 
-    if (retLength != -1) {
+    if (retLength > 0) {
       // copy bytes from returned buffer into memory
-      const char *dataptr =
-          buffer.constData(); // QString::data contains a possible null
-                              // termination '\0' character (present if reading
-                              // from stdin and not from a file)
-      while (retLength-- > 0) {
-        ProcessorHandler::writeMem(byteAddress++, *dataptr++, sizeof(char));
-      }
+      BaseSyscall::env().writeMemBlock(byteAddress, buffer.constData(),
+                                       retLength);
     }
   }
 };
@@ -128,16 +119,10 @@ public:
       BaseSyscall::setRet(BaseSyscall::REG_FILE, 0, -1);
       return;
     }
-    int index = 0;
-    QString myBuffer;
-
-    do {
-      myBuffer.append(static_cast<char>(
-          ProcessorHandler::getMemory().readMemConst(byteAddress + index++, 1) &
-          0xFF));
-    } while (index < reqLength);
+    QByteArray myBuffer(reqLength, Qt::Uninitialized);
+    BaseSyscall::env().readMemBlock(byteAddress, myBuffer.data(), reqLength);
 
-    const int retValue = SystemIO::writeToFile(
+    const int retValue = BaseSyscall::env().writeToFile(
         BaseSyscall::getArg(BaseSyscall::REG_FILE, 0), myBuffer, reqLength);
     BaseSyscall::setRet(BaseSyscall::REG_FILE, 0, retValue);
   }
@@ -172,8 +157,8 @@ public:
 
     // copy bytes from returned buffer into memory
     while (index < pwd.length()) {
-      ProcessorHandler::writeMem(byteAddress, pwd.at(index++).toLatin1(),
-                                 sizeof(char));
+      BaseSyscall::env().writeMem(byteAddress, pwd.at(index++).toLatin1(),
+                                  sizeof(char));
     }
   }
 };
@@ -2,9 +2,7 @@
 
 #include <type_traits>
 
-#include "processorhandler.h"
 #include "ripes_syscall.h"
-#include "systemio.h"
 
 namespace Ripes {
 
@@ -19,8 +17,8 @@ public:
   void execute() {
     const VIntS arg0 = vsrtl::signextend<VInt, VIntS>(
         BaseSyscall::getArg(BaseSyscall::REG_FILE, 0),
-        ProcessorHandler::currentISA()->bits());
-    SystemIO::printString(QString::number(arg0));
+        BaseSyscall::env().isa().bits());
+    BaseSyscall::env().print(QByteArray::number(arg0));
   }
 };
 
@@ -35,7 +33,7 @@ public:
   void execute() {
     const VInt arg0 = BaseSyscall::getArg(BaseSyscall::REG_FILE, 0);
     auto *v_f = reinterpret_cast<const float *>(&arg0);
-    SystemIO::printString(QString::number(static_cast<double>(*v_f)));
+    BaseSyscall::env().print(QByteArray::number(static_cast<double>(*v_f)));
   }
 };
 
@@ -49,15 +47,7 @@ public:
                     {{0, "address of the string"}}) {}
   void execute() {
     const VInt arg0 = BaseSyscall::getArg(BaseSyscall::REG_FILE, 0);
-    QByteArray string;
-    char byte;
-    AInt address = arg0;
-    do {
-      byte = static_cast<char>(
-          ProcessorHandler::getMemory().readMemConst(address++, 1) & 0xFF);
-      string.append(byte);
-    } while (byte != '\0');
-    SystemIO::printString(QString::fromUtf8(string));
+    BaseSyscall::env().print(BaseSyscall::env().readString(arg0));
   }
 };
 
@@ -72,7 +62,12 @@ public:
             {{0, "character to print (only lowest byte is considered)"}}) {}
   void execute() {
     const VInt arg0 = BaseSyscall::getArg(BaseSyscall::REG_FILE, 0);
-    SystemIO::printString(QChar(static_cast<char>(arg0)));
+    const char c = static_cast<char>(arg0);
+    // The character is interpreted as Latin-1, and printed as UTF-8.
+    if (static_cast<unsigned char>(c) < 0x80)
+      BaseSyscall::env().print(&c, 1);
+    else
+      BaseSyscall::env().print(QString(QChar::fromLatin1(c)).toUtf8());
   }
 };
 
@@ -88,9 +83,9 @@ public:
             {{0, "integer to print"}}) {}
   void execute() {
     const VInt arg0 = BaseSyscall::getArg(BaseSyscall::REG_FILE, 0);
-    SystemIO::printString("0x" +
-                          QString::number(arg0, 16).rightJustified(
-                              ProcessorHandler::currentISA()->bytes(), '0'));
+    BaseSyscall::env().print("0x" +
+                         QByteArray::number(arg0, 16).rightJustified(
+                             BaseSyscall::env().isa().bytes(), '0'));
   }
 };
 
@@ -106,9 +101,9 @@ public:
             {{0, "integer to print"}}) {}
   void execute() {
     const VInt arg0 = BaseSyscall::getArg(BaseSyscall::REG_FILE, 0);
-    SystemIO::printString("0b" +
-                          QString::number(arg0, 2).rightJustified(
-                              ProcessorHandler::currentISA()->bits(), '0'));
+    BaseSyscall::env().print("0b" +
+                         QByteArray::number(arg0, 2).rightJustified(
+                             BaseSyscall::env().isa().bits(), '0'));
   }
 };
 
@@ -122,7 +117,7 @@ public:
                     {{0, "integer to print"}}) {}
   void execute() {
     const VInt arg0 = BaseSyscall::getArg(BaseSyscall::REG_FILE, 0);
-    SystemIO::printString(QString::number(arg0));
+    BaseSyscall::env().print(QByteArray::number(arg0));
   }
 };
 
@@ -1,38 +1,16 @@
 #include "ripes_syscall.h"
 
-#include "processorhandler.h"
-
 namespace Ripes {
 
 bool SyscallManager::execute(SyscallID id) {
-  if (m_syscalls.count(id) == 0) {
-    postToGUIThread([id] {
-      if (auto reg = ProcessorHandler::currentISA()->syscallReg();
-          reg.has_value()) {
-        QMessageBox::warning(nullptr, "Error",
-                             "Unknown system call in register '" +
-                                 reg->file->regAlias(reg->index) +
-                                 "': " + QString::number(id) +
-                                 "\nRefer to \"Help->System calls\" for a list "
-                                 "of support system "
-                                 "calls.");
-      }
-    });
+  Syscall *syscall = lookup(id);
+  if (!syscall) {
+    m_environment.unknownSyscall(id);
     return false;
   } else {
-    const auto &syscall = m_syscalls.at(id);
-    const QString &syscallName = syscall->name();
-    postToGUIThread([syscallName, id] {
-      // We don't have a good way of making non-permanent status timers
-      // pseudo-permanent until explicitly cleared... The best way to do so is
-      // to just have a very large timeout.
-      SyscallStatusManager::setStatusTimed(
-          "Handling system call: " + syscallName + " (" + QString::number(id) +
-              ")",
-          99999999);
-    });
+    m_environment.syscallStarted(syscall->name(), id);
     syscall->execute();
-    postToGUIThread([] { SyscallStatusManager::clearStatus(); });
+    m_environment.syscallFinished();
     return true;
   }
 }
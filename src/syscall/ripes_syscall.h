@@ -9,10 +9,12 @@
 #include <functional>
 #include <map>
 #include <memory>
+#include <vector>
 
 #include "../isa/isainfo.h"
 #include "isa/isa_types.h"
 #include "statusmanager.h"
+#include "syscallenvironment.h"
 
 namespace Ripes {
 
@@ -20,6 +22,8 @@ namespace Ripes {
  * @brief The Syscall class
  * Base class for all system calls. Must be specialized by an ISA/ABI specific
  * system call class. This class shall define getArg() based on the given ABI.
+ * System calls operate on the environment of the SyscallManager which owns
+ * them.
  */
 class Syscall {
 public:
@@ -44,6 +48,15 @@ public:
 
   virtual void execute() = 0;
 
+  /**
+   * @brief mayBlock
+   * Returns true if executing this syscall, given its current arguments, may
+   * block while waiting for external input (e.g. reading from stdin). Such
+   * syscalls are executed on a separate thread, whereas all other syscalls are
+   * executed directly on the thread which clocks the processor.
+   */
+  virtual bool mayBlock() const { return false; }
+
   /**
    * @brief getArg
    * ABI specific specialization of returning an argument register value.
@@ -60,11 +73,15 @@ public:
   virtual void setRet(const std::string_view &rfid, ArgIdx i,
                       VInt value) const = 0;
 
+  SyscallEnvironment &env() const { return *m_env; }
+  void setEnvironment(SyscallEnvironment &env) { m_env = &env; }
+
 protected:
   const QString m_name;
   const QString m_description;
   const std::map<ArgIdx, QString> m_argumentDescriptions;
   const std::map<ArgIdx, QString> m_returnDescriptions;
+  SyscallEnvironment *m_env = nullptr;
 };
 
 /**
@@ -73,6 +90,9 @@ protected:
  * It is expected that the syscallManager can be called outside of the main GUI
  * thread. As such, all syscalls who require GUI interaction must handle this
  * explicitly.
+ *
+ * The system calls of a manager execute on its SyscallEnvironment, which must
+ * outlive the manager.
  */
 class SyscallManager {
 public:
@@ -84,13 +104,35 @@ public:
    */
   bool execute(SyscallID id);
 
+  /**
+   * @brief lookup
+   * Returns the syscall identified by @p id, or nullptr if unknown.
+   */
+  Syscall *lookup(SyscallID id) const {
+    if (id < 0 || static_cast<size_t>(id) >= m_syscallTable.size())
+      return nullptr;
+    return m_syscallTable[id];
+  }
+
   const std::map<SyscallID, std::unique_ptr<Syscall>> &getSyscalls() const {
     return m_syscalls;
   }
 
+  SyscallEnvironment &environment() const { return m_environment; }
+
 protected:
-  SyscallManager() {}
+  SyscallManager(SyscallEnvironment &environment)
+      : m_environment(environment) {}
+  SyscallEnvironment &m_environment;
   std::map<SyscallID, std::unique_ptr<Syscall>> m_syscalls;
+
+  /**
+   * @brief m_syscallTable
+   * Dense, syscall ID-indexed view of m_syscalls (nullptr for unknown IDs).
+   * Syscall IDs are small integers, so this trades a few kB of memory for
+   * constant-time lookup during execution.
+   */
+  std::vector<Syscall *> m_syscallTable;
 };
 
 template <class T>
@@ -98,11 +140,19 @@ class SyscallManagerT : public SyscallManager {
   static_assert(std::is_base_of<Syscall, T>::value);
 
 public:
+  using SyscallManager::SyscallManager;
+
   template <class T_Syscall>
   void emplace(SyscallID id) {
     static_assert(std::is_base_of<T, T_Syscall>::value);
     assert(m_syscalls.count(id) == 0);
-    m_syscalls.emplace(id, std::make_unique<T_Syscall>());
+    assert(id >= 0);
+    auto syscall = std::make_unique<T_Syscall>();
+    syscall->setEnvironment(m_environment);
+    if (static_cast<size_t>(id) >= m_syscallTable.size())
+      m_syscallTable.resize(id + 1, nullptr);
+    m_syscallTable[id] = syscall.get();
+    m_syscalls.emplace(id, std::move(syscall));
   }
 };
 
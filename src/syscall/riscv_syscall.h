@@ -1,7 +1,6 @@
 #pragma once
 
 #include "isa/rvisainfo_common.h"
-#include "processorhandler.h"
 #include "ripes_syscall.h"
 
 // Syscall headers
@@ -28,7 +27,7 @@ public:
     // RISC-V arguments range from a0-a6
     assert(i < 7);
     const int regIdx = 10 + i; // a0 = x10
-    return ProcessorHandler::getRegisterValue(rfid, regIdx);
+    return env().getRegister(rfid, regIdx);
   }
 
   void setRet(const std::string_view &rfid, ArgIdx i,
@@ -36,13 +35,14 @@ public:
     // RISC-V arguments range from a0-a6
     assert(i < 7);
     const int regIdx = 10 + i; // a0 = x10
-    ProcessorHandler::setRegisterValue(rfid, regIdx, value);
+    env().setRegister(rfid, regIdx, value);
   }
 };
 
 class RISCVSyscallManager : public SyscallManagerT<RISCVSyscall> {
 public:
-  RISCVSyscallManager() {
+  RISCVSyscallManager(SyscallEnvironment &environment)
+      : SyscallManagerT(environment) {
     // Print syscalls
     emplace<PrintIntSyscall<RISCVSyscall>>(RVABI::PrintInt);
     emplace<PrintFloatSyscall<RISCVSyscall>>(RVABI::PrintFloat);
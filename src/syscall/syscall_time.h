@@ -2,11 +2,7 @@
 
 #include <type_traits>
 
-#include "processorhandler.h"
 #include "ripes_syscall.h"
-#include "systemio.h"
-
-#include <QDateTime>
 
 namespace Ripes {
 template <typename BaseSyscall>
@@ -20,7 +16,7 @@ public:
                     {{0, "low 32 bits of cycles elapsed"},
                      {1, "high 32 bits of cycles elapsed"}}) {}
   void execute() {
-    long long cycleCount = ProcessorHandler::getProcessor()->getCycleCount();
+    long long cycleCount = BaseSyscall::env().processor().getCycleCount();
     BaseSyscall::setRet(BaseSyscall::REG_FILE, 0, cycleCount & 0xFFFFFFFF);
     BaseSyscall::setRet(BaseSyscall::REG_FILE, 1,
                         (cycleCount >> 32) & 0xFFFFFFFF);
@@ -35,12 +31,13 @@ public:
   TimeMsSyscall()
       : BaseSyscall("Time_msec",
                     "Get the current time since epoch (milliseconds since 1 "
-                    "January 1970)",
+                    "January 1970). With virtual time enabled, the simulated "
+                    "time since processor reset",
                     {},
                     {{0, "low 32 bits of milliseconds since epoch"},
                      {1, "high 32 bits of milliseconds since epoch"}}) {}
   void execute() {
-    long long ms = QDateTime::currentMSecsSinceEpoch();
+    const uint64_t ms = BaseSyscall::env().timeNanos() / 1000000ull;
     BaseSyscall::setRet(BaseSyscall::REG_FILE, 0, ms & 0xFFFFFFFF);
     BaseSyscall::setRet(BaseSyscall::REG_FILE, 1, (ms >> 32) & 0xFFFFFFFF);
   }
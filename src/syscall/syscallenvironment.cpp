@@ -0,0 +1,161 @@
+#include "syscallenvironment.h"
+
+#include <QMessageBox>
+
+#include <chrono>
+
+#include "processorhandler.h"
+#include "statusmanager.h"
+#include "systemio.h"
+
+namespace Ripes {
+
+void SyscallEnvironment::readMemBlock(AInt address, char *dst,
+                                      size_t size) const {
+  for (size_t i = 0; i < size; ++i)
+    dst[i] = static_cast<char>(readMem(address + i, 1) & 0xFF);
+}
+
+void SyscallEnvironment::writeMemBlock(AInt address, const char *src,
+                                       size_t size) {
+  for (size_t i = 0; i < size; ++i)
+    writeMem(address + i, static_cast<uint8_t>(src[i]), 1);
+}
+
+QByteArray SyscallEnvironment::readString(AInt address) const {
+  QByteArray string;
+  while (char byte = static_cast<char>(readMem(address++, 1) & 0xFF))
+    string.append(byte);
+  return string;
+}
+
+void SyscallEnvironment::exit(VInt code) {
+  print("\nProgram exited with code: " + QByteArray::number(code) + "\n");
+  processor().finalize(RipesProcessor::FinalizeReason::exitSyscall);
+}
+
+uint64_t SyscallEnvironment::timeNanos(uint64_t cycles,
+                                       uint64_t virtualTimeFreq) {
+  if (virtualTimeFreq == 0) {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch())
+            .count());
+  }
+
+  // cycles * 1e9 / freq, split to avoid overflowing for long runs.
+  constexpr uint64_t nsPerSecond = 1000000000ull;
+  return (cycles / virtualTimeFreq) * nsPerSecond +
+         (cycles % virtualTimeFreq) * nsPerSecond / virtualTimeFreq;
+}
+
+// ProcessorHandlerSyscallEnvironment
+
+const ISAInfoBase &ProcessorHandlerSyscallEnvironment::isa() const {
+  return *ProcessorHandler::currentISA();
+}
+
+RipesProcessor &ProcessorHandlerSyscallEnvironment::processor() {
+  return *ProcessorHandler::getProcessorNonConst();
+}
+
+VInt ProcessorHandlerSyscallEnvironment::getRegister(std::string_view rfid,
+                                                     unsigned idx) const {
+  return ProcessorHandler::getRegisterValue(rfid, idx);
+}
+
+void ProcessorHandlerSyscallEnvironment::setRegister(std::string_view rfid,
+                                                     unsigned idx,
+                                                     VInt value) {
+  ProcessorHandler::setRegisterValue(rfid, idx, value);
+}
+
+VInt ProcessorHandlerSyscallEnvironment::readMem(AInt address,
+                                                 unsigned bytes) const {
+  return ProcessorHandler::getMemory().readMemConst(address, bytes);
+}
+
+void ProcessorHandlerSyscallEnvironment::writeMem(AInt address, VInt value,
+                                                  unsigned bytes) {
+  ProcessorHandler::writeMem(address, value, bytes);
+}
+
+void ProcessorHandlerSyscallEnvironment::readMemBlock(AInt address, char *dst,
+                                                      size_t size) const {
+  ProcessorHandler::readMemBlock(address, dst, size);
+}
+
+void ProcessorHandlerSyscallEnvironment::writeMemBlock(AInt address,
+                                                       const char *src,
+                                                       size_t size) {
+  ProcessorHandler::writeMemBlock(address, src, size);
+}
+
+uint64_t ProcessorHandlerSyscallEnvironment::timeNanos() const {
+  return ProcessorHandler::timeNanos();
+}
+
+void ProcessorHandlerSyscallEnvironment::print(const char *data, size_t size) {
+  SystemIO::printBytes(data, size);
+}
+
+int ProcessorHandlerSyscallEnvironment::openFile(const QString &filename,
+                                                 unsigned flags) {
+  ProcessorHandler::recordHostFileAccess();
+  return SystemIO::openFile(filename, flags);
+}
+
+void ProcessorHandlerSyscallEnvironment::closeFile(int fd) {
+  SystemIO::closeFile(fd);
+}
+
+int ProcessorHandlerSyscallEnvironment::seek(int fd, int offset, int base) {
+  return SystemIO::seek(fd, offset, base);
+}
+
+int ProcessorHandlerSyscallEnvironment::readFromFile(int fd,
+                                                     QByteArray &buffer,
+                                                     int length) {
+  if (fd == 0) // STDIN
+    ProcessorHandler::recordHostInput();
+  return SystemIO::readFromFile(fd, buffer, length);
+}
+
+int ProcessorHandlerSyscallEnvironment::writeToFile(int fd,
+                                                    const QByteArray &buffer,
+                                                    int length) {
+  return SystemIO::writeToFile(fd, buffer, length);
+}
+
+void ProcessorHandlerSyscallEnvironment::syscallStarted(const QString &name,
+                                                        int id) {
+  postToGUIThread([name, id] {
+    // We don't have a good way of making non-permanent status timers
+    // pseudo-permanent until explicitly cleared... The best way to do so is
+    // to just have a very large timeout.
+    SyscallStatusManager::setStatusTimed("Handling system call: " + name +
+                                             " (" + QString::number(id) + ")",
+                                         99999999);
+  });
+}
+
+void ProcessorHandlerSyscallEnvironment::syscallFinished() {
+  postToGUIThread([] { SyscallStatusManager::clearStatus(); });
+}
+
+void ProcessorHandlerSyscallEnvironment::unknownSyscall(int id) {
+  postToGUIThread([id] {
+    if (auto reg = ProcessorHandler::currentISA()->syscallReg();
+        reg.has_value()) {
+      QMessageBox::warning(nullptr, "Error",
+                           "Unknown system call in register '" +
+                               reg->file->regAlias(reg->index) +
+                               "': " + QString::number(id) +
+                               "\nRefer to \"Help->System calls\" for a list "
+                               "of support system "
+                               "calls.");
+    }
+  });
+}
+
+} // namespace Ripes
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+
+#include <string_view>
+
+#include "isa/isainfo.h"
+#include "processors/interface/ripesprocessor.h"
+
+namespace Ripes {
+
+/**
+ * @brief The SyscallEnvironment class
+ * The processor state and I/O services which system calls operate on. System
+ * calls access registers, memory and program I/O exclusively through their
+ * environment, such that the same system call implementations serve both the
+ * GUI/CLI (see ProcessorHandlerSyscallEnvironment) and self-contained
+ * simulation instances (see Simulator).
+ *
+ * The file operations follow the conventions of the SystemIO functions of the
+ * same name.
+ */
+class SyscallEnvironment {
+public:
+  virtual ~SyscallEnvironment() = default;
+
+  virtual const ISAInfoBase &isa() const = 0;
+  virtual RipesProcessor &processor() = 0;
+
+  virtual VInt getRegister(std::string_view rfid, unsigned idx) const = 0;
+  virtual void setRegister(std::string_view rfid, unsigned idx,
+                           VInt value) = 0;
+  virtual VInt readMem(AInt address, unsigned bytes) const = 0;
+  virtual void writeMem(AInt address, VInt value, unsigned bytes) = 0;
+  virtual void readMemBlock(AInt address, char *dst, size_t size) const;
+  virtual void writeMemBlock(AInt address, const char *src, size_t size);
+  /// Reads the null-terminated string at @p address (excluding the null-byte).
+  QByteArray readString(AInt address) const;
+
+  /// Returns the current time in nanoseconds, as seen by the program.
+  virtual uint64_t timeNanos() const = 0;
+
+  /// Prints @p size bytes of program output to STDOUT.
+  virtual void print(const char *data, size_t size) = 0;
+  void print(const QByteArray &bytes) {
+    print(bytes.constData(), bytes.size());
+  }
+  virtual int openFile(const QString &filename, unsigned flags) = 0;
+  virtual void closeFile(int fd) = 0;
+  virtual int seek(int fd, int offset, int base) = 0;
+  virtual int readFromFile(int fd, QByteArray &buffer, int length) = 0;
+  virtual int writeToFile(int fd, const QByteArray &buffer, int length) = 0;
+
+  /// Exits the program with @p code. By default, the exit code is printed and
+  /// the processor is finalized.
+  virtual void exit(VInt code);
+
+  /// Called by the SyscallManager around the execution of system call @p id.
+  virtual void syscallStarted(const QString & /*name*/, int /*id*/) {}
+  virtual void syscallFinished() {}
+  /// Called by the SyscallManager if system call @p id is unknown.
+  virtual void unknownSyscall(int /*id*/) {}
+
+  /// Returns the time since epoch if @p virtualTimeFreq is 0, and otherwise
+  /// the simulated time of @p cycles cycles at @p virtualTimeFreq Hz.
+  static uint64_t timeNanos(uint64_t cycles, uint64_t virtualTimeFreq);
+};
+
+/**
+ * @brief The ProcessorHandlerSyscallEnvironment class
+ * Executes system calls on the processor of the ProcessorHandler, with program
+ * I/O through SystemIO. System call progress and errors are reported in the
+ * GUI, if present.
+ */
+class ProcessorHandlerSyscallEnvironment : public SyscallEnvironment {
+public:
+  const ISAInfoBase &isa() const override;
+  RipesProcessor &processor() override;
+
+  VInt getRegister(std::string_view rfid, unsigned idx) const override;
+  void setRegister(std::string_view rfid, unsigned idx, VInt value) override;
+  VInt readMem(AInt address, unsigned bytes) const override;
+  void writeMem(AInt address, VInt value, unsigned bytes) override;
+  void readMemBlock(AInt address, char *dst, size_t size) const override;
+  void writeMemBlock(AInt address, const char *src, size_t size) override;
+
+  uint64_t timeNanos() const override;
+
+  void print(const char *data, size_t size) override;
+  int openFile(const QString &filename, unsigned flags) override;
+  void closeFile(int fd) override;
+  int seek(int fd, int offset, int base) override;
+  int readFromFile(int fd, QByteArray &buffer, int length) override;
+  int writeToFile(int fd, const QByteArray &buffer, int length) override;
+
+  void syscallStarted(const QString &name, int id) override;
+  void syscallFinished() override;
+  void unknownSyscall(int id) override;
+};
+
+} // namespace Ripes
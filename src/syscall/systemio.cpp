@@ -11,4 +11,6 @@ QByteArray SystemIO::FileIOData::s_stdinBuffer;
 QMutex SystemIO::FileIOData::s_stdioMutex;
 QWaitCondition SystemIO::FileIOData::s_stdinBufferEmpty;
 bool SystemIO::s_abortSyscall = false;
+OutputSink *SystemIO::s_outputSink = nullptr;
+QStringDecoder SystemIO::s_outputDecoder(QStringDecoder::Utf8);
 } // namespace Ripes
@@ -6,10 +6,12 @@
 #include <QInputDialog>
 #include <QMutex>
 #include <QObject>
+#include <QStringDecoder>
 #include <QTemporaryFile>
 #include <QTextStream>
 #include <QWaitCondition>
 
+#include <algorithm>
 #include <set>
 #include <stdexcept>
 #include <sys/stat.h>
@@ -47,6 +49,20 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 (MIT license, http://www.opensource.org/licenses/mit-license.html)
 */
 
+/**
+ * @brief The OutputSink class
+ * A byte-oriented destination for program output written to STDOUT/STDERR.
+ * When a sink is installed through SystemIO::setOutputSink, output is written
+ * to it as raw (UTF-8) bytes, rather than being emitted as a QString through
+ * the SystemIO::doPrint signal.
+ */
+class OutputSink {
+public:
+  virtual ~OutputSink() = default;
+  virtual void write(const char *data, size_t size) = 0;
+  virtual void flush() = 0;
+};
+
 /**
  * @brief The SystemIO class
  * Provides standard i/o services needed to simulate the RISCV syscall
@@ -69,6 +85,12 @@ private:
   // Flag used for aborting waiting for I/O
   static bool s_abortSyscall;
 
+  // Installed output sink for STDOUT/STDERR, if any (not owned).
+  static OutputSink *s_outputSink;
+  // Decodes program output for the doPrint signal. The decoder is stateful,
+  // such that UTF-8 sequences split across writes are decoded once complete.
+  static QStringDecoder s_outputDecoder;
+
   // Standard I/O Channels
   enum STDIO { STDIN = 0, STDOUT = 1, STDERR = 2, STDIO_END };
 
@@ -98,7 +120,8 @@ private:
     static std::map<int, QString> fileNames;
     // The flags of this file. Invalid if this file descriptor is not in use.
     static std::map<int, unsigned> fileFlags;
-    // The streams in use, associated with the filenames
+    // The text stream used for STDIN. Regular files are accessed as raw bytes
+    // through their QFile, without any text-codec layer.
     static std::map<int, QTextStream> streams;
     // The file pointers in use
     static std::map<int, QFile> files;
@@ -180,8 +203,6 @@ private:
       if (!file.isOpen()) {
         throw std::runtime_error("File could not be opened");
       }
-
-      streams.emplace(fd, &files[fd]);
     }
 
     // Retrieve a stream for use
@@ -216,7 +237,6 @@ private:
 
       fileFlags[fd] = O_ACCMODE; // set flag to invalid read/write mode
       files[fd].close();
-      streams.erase(fd);
       files.erase(fd);
       fileNames.erase(fd);
     }
@@ -308,23 +328,23 @@ public:
           "File descriptor " + QString::number(fd) + " is not open for reading";
       return -1;
     }
-    if (fd < 0 || fd >= SYSCALL_MAXFILES)
+    if (fd < STDIO_END || fd >= SYSCALL_MAXFILES)
       return -1;
-    auto &stream = FileIOData::getStreamInUse(fd);
+    auto &file = FileIOData::files[fd];
 
     if (base == SEEK_SET) {
       offset += 0;
     } else if (base == SEEK_CUR) {
-      offset += stream.pos();
+      offset += file.pos();
     } else if (base == SEEK_END) {
-      offset += FileIOData::files[fd].size();
+      offset += file.size();
     } else {
       return -1;
     }
     if (offset < 0) {
       return -1;
     }
-    stream.seek(offset);
+    file.seek(offset);
     return offset;
   }
 
@@ -332,7 +352,7 @@ public:
    * Read bytes from file.
    *
    * @param fd              file descriptor
-   * @param myBuffer        QString to contain bytes read
+   * @param myBuffer        byte array to contain bytes read
    * @param lengthRequested number of bytes to read
    * @return number of bytes read, 0 on EOF, or -1 on error
    */
@@ -351,10 +371,11 @@ public:
           "File descriptor " + QString::number(fd) + " is not open for reading";
       return -1;
     }
-    // retrieve FileInputStream from storage
-    auto &InputStream = FileIOData::getStreamInUse(fd);
-
     if (fd == STDIN) {
+      auto &InputStream = FileIOData::getStreamInUse(fd);
+      // Ensure that any pending output (such as a prompt) is visible before
+      // blocking on input.
+      flushOutput();
       // systemIO might be called from non-gui thread, so be threadsafe in
       // interacting with the ui.
       postToGUIThread([] {
@@ -383,9 +404,17 @@ public:
           break;
       }
     } else {
-      // Reads up to lengthRequested bytes of data from this Input stream into
-      // an array of bytes.
-      myBuffer = InputStream.read(lengthRequested).toUtf8();
+      // Reads up to lengthRequested raw bytes of data from the file.
+      myBuffer.resize(lengthRequested);
+      const qint64 bytesRead =
+          FileIOData::files[fd].read(myBuffer.data(), lengthRequested);
+      if (bytesRead < 0) {
+        s_fileErrorString = "Could not read from file descriptor " +
+                            QString::number(fd) + ": " +
+                            FileIOData::files[fd].errorString();
+        return -1;
+      }
+      myBuffer.resize(bytesRead);
     }
 
     if (myBuffer.size() == 0) {
@@ -411,10 +440,11 @@ public:
    * @return number of bytes written, or -1 on error
    */
 
-  static int writeToFile(int fd, const QString &myBuffer, int lengthRequested) {
+  static int writeToFile(int fd, const QByteArray &myBuffer,
+                         int lengthRequested) {
     SystemIO::get(); // Ensure that SystemIO is constructed
     if (fd == STDOUT || fd == STDERR) {
-      emit get().doPrint(myBuffer);
+      printBytes(myBuffer.constData(), myBuffer.size());
       return myBuffer.size();
     }
 
@@ -426,12 +456,19 @@ public:
           "File descriptor " + QString::number(fd) + " is not open for writing";
       return -1;
     }
-    // retrieve FileOutputStream from storage
-    auto &outputStream = FileIOData::getStreamInUse(fd);
-
-    outputStream << myBuffer;
-    outputStream.flush();
-    return lengthRequested;
+    // Write the raw bytes to the file. The file is flushed, such that the data
+    // is visible to any other descriptor of the same file.
+    auto &file = FileIOData::files[fd];
+    const qint64 bytesWritten =
+        file.write(myBuffer.constData(), std::min<qint64>(lengthRequested,
+                                                          myBuffer.size()));
+    if (bytesWritten < 0) {
+      s_fileErrorString = "Could not write to file descriptor " +
+                          QString::number(fd) + ": " + file.errorString();
+      return -1;
+    }
+    file.flush();
+    return bytesWritten;
 
   } // end writeToFile
 
@@ -452,8 +489,52 @@ public:
    */
   static void closeFile(int fd) { FileIOData::close(fd); }
 
-  static void printString(const QString &string) { emit get().doPrint(string); }
-  static void reset() { FileIOData::resetFiles(); }
+  static void printString(const QString &string) {
+    if (s_outputSink) {
+      const QByteArray bytes = string.toUtf8();
+      s_outputSink->write(bytes.constData(), bytes.size());
+    } else
+      emit get().doPrint(string);
+  }
+
+  /**
+   * @brief printBytes
+   * Prints @p size bytes of (UTF-8) program output. If an output sink is
+   * installed, the bytes are passed directly to it, without any QString
+   * conversion. Otherwise, incomplete UTF-8 sequences at the end of @p data
+   * are held back until completed by a subsequent write.
+   */
+  static void printBytes(const char *data, size_t size) {
+    if (s_outputSink) {
+      s_outputSink->write(data, size);
+      return;
+    }
+    const QString string = s_outputDecoder.decode(QByteArrayView(data, size));
+    if (!string.isEmpty())
+      emit get().doPrint(string);
+  }
+  static void printBytes(const QByteArray &bytes) {
+    printBytes(bytes.constData(), bytes.size());
+  }
+
+  /**
+   * @brief setOutputSink
+   * Redirects STDOUT/STDERR output to @p sink. Ownership is not transferred.
+   * Passing nullptr restores output through the doPrint signal. The sink is
+   * written to from the thread executing syscalls, so it should only be
+   * changed while no program is running.
+   */
+  static void setOutputSink(OutputSink *sink) { s_outputSink = sink; }
+
+  /// Flushes the installed output sink, if any.
+  static void flushOutput() {
+    if (s_outputSink)
+      s_outputSink->flush();
+  }
+  static void reset() {
+    FileIOData::resetFiles();
+    s_outputDecoder.resetState();
+  }
   static void abortSyscall() { s_abortSyscall = true; }
 
 signals:
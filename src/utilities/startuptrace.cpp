@@ -0,0 +1,50 @@
+#include "startuptrace.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+
+namespace Ripes {
+
+void StartupTrace::record(const QString &name, qint64 startUs,
+                          qint64 durationUs) {
+  auto &trace = get();
+  const auto threadId = static_cast<quint64>(
+      reinterpret_cast<quintptr>(QThread::currentThreadId()));
+  std::lock_guard lock(trace.m_lock);
+  trace.m_spans.push_back({name, startUs, durationUs, threadId});
+}
+
+bool StartupTrace::writeChromeTrace(const QString &path) {
+  auto &trace = get();
+  QJsonArray events;
+  {
+    std::lock_guard lock(trace.m_lock);
+    for (const auto &span : trace.m_spans) {
+      // "Complete" events; nested spans are displayed as a call stack.
+      QJsonObject event;
+      event["name"] = span.name;
+      event["cat"] = "startup";
+      event["ph"] = "X";
+      event["ts"] = span.startUs;
+      event["dur"] = span.durationUs;
+      event["pid"] = 1;
+      event["tid"] = static_cast<qint64>(span.threadId);
+      events.append(event);
+    }
+  }
+
+  QJsonObject root;
+  root["traceEvents"] = events;
+  root["displayTimeUnit"] = "ms";
+
+  QFile file(path);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    return false;
+  file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+  return true;
+}
+
+} // namespace Ripes
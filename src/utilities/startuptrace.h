@@ -0,0 +1,68 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QString>
+
+#include <mutex>
+#include <vector>
+
+namespace Ripes {
+
+/**
+ * @brief The StartupTrace class
+ * Records timed spans of application startup (construction of subsystems,
+ * tabs, the processor layout, ...), which may be written as a Chrome trace
+ * event JSON file, viewable in chrome://tracing or Perfetto. Spans are always
+ * recorded - recording is cheap and only performed for a handful of coarse
+ * startup stages - but only written when requested (--startup-trace).
+ * Timestamps are relative to the first use of the trace, which is expected to
+ * be at the very start of main().
+ */
+class StartupTrace {
+public:
+  struct Span {
+    QString name;
+    qint64 startUs;
+    qint64 durationUs;
+    quint64 threadId;
+  };
+
+  /// Starts the trace clock. Called at the start of main().
+  static void start() { get(); }
+
+  /// Microseconds elapsed since the trace was started.
+  static qint64 nowUs() { return get().m_timer.nsecsElapsed() / 1000; }
+
+  static void record(const QString &name, qint64 startUs, qint64 durationUs);
+
+  /// Writes the recorded spans to @p path as a Chrome trace event JSON file.
+  /// Returns false if the file could not be written.
+  static bool writeChromeTrace(const QString &path);
+
+private:
+  StartupTrace() { m_timer.start(); }
+  static StartupTrace &get() {
+    static StartupTrace trace;
+    return trace;
+  }
+
+  QElapsedTimer m_timer;
+  std::mutex m_lock;
+  std::vector<Span> m_spans;
+};
+
+/// Records a StartupTrace span covering the lifetime of the object.
+class TraceSpan {
+public:
+  explicit TraceSpan(const QString &name)
+      : m_name(name), m_startUs(StartupTrace::nowUs()) {}
+  ~TraceSpan() {
+    StartupTrace::record(m_name, m_startUs, StartupTrace::nowUs() - m_startUs);
+  }
+
+private:
+  QString m_name;
+  qint64 m_startUs;
+};
+
+} // namespace Ripes
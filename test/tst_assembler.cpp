@@ -1,3 +1,5 @@
+#include <QTemporaryDir>
+#include <QTemporaryFile>
 #include <QtTest/QTest>
 
 #include "assembler/matcher.h"
@@ -5,6 +7,7 @@
 #include "isa/rv32isainfo.h"
 
 #include "assembler/assembler.h"
+#include "assembler/programcache.h"
 
 #include "processorhandler.h"
 
@@ -43,9 +46,14 @@ private slots:
   void tst_invalidLabel();
   void tst_directives();
   void tst_stringDirectives();
+  void tst_dataDirectives();
+  void tst_reptDirective();
+  void tst_macros();
   void tst_riscv();
   void tst_relativeLabels();
   void tst_parentheses();
+  void tst_cachedAssembler();
+  void tst_programCache();
 
 private:
   QString createProgram(int entries) {
@@ -360,6 +368,210 @@ void tst_Assembler::tst_stringDirectives() {
   testAssemble(QStringList() << R"(A: .string "")", Expect::Success);
 }
 
+void tst_Assembler::tst_dataDirectives() {
+  QByteArray expectData;
+
+  // .space/.skip with and without fill value
+  expectData.append(QByteArray(3, 0));
+  expectData.append(QByteArray(2, 0x7F));
+  expectData.append(QByteArray(1, 0));
+  testAssemble(QStringList() << ".data"
+                             << ".space 3"
+                             << ".space 2 0x7F"
+                             << ".skip 1",
+               Expect::Success, expectData);
+  testAssemble(QStringList() << ".data"
+                             << ".space 2 256",
+               Expect::Fail);
+
+  // .fill repeat, size, value
+  expectData.clear();
+  expectData.append(toByteArray(0x1234, 2).repeated(3));
+  expectData.append(QByteArray(2, 0));
+  expectData.append(toByteArray(0x12345678, 4));
+  testAssemble(QStringList() << ".data"
+                             << ".fill 3 2 0x1234"
+                             << ".fill 2"
+                             << ".fill 1 4 0x12345678",
+               Expect::Success, expectData);
+  testAssemble(QStringList() << ".data"
+                             << ".fill 1 9 0",
+               Expect::Fail);
+
+  // .space/.fill may not extend into the following section (.bss, 16 MiB
+  // after .data), nor beyond the 32-bit address space.
+  testAssemble(QStringList() << ".data"
+                             << ".space 0x1000001",
+               Expect::Fail);
+  testAssemble(QStringList() << ".data"
+                             << ".byte 1"
+                             << ".space 0xFFFFFF",
+               Expect::Fail);
+  testAssemble(QStringList() << ".data"
+                             << ".fill 0x400001 4",
+               Expect::Fail);
+  testAssemble(QStringList() << ".data"
+                             << ".fill 0x7FFFFFFFFFFFFFFF 8",
+               Expect::Fail);
+  testAssemble(QStringList() << ".bss"
+                             << ".space 0xF0000000",
+               Expect::Fail);
+
+  // .incbin with optional skip and count
+  QTemporaryFile file;
+  QVERIFY(file.open());
+  const QByteArray contents("\x01\x02\x03\x04\x05\x06", 6);
+  file.write(contents);
+  file.close();
+  const QString path = "\"" + file.fileName() + "\"";
+  expectData = contents + contents.mid(2) + contents.mid(1, 2);
+  testAssemble(QStringList() << ".data"
+                             << ".incbin " + path
+                             << ".incbin " + path + " 2"
+                             << ".incbin " + path + " 1 2",
+               Expect::Success, expectData);
+  testAssemble(QStringList() << ".data"
+                             << ".incbin " + path + " 4 3",
+               Expect::Fail);
+  testAssemble(QStringList() << ".data"
+                             << ".incbin \"/nonexistent/file.bin\"",
+               Expect::Fail);
+}
+
+void tst_Assembler::tst_reptDirective() {
+  QByteArray expectData;
+
+  // Nested repetitions, with a label preceding the outer block
+  expectData.append(QByteArray(1, 1));
+  expectData.append(toByteArray(2, 2).repeated(3));
+  expectData = expectData.repeated(2);
+  testAssemble(QStringList() << ".data"
+                             << ".equ N 3"
+                             << "table: .rept 2"
+                             << ".byte 1"
+                             << ".rept N"
+                             << ".half 2"
+                             << ".endr"
+                             << ".endr",
+               Expect::Success, expectData);
+
+  // Zero repetitions emit nothing; the label refers to the next line.
+  expectData = toByteArray(42, 4);
+  testAssemble(QStringList() << ".data"
+                             << "A: .rept 0"
+                             << ".word 1"
+                             << ".endr"
+                             << ".word 42"
+                             << ".text"
+                             << "la a0 A",
+               Expect::Success, expectData);
+
+  // Instructions may be repeated
+  testAssemble(QStringList() << ".rept 4"
+                             << "addi a0 a0 1"
+                             << ".endr",
+               Expect::Success);
+
+  // Unmatched blocks, labels defined within repeated blocks
+  testAssemble(QStringList() << ".rept 2"
+                             << "nop",
+               Expect::Fail);
+  testAssemble(QStringList() << "nop"
+                             << ".endr",
+               Expect::Fail);
+  testAssemble(QStringList() << ".rept 2"
+                             << "B: nop"
+                             << ".endr",
+               Expect::Fail);
+}
+
+void tst_Assembler::tst_macros() {
+  // Positional, named and default arguments
+  QByteArray expectData;
+  expectData.append(toByteArray(1, 4));
+  expectData.append(toByteArray(2, 2));
+  expectData.append(toByteArray(3, 4));
+  expectData.append(toByteArray(4, 2));
+  expectData.append(toByteArray(5, 4));
+  expectData.append(toByteArray(0, 2));
+  testAssemble(QStringList() << ".macro pair a b=0"
+                             << ".word \\a"
+                             << ".half \\b"
+                             << ".endm"
+                             << ".data"
+                             << "pair 1 2"
+                             << "pair b=4 a=3"
+                             << "pair 5",
+               Expect::Success, expectData);
+
+  // Macros expand to (pseudo-)instructions and may invoke other macros. A
+  // macro with the same arguments is expanded identically to the first
+  // (cached) expansion.
+  const QStringList program = {".macro inc reg",  "addi \\reg \\reg 1",
+                               ".endm",           ".macro inc2 reg",
+                               "inc \\reg",     "li \\reg 0x12345",
+                               ".endm",           "start: inc2 a0",
+                               "inc2 a1",         "inc2 a0",
+                               "j start"};
+  const QStringList expanded = {"start: addi a0 a0 1", "li a0 0x12345",
+                                "addi a1 a1 1",        "li a1 0x12345",
+                                "addi a0 a0 1",        "li a0 0x12345",
+                                "j start"};
+  auto isa = std::make_shared<ISAInfo<ISA::RV32I>>(QStringList());
+  auto assembler = ISA_Assembler<ISA::RV32I>(isa);
+  auto res = assembler.assemble(program);
+  auto expected = assembler.assemble(expanded);
+  QVERIFY(res.errors.size() == 0);
+  QVERIFY(expected.errors.size() == 0);
+  QCOMPARE(res.program.getSection(".text")->data,
+           expected.program.getSection(".text")->data);
+
+  // Unique labels through the expansion counter
+  testAssemble(QStringList() << ".macro loop reg"
+                             << "l\\@: addi \\reg \\reg -1"
+                             << "bnez \\reg l\\@"
+                             << ".endm"
+                             << "loop a0"
+                             << "loop a0",
+               Expect::Success);
+
+  // Labels without the expansion counter are defined once per expansion
+  testAssemble(QStringList() << ".macro m"
+                             << "L: nop"
+                             << ".endm"
+                             << "m"
+                             << "m",
+               Expect::Fail);
+
+  // Malformed definitions and invocations
+  testAssemble(QStringList() << ".macro m a"
+                             << "nop",
+               Expect::Fail);
+  testAssemble(QStringList() << ".endm", Expect::Fail);
+  testAssemble(QStringList() << ".macro m a"
+                             << ".endm"
+                             << "m 1 2",
+               Expect::Fail);
+  testAssemble(QStringList() << ".macro m"
+                             << "m"
+                             << ".endm"
+                             << "m",
+               Expect::Fail);
+
+  // .rept blocks are unrolled before macros are expanded, and are thus
+  // rejected within a macro body.
+  const QStringList reptInMacro = {".macro m", "L: .rept 2", "nop", ".endr",
+                                   ".endm",    "m"};
+  auto isa = std::make_shared<ISAInfo<ISA::RV32I>>(QStringList());
+  auto reptRes = ISA_Assembler<ISA::RV32I>(isa).assemble(reptInMacro);
+  QCOMPARE(reptRes.errors.size(), size_t(2));
+  QCOMPARE(reptRes.errors.at(0).sourceLine(), int64_t(1));
+  QCOMPARE(reptRes.errors.at(0).errorMessage(),
+           QString("'.rept' is not supported inside .macro"));
+  QCOMPARE(reptRes.errors.at(1).errorMessage(),
+           QString("'.endr' is not supported inside .macro"));
+}
+
 void tst_Assembler::tst_relativeLabels() {
   testAssemble(QStringList() << "1f:  bne x0 a0 1f", Expect::Fail);
   testAssemble(QStringList() << "1:  bne x0 a0 1f"
@@ -425,5 +637,83 @@ void tst_Assembler::tst_parentheses() {
   testAssemble(QStringList() << "#)nonmatching parentheses(", Expect::Success);
 }
 
+void tst_Assembler::tst_cachedAssembler() {
+  // Assemblers are shared between ISA instances of the same configuration,
+  // regardless of the order of the extensions.
+  auto rv32imc = getCachedAssembler(
+      std::make_shared<ISAInfo<ISA::RV32I>>(QStringList() << "M" << "C"));
+  auto rv32icm = getCachedAssembler(
+      std::make_shared<ISAInfo<ISA::RV32I>>(QStringList() << "C" << "M"));
+  auto rv32i =
+      getCachedAssembler(std::make_shared<ISAInfo<ISA::RV32I>>(QStringList()));
+  QCOMPARE(rv32imc.get(), rv32icm.get());
+  QVERIFY(rv32imc.get() != rv32i.get());
+
+  // A shared assembler yields the same program as a freshly constructed one.
+  const QStringList program = {"addi a0 a0 1", "mul a1 a0 a0"};
+  auto isa = std::make_shared<ISAInfo<ISA::RV32I>>(QStringList() << "M");
+  auto fresh = ISA_Assembler<ISA::RV32I>(isa);
+  auto expected = fresh.assemble(program);
+  auto res = getCachedAssembler(isa)->assemble(program);
+  QVERIFY(res.errors.size() == 0);
+  QCOMPARE(res.program.getSection(".text")->data,
+           expected.program.getSection(".text")->data);
+
+  // Segment bases provided to an assembly apply to that assembly only.
+  const SegmentBases defaults = getCachedAssembler(isa)->getSegmentBases();
+  SegmentBases bases = defaults;
+  bases[".text"] = 0x1000;
+  res = getCachedAssembler(isa)->assemble(program, nullptr, QString(), &bases);
+  QVERIFY(res.errors.size() == 0);
+  QCOMPARE(res.program.getSection(".text")->address, static_cast<AInt>(0x1000));
+  QVERIFY(getCachedAssembler(isa)->getSegmentBases() == defaults);
+  res = getCachedAssembler(isa)->assemble(program);
+  QCOMPARE(res.program.getSection(".text")->address, defaults.at(".text"));
+}
+
+void tst_Assembler::tst_programCache() {
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+  const ProgramCache cache(dir.path());
+  auto isa = std::make_shared<ISAInfo<ISA::RV32I>>(QStringList() << "M");
+  auto assembler = ISA_Assembler<ISA::RV32I>(isa);
+  const QString source = ".data\nv: .word 1 2\n.text\n"
+                         "main: la a0 v\nmul a1 a0 a0\nj main\n";
+
+  // A miss assembles the program and stores it in the cache.
+  const QString key = ProgramCache::key(source, assembler, *isa, nullptr);
+  QVERIFY(!cache.lookup(key));
+  auto res = cache.assemble(source, assembler, *isa);
+  QVERIFY(res.errors.size() == 0);
+
+  // The cached program is identical to the assembled program.
+  auto cached = cache.lookup(key);
+  QVERIFY(cached);
+  QCOMPARE(cached->entryPoint, res.program.entryPoint);
+  QCOMPARE(cached->sections.size(), res.program.sections.size());
+  for (const auto &[name, section] : res.program.sections) {
+    QCOMPARE(cached->getSection(name)->address, section.address);
+    QCOMPARE(cached->getSection(name)->data, section.data);
+  }
+  QCOMPARE(cached->symbols.size(), res.program.symbols.size());
+  for (const auto &[address, symbol] : res.program.symbols) {
+    QCOMPARE(cached->symbols.at(address).v, symbol.v);
+    QCOMPARE(cached->symbols.at(address).type, symbol.type);
+  }
+  QVERIFY(cached->sourceMapping == res.program.sourceMapping);
+  QCOMPARE(cached->sourceHash, res.program.sourceHash);
+
+  // The key depends on the enabled extensions and the segment addresses.
+  auto rv32i = std::make_shared<ISAInfo<ISA::RV32I>>(QStringList());
+  QVERIFY(ProgramCache::key(source, assembler, *rv32i, nullptr) != key);
+  assembler.setSegmentBase(".text", 0x1000);
+  QVERIFY(ProgramCache::key(source, assembler, *isa, nullptr) != key);
+
+  // Failed assemblies are not cached.
+  const QString invalid = "addi a0 a0\n";
+  QVERIFY(cache.assemble(invalid, assembler, *isa).errors.size() != 0);
+  QVERIFY(!cache.lookup(ProgramCache::key(invalid, assembler, *isa, nullptr)));
+}
+
 QTEST_APPLESS_MAIN(tst_Assembler)
 #include "tst_assembler.moc"
@@ -0,0 +1,297 @@
+#include <QtTest/QTest>
+
+#include "cachesim/cachesim.h"
+#include "processorhandler.h"
+
+using namespace Ripes;
+
+// All caches below use 4-byte words and 4-word (16-byte) blocks.
+static constexpr AInt s_blockBytes = 16;
+
+static CachePreset preset(int lines, int ways, ReplPolicy replPolicy,
+                          PrefetchPolicy prefetchPolicy = NoPrefetch) {
+  CachePreset p;
+  p.blocks = 2;
+  p.lines = lines;
+  p.ways = ways;
+  p.wrPolicy = WritePolicy::WriteBack;
+  p.wrAllocPolicy = WriteAllocPolicy::WriteAllocate;
+  p.replPolicy = replPolicy;
+  p.prefetchPolicy = prefetchPolicy;
+  p.wordBytes = 4;
+  return p;
+}
+
+// Each access is performed in a separate cycle, since the cache simulator
+// keeps its access statistics per cycle.
+static void access(CacheSim &cache, AInt address, MemoryAccess::Type type,
+                   AInt pc = 0) {
+  ProcessorHandler::getProcessorNonConst()->clock();
+  cache.access(address, type, pc);
+}
+
+static void read(CacheSim &cache, AInt address) {
+  access(cache, address, MemoryAccess::Read);
+}
+
+// Returns the index of the way holding @p address, or -1.
+static int wayOf(const CacheSim &cache, AInt address) {
+  const auto *line = cache.getLine(cache.getLineIdx(address));
+  if (!line)
+    return -1;
+  for (const auto &[idx, way] : *line)
+    if (way.valid && way.tag == cache.getTag(address))
+      return static_cast<int>(idx);
+  return -1;
+}
+
+// Returns a textual dump of the full state of all ways of @p cache.
+static QString dump(const CacheSim &cache) {
+  QString state;
+  for (int lineIdx = 0; lineIdx < cache.getLines(); ++lineIdx) {
+    const auto *line = cache.getLine(lineIdx);
+    for (int wayIdx = 0; wayIdx < cache.getWays(); ++wayIdx) {
+      CacheSim::CacheWay way;
+      if (line && line->count(wayIdx))
+        way = line->at(wayIdx);
+      if (!way.valid)
+        continue;
+      state += QString("%1.%2: tag=%3 dirty=%4 lru=%5 repl=%6 prefetched=%7 "
+                       "blocks=")
+                   .arg(lineIdx)
+                   .arg(wayIdx)
+                   .arg(way.tag)
+                   .arg(way.dirty)
+                   .arg(way.lru)
+                   .arg(way.replState)
+                   .arg(way.prefetched);
+      for (unsigned block : way.dirtyBlocks)
+        state += QString::number(block) + ",";
+      state += "\n";
+    }
+  }
+  const auto stats = cache.getPrefetchStats();
+  state += QString("prefetches: %1/%2").arg(stats.useful).arg(stats.issued);
+  return state;
+}
+
+class tst_CacheSim : public QObject {
+  Q_OBJECT
+
+private slots:
+  void initTestCase();
+  void tst_victimFIFO();
+  void tst_victimPLRU();
+  void tst_victimRRIP();
+  void tst_victimLFU();
+  void tst_prefetchWriteback();
+  void tst_undoPrefetch();
+  void tst_rv64Tags();
+  void tst_missClassification();
+};
+
+// The processor only provides the cycle count of the accesses.
+static void loadLoopProgram(ProcessorID id) {
+  ProcessorHandler::selectProcessor(id, {"M"});
+  auto res = ProcessorHandler::getAssembler()->assembleRaw("loop: j loop\n");
+  QVERIFY(res.errors.empty());
+  ProcessorHandler::loadProgram(std::make_shared<Program>(res.program));
+}
+
+void tst_CacheSim::initTestCase() { loadLoopProgram(ProcessorID::RV32_5S); }
+
+// A single 4-way set, filled with blocks 0..3 in way order.
+static void fillSet(CacheSim &cache) {
+  for (AInt block = 0; block < 4; ++block)
+    read(cache, block * s_blockBytes);
+  for (AInt block = 0; block < 4; ++block)
+    QCOMPARE(wayOf(cache, block * s_blockBytes), static_cast<int>(block));
+}
+
+void tst_CacheSim::tst_victimFIFO() {
+  CacheSim cache(nullptr);
+  cache.setPreset(preset(0, 4, ReplPolicy::FIFO));
+  fillSet(cache);
+  // Hits do not affect the insertion order.
+  read(cache, 0 * s_blockBytes);
+  read(cache, 4 * s_blockBytes);
+  QCOMPARE(wayOf(cache, 4 * s_blockBytes), 0);
+  read(cache, 5 * s_blockBytes);
+  QCOMPARE(wayOf(cache, 5 * s_blockBytes), 1);
+}
+
+void tst_CacheSim::tst_victimPLRU() {
+  CacheSim cache(nullptr);
+  cache.setPreset(preset(0, 4, ReplPolicy::PLRU));
+  fillSet(cache);
+  // After touching way 0, the tree points to the right half, and within it
+  // away from the most recently filled way 3. True LRU would evict way 1.
+  read(cache, 0 * s_blockBytes);
+  read(cache, 4 * s_blockBytes);
+  QCOMPARE(wayOf(cache, 4 * s_blockBytes), 2);
+}
+
+void tst_CacheSim::tst_victimRRIP() {
+  {
+    // SRRIP inserts all blocks with the same prediction; the ways are aged
+    // equally, and the first one is evicted.
+    CacheSim cache(nullptr);
+    cache.setPreset(preset(0, 4, ReplPolicy::SRRIP));
+    fillSet(cache);
+    read(cache, 4 * s_blockBytes);
+    QCOMPARE(wayOf(cache, 4 * s_blockBytes), 0);
+    // A hit predicts a near re-reference.
+    read(cache, 1 * s_blockBytes);
+    read(cache, 5 * s_blockBytes);
+    QCOMPARE(wayOf(cache, 5 * s_blockBytes), 2);
+  }
+  {
+    // BRRIP inserts only the first of every 32 blocks with a long
+    // re-reference interval; the remaining blocks are evicted first.
+    CacheSim cache(nullptr);
+    cache.setPreset(preset(0, 4, ReplPolicy::BRRIP));
+    fillSet(cache);
+    read(cache, 4 * s_blockBytes);
+    QCOMPARE(wayOf(cache, 4 * s_blockBytes), 1);
+  }
+}
+
+void tst_CacheSim::tst_victimLFU() {
+  CacheSim cache(nullptr);
+  cache.setPreset(preset(0, 4, ReplPolicy::LFU));
+  fillSet(cache);
+  for (AInt block : {0, 0, 1, 3})
+    read(cache, block * s_blockBytes);
+  read(cache, 4 * s_blockBytes);
+  QCOMPARE(wayOf(cache, 4 * s_blockBytes), 2);
+}
+
+void tst_CacheSim::tst_prefetchWriteback() {
+  // Direct-mapped, 2 lines.
+  CacheSim cache(nullptr);
+  cache.setPreset(preset(1, 1, ReplPolicy::LRU, NextLinePrefetch));
+  // Block 3 is dirtied in line 1, and block 4 is prefetched into line 0.
+  access(cache, 3 * s_blockBytes, MemoryAccess::Write);
+  QCOMPARE(wayOf(cache, 4 * s_blockBytes), 0);
+  QCOMPARE(cache.getWritebacks(), 0u);
+  // Block 0 evicts the clean block 4, and the prefetch of block 1 evicts the
+  // dirty block 3.
+  read(cache, 0 * s_blockBytes);
+  QCOMPARE(wayOf(cache, 1 * s_blockBytes), 0);
+  QCOMPARE(cache.getWritebacks(), 1u);
+  QCOMPARE(cache.getPrefetchStats().issued, 2u);
+}
+
+void tst_CacheSim::tst_undoPrefetch() {
+  for (auto replPolicy : {ReplPolicy::LRU, ReplPolicy::FIFO, ReplPolicy::PLRU,
+                          ReplPolicy::SRRIP, ReplPolicy::BRRIP,
+                          ReplPolicy::LFU}) {
+    for (auto prefetchPolicy : {NextLinePrefetch, StridePrefetch}) {
+      CacheSim cache(nullptr);
+      cache.setPreset(preset(1, 2, replPolicy, prefetchPolicy));
+
+      // A strided access stream, interleaved with writes to other blocks.
+      std::vector<std::pair<AInt, MemoryAccess::Type>> accesses;
+      for (AInt i = 0; i < 8; ++i) {
+        accesses.push_back({i * 3 * s_blockBytes, MemoryAccess::Read});
+        accesses.push_back({(i % 3) * s_blockBytes + 4, MemoryAccess::Write});
+      }
+      const auto run = [&](size_t from, size_t to) {
+        for (size_t i = from; i < to; ++i)
+          access(cache, accesses.at(i).first, accesses.at(i).second,
+                 /*pc=*/accesses.at(i).second == MemoryAccess::Read ? 0x100
+                                                                    : 0x200);
+      };
+
+      const size_t half = accesses.size() / 2;
+      run(0, half);
+      const QString before = dump(cache);
+      run(half, accesses.size());
+      const QString after = dump(cache);
+      QVERIFY(cache.getPrefetchStats().issued > 0);
+
+      // Undoing restores the state exactly...
+      for (size_t i = half; i < accesses.size(); ++i)
+        cache.undo();
+      QCOMPARE(dump(cache), before);
+
+      // ... including the prefetcher and replacement state, such that
+      // replaying the accesses yields the same state.
+      run(half, accesses.size());
+      QCOMPARE(dump(cache), after);
+    }
+  }
+}
+
+void tst_CacheSim::tst_rv64Tags() {
+  loadLoopProgram(ProcessorID::RV64_5S);
+  {
+    CacheSim cache(nullptr);
+    cache.setPreset(preset(2, 1, ReplPolicy::LRU));
+    QCOMPARE(cache.getAddressBits(), 64u);
+
+    // Two addresses differing only above bit 31 map to the same line, but
+    // must not alias.
+    const AInt low = 0x1000;
+    const AInt high = low | (AInt(1) << 32);
+    QCOMPARE(cache.getLineIdx(high), cache.getLineIdx(low));
+    QVERIFY(cache.getTag(high) != cache.getTag(low));
+
+    read(cache, low);
+    read(cache, high);
+    QCOMPARE(cache.getHits(), 0u);
+    QCOMPARE(cache.getMisses(), 2u);
+    QCOMPARE(wayOf(cache, high), 0);
+    QCOMPARE(wayOf(cache, low), -1);
+  }
+  loadLoopProgram(ProcessorID::RV32_5S);
+}
+
+// Returns the hit, miss, compulsory, capacity and conflict counters of
+// @p stats.
+static QList<unsigned> counters(const CacheSim::SetStats &stats) {
+  return {stats.hits, stats.misses, stats.compulsory, stats.capacity,
+          stats.conflict};
+}
+
+void tst_CacheSim::tst_missClassification() {
+  // A direct-mapped cache of two lines; even blocks map to line 0, odd blocks
+  // to line 1.
+  CacheSim cache(nullptr);
+  cache.setPreset(preset(1, 1, ReplPolicy::LRU));
+  QCOMPARE(cache.getLines(), 2);
+  const std::vector<AInt> blocks = {
+      0, 2, // Compulsory
+      0,    // Conflict: evicted by block 2, though it fits the cache
+      1, 3, // Compulsory
+      2,    // Capacity: 3 distinct blocks were accessed since block 2
+      3};   // Hit
+  const auto run = [&](size_t from, size_t to) {
+    for (size_t i = from; i < to; ++i)
+      read(cache, blocks.at(i) * s_blockBytes);
+  };
+
+  run(0, 3);
+  const auto partial = counters(cache.getTotalStats());
+  QCOMPARE(partial, (QList<unsigned>{0, 3, 2, 0, 1}));
+  run(3, blocks.size());
+  const auto total = counters(cache.getTotalStats());
+  QCOMPARE(total, (QList<unsigned>{1, 6, 4, 1, 1}));
+  QCOMPARE(counters(cache.getSetStats(0)), (QList<unsigned>{0, 4, 2, 1, 1}));
+  QCOMPARE(counters(cache.getSetStats(1)), (QList<unsigned>{1, 2, 2, 0, 0}));
+
+  // Stepping back restores the counters, and the shadow cache, such that
+  // replaying the accesses classifies them identically.
+  for (size_t i = 3; i < blocks.size(); ++i)
+    cache.undo();
+  QCOMPARE(counters(cache.getTotalStats()), partial);
+  run(3, blocks.size());
+  QCOMPARE(counters(cache.getTotalStats()), total);
+
+  for (size_t i = 0; i < blocks.size(); ++i)
+    cache.undo();
+  QCOMPARE(counters(cache.getTotalStats()), (QList<unsigned>{0, 0, 0, 0, 0}));
+}
+
+QTEST_MAIN(tst_CacheSim)
+#include "tst_cachesim.moc"
@@ -0,0 +1,101 @@
+#include <QtTest/QTest>
+
+#include <QTemporaryDir>
+
+#include "ccmanager.h"
+#include "cli/programutilities.h"
+#include "processorhandler.h"
+#include "simulator.h"
+
+using namespace Ripes;
+
+// Upper bound on the cycles required to run the startup code, main() and exit
+// of the test programs.
+static constexpr long long c_maxCycles = 1000000;
+
+class tst_CCManager : public QObject {
+  Q_OBJECT
+
+private slots:
+  void initTestCase();
+  void tst_cacheIncludes();
+  void cleanupTestCase();
+
+private:
+  QString writeFile(const QString &name, const QString &contents);
+
+  QTemporaryDir m_dir;
+};
+
+QString tst_CCManager::writeFile(const QString &name,
+                                 const QString &contents) {
+  const QString path = m_dir.filePath(name);
+  QFile file(path);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    return QString();
+  file.write(contents.toUtf8());
+  return path;
+}
+
+// Runs the executable @p elf, returning its exit code, or -1 if the program
+// did not exit.
+static VInt exitCodeOf(const QString &elf) {
+  Program program;
+  QFile file(elf);
+  if (!loadElfFile(program, file))
+    return -1;
+  Simulator sim;
+  sim.loadProgram(std::make_shared<Program>(program));
+  sim.run(c_maxCycles);
+  return sim.exitCode().value_or(-1);
+}
+
+void tst_CCManager::initTestCase() {
+  QVERIFY(m_dir.isValid());
+  ProcessorHandler::selectProcessor(ProcessorID::RV32_5S, {"M"});
+  if (!CCManager::hasValidCC())
+    QSKIP("No RISC-V compiler available");
+  CCManager::get().setCacheDirectory(QString());
+}
+
+void tst_CCManager::tst_cacheIncludes() {
+  QTemporaryDir cacheDir;
+  QVERIFY(cacheDir.isValid());
+  CCManager::get().setCacheDirectory(cacheDir.path());
+
+  const QString source =
+      writeFile("include.c", "#include \"value.h\"\n"
+                             "int main() { return VALUE; }\n");
+  const auto compile = [&] {
+    auto res = CCManager::get().compile(QStringList{source}, QString(), false);
+    const VInt exitCode = res.success ? exitCodeOf(res.outFile) : -1;
+    res.clean();
+    return exitCode;
+  };
+  const auto cacheEntries = [&] {
+    return QDir(cacheDir.path()).entryList({"*.entry"}, QDir::Files).size();
+  };
+
+  writeFile("value.h", "#define VALUE 1\n");
+  QCOMPARE(compile(), static_cast<VInt>(1));
+  QCOMPARE(cacheEntries(), qsizetype(1));
+
+  QCOMPARE(compile(), static_cast<VInt>(1));
+  QCOMPARE(cacheEntries(), qsizetype(1));
+
+  // Changing an included header invalidates the cached executable, which is
+  // replaced, since the source itself is unchanged.
+  writeFile("value.h", "#define VALUE 2\n");
+  QCOMPARE(compile(), static_cast<VInt>(2));
+  QCOMPARE(cacheEntries(), qsizetype(1));
+  QCOMPARE(compile(), static_cast<VInt>(2));
+
+  CCManager::get().setCacheDirectory(QString());
+}
+
+void tst_CCManager::cleanupTestCase() {
+  CCManager::get().setCacheDirectory(QString());
+}
+
+QTEST_MAIN(tst_CCManager)
+#include "tst_ccmanager.moc"
@@ -0,0 +1,140 @@
+#include <QtTest/QTest>
+
+#include <QTemporaryDir>
+
+#include "cli/clirunner.h"
+#include "processorhandler.h"
+
+using namespace Ripes;
+
+class tst_CLI : public QObject {
+  Q_OBJECT
+
+private slots:
+  void initTestCase();
+  void tst_resultCacheHostFiles();
+  void tst_runBlockingStopsOnUnknownSyscall();
+  void tst_screenDumpWithoutScreen();
+
+private:
+  QString writeFile(const QString &name, const QByteArray &contents);
+  int runCLI(const QString &src);
+  qsizetype cacheEntries() const;
+
+  QTemporaryDir m_dir;
+  QTemporaryDir m_cacheDir;
+};
+
+QString tst_CLI::writeFile(const QString &name, const QByteArray &contents) {
+  const QString path = m_dir.filePath(name);
+  QFile file(path);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    return QString();
+  file.write(contents);
+  return path;
+}
+
+// Runs the assembly program @p src in CLI mode, with run results cached in
+// m_cacheDir.
+int tst_CLI::runCLI(const QString &src) {
+  CLIModeOptions options;
+  options.src = src;
+  options.srcType = SourceType::Assembly;
+  options.proc = ProcessorID::RV32_5S;
+  options.isaExtensions = {"M"};
+  options.resultCacheDir = m_cacheDir.path();
+  CLIRunner runner(options);
+  return runner.run();
+}
+
+qsizetype tst_CLI::cacheEntries() const {
+  return QDir(m_cacheDir.path()).entryList({"*.json"}, QDir::Files).size();
+}
+
+void tst_CLI::initTestCase() {
+  QVERIFY(m_dir.isValid());
+  QVERIFY(m_cacheDir.isValid());
+}
+
+void tst_CLI::tst_resultCacheHostFiles() {
+  // A self-contained program is cached.
+  QCOMPARE(runCLI(writeFile("print.s", "li a0, 1\nli a7, 1\necall\n")), 0);
+  QCOMPARE(cacheEntries(), qsizetype(1));
+
+  // Reads 4 bytes of a host file into buf, and prints them.
+  const QString dataFile = writeFile("input.txt", "abcd");
+  const QString source = QString(R"(
+    .data
+buf: .zero 4
+path: .string "%1"
+    .text
+    la a0, path
+    li a1, 0
+    li a7, 1024
+    ecall
+    mv s0, a0
+    la a1, buf
+    li a2, 4
+    li a7, 63
+    ecall
+    mv a2, a0
+    li a0, 1
+    la a1, buf
+    li a7, 64
+    ecall
+    mv a0, s0
+    li a7, 57
+    ecall
+)")
+                             .arg(dataFile);
+  const QString src = writeFile("read.s", source.toUtf8());
+  const auto readBuf = [] {
+    const auto *data = ProcessorHandler::getProgram()->getSection(".data");
+    return ProcessorHandler::getMemory().readMemConst(data->address, 4);
+  };
+
+  QCOMPARE(runCLI(src), 0);
+  QVERIFY(ProcessorHandler::hostFilesAccessed());
+  QCOMPARE(readBuf(), static_cast<VInt>(0x64636261));
+  // The file contents are not part of the key, so the run is not cached.
+  QCOMPARE(cacheEntries(), qsizetype(1));
+
+  // After changing the file, the program is run again and reads the new
+  // contents, rather than the results of the first run being reported.
+  writeFile("input.txt", "efgh");
+  QCOMPARE(runCLI(src), 0);
+  QVERIFY(ProcessorHandler::hostFilesAccessed());
+  QCOMPARE(readBuf(), static_cast<VInt>(0x68676665));
+  QCOMPARE(cacheEntries(), qsizetype(1));
+}
+
+void tst_CLI::tst_runBlockingStopsOnUnknownSyscall() {
+  // An unknown syscall stops the run, rather than the program spinning in the
+  // loop following it until the timeout.
+  ProcessorHandler::selectProcessor(ProcessorID::RV32_5S, {"M"});
+  auto res = ProcessorHandler::getAssembler()->assembleRaw(
+      "li a7, 12345\necall\nloop: j loop\n");
+  QVERIFY(res.errors.empty());
+  ProcessorHandler::loadProgram(std::make_shared<Program>(res.program));
+
+  QVERIFY(ProcessorHandler::runBlocking(/*timeoutMs=*/10000));
+  QVERIFY(!ProcessorHandler::isRunning());
+  QVERIFY(ProcessorHandler::getProcessor()->getCycleCount() < 100);
+}
+
+void tst_CLI::tst_screenDumpWithoutScreen() {
+  // Dumping frames without a screen peripheral is an error, rather than
+  // silently producing no dump.
+  CLIModeOptions options;
+  options.src = writeFile("exit.s", "li a0, 0\nli a7, 93\necall\n");
+  options.srcType = SourceType::Assembly;
+  options.proc = ProcessorID::RV32_5S;
+  options.isaExtensions = {"M"};
+  options.screenDumpPath = m_dir.filePath("frames.raw");
+  CLIRunner runner(options);
+  QCOMPARE(runner.run(), 1);
+  QVERIFY(!QFile::exists(options.screenDumpPath));
+}
+
+QTEST_MAIN(tst_CLI)
+#include "tst_cli.moc"
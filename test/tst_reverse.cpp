@@ -29,6 +29,7 @@ private slots:
                 bool toFinish);
   void tst_reverse_regs();
   void tst_reverse_mem();
+  void tst_reverse_writeset();
 };
 
 using Registers = std::map<int, VInt>;
@@ -109,5 +110,54 @@ void tst_reverse::tst_reverse_mem() {
   }
 }
 
+void tst_reverse::tst_reverse_writeset() {
+  constexpr unsigned cycles = 10;
+  for (auto processor : {ProcessorID::RV32_SS, ProcessorID::RV32_5S}) {
+    QStringList program = QStringList() << ".data"
+                                        << "a: .word 42"
+                                        << ".text"
+                                        << "la a0 a"
+                                        << "li a1 1"
+                                        << "sw a1 0 a0"
+                                        << "nop"
+                                        << "nop"
+                                        << "nop"
+                                        << "nop";
+    run_test(processor, program, 0, 0, 0, false);
+    auto proc = ProcessorHandler::get()->getProcessorNonConst();
+    auto &writeSet = ProcessorHandler::memoryWriteSet();
+    const AInt address =
+        ProcessorHandler::getProgram()->getSection(".data")->address;
+    QCoreApplication::processEvents();
+
+    // Step over the store, recording the cycle in which it was committed.
+    auto generation = writeSet.generation();
+    unsigned storeCycle = 0;
+    for (unsigned c = 1; c <= cycles; ++c) {
+      proc->clock();
+      if (storeCycle == 0 && writeSet.generation() != generation)
+        storeCycle = c;
+    }
+    QVERIFY(storeCycle != 0);
+    auto changes = writeSet.changesSince(generation);
+    QVERIFY(!changes.all);
+    QCOMPARE(changes.ranges.size(), size_t(1));
+    QCOMPARE(changes.ranges.at(0).start, address);
+    QCOMPARE(changes.ranges.at(0).end, address + 4);
+
+    // Step back to before the store was committed, and over it once more.
+    for (unsigned c = storeCycle - 1; c < cycles; ++c)
+      proc->reverseProcessor();
+    QCoreApplication::processEvents();
+    generation = writeSet.generation();
+    for (unsigned c = storeCycle - 1; c < cycles; ++c)
+      proc->clock();
+    changes = writeSet.changesSince(generation);
+    QVERIFY(!changes.all);
+    QCOMPARE(changes.ranges.size(), size_t(1));
+    QCOMPARE(changes.ranges.at(0).start, address);
+  }
+}
+
 QTEST_MAIN(tst_reverse)
 #include "tst_reverse.moc"
@@ -0,0 +1,130 @@
+#include <QtTest/QTest>
+
+#include <thread>
+#include <vector>
+
+#include "isa/rvisainfo_common.h"
+#include "simulator.h"
+
+using namespace Ripes;
+
+// Sums the integers 1..n, where n is read from a0, prints the sum and exits
+// with the sum as the exit code.
+static const QString s_sumProgram = R"(
+    mv t0, a0
+    li t1, 0
+loop:
+    beqz t0, done
+    add t1, t1, t0
+    addi t0, t0, -1
+    j loop
+done:
+    mv a0, t1
+    li a7, 1
+    ecall
+    mv a0, t1
+    li a7, 93
+    ecall
+)";
+
+class tst_simulator : public QObject {
+  Q_OBJECT
+
+private slots:
+  void tst_run();
+  void tst_cycleLimit();
+  void tst_concurrentInstances();
+  void tst_syscallIO();
+};
+
+void tst_simulator::tst_run() {
+  Simulator sim;
+  QVERIFY(sim.loadAssembly(s_sumProgram).empty());
+  sim.setRegister(RVISA::GPR, 10, 10);
+  QVERIFY(sim.run() == Simulator::RunResult::Finished);
+  QCOMPARE(sim.output(), QByteArray("55"));
+  QVERIFY(sim.exitCode().has_value());
+  QCOMPARE(*sim.exitCode(), static_cast<VInt>(55));
+
+  // Resetting restores the initial state of the program.
+  sim.reset();
+  QVERIFY(!sim.finished());
+  QVERIFY(sim.output().isEmpty());
+  QCOMPARE(sim.cycleCount(), 0LL);
+}
+
+void tst_simulator::tst_cycleLimit() {
+  Simulator sim;
+  QVERIFY(sim.loadAssembly(s_sumProgram).empty());
+  sim.setRegister(RVISA::GPR, 10, 1000);
+  QVERIFY(sim.run(100) == Simulator::RunResult::CycleLimit);
+  QCOMPARE(sim.cycleCount(), 100LL);
+  QVERIFY(sim.run() == Simulator::RunResult::Finished);
+  QCOMPARE(sim.output(), QByteArray("500500"));
+}
+
+void tst_simulator::tst_concurrentInstances() {
+  constexpr unsigned nInstances = 4;
+  std::vector<std::unique_ptr<Simulator>> sims;
+  for (unsigned i = 0; i < nInstances; ++i) {
+    SimulatorConfig config;
+    config.processor =
+        i % 2 == 0 ? ProcessorID::RV32_5S : ProcessorID::RV32_SS;
+    sims.push_back(std::make_unique<Simulator>(config));
+    QVERIFY(sims.back()->loadAssembly(s_sumProgram).empty());
+    sims.back()->setRegister(RVISA::GPR, 10, 100 * (i + 1));
+  }
+
+  std::vector<std::thread> threads;
+  for (auto &sim : sims)
+    threads.emplace_back([&sim] { sim->run(); });
+  for (auto &thread : threads)
+    thread.join();
+
+  for (unsigned i = 0; i < nInstances; ++i) {
+    const unsigned n = 100 * (i + 1);
+    QVERIFY(sims.at(i)->finished());
+    QCOMPARE(sims.at(i)->output(), QByteArray::number(n * (n + 1) / 2));
+  }
+}
+
+void tst_simulator::tst_syscallIO() {
+  // Echoes a prompt and 3 bytes of stdin through the read/write system calls,
+  // with the data segment at a per-instance base address.
+  SimulatorConfig config;
+  config.segmentBases[".data"] = 0x2000;
+  Simulator sim(config);
+  QVERIFY(sim.loadAssembly(R"(
+    .data
+prompt: .string "in: "
+buf: .zero 4
+    .text
+    la a0, prompt
+    li a7, 4
+    ecall
+    li a0, 0
+    la a1, buf
+    li a2, 3
+    li a7, 63
+    ecall
+    mv a2, a0
+    li a0, 1
+    la a1, buf
+    li a7, 64
+    ecall
+    li a7, 12345
+    ecall
+)")
+              .empty());
+  QCOMPARE(sim.program()->getSection(".data")->address,
+           static_cast<AInt>(0x2000));
+
+  sim.setInput("abcdef");
+  QVERIFY(sim.run() == Simulator::RunResult::Error);
+  QCOMPARE(sim.output(), QByteArray("in: abc"));
+  QVERIFY(sim.error().contains("12345"));
+  QVERIFY(!sim.exitCode().has_value());
+}
+
+QTEST_MAIN(tst_simulator)
+#include "tst_simulator.moc"
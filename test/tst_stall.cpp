@@ -9,6 +9,7 @@
 #include "processorhandler.h"
 #include "processorregistry.h"
 
+#include "cli/telemetry.h"
 #include "edittab.h"
 #include "isa/rvisainfo_common.h"
 #include "programloader.h"
@@ -27,6 +28,8 @@ private slots:
   void tst_no_stall_load_ex_hazard_rs1();
   void tst_no_stall_load_ex_hazard_rs2();
   void tst_no_stall_load_ex_hazard_x0();
+  void tst_stall_counters_load_use_hazard();
+  void tst_hazard_telemetry_load_use_hazards();
 };
 
 void tst_stall::run_test(const ProcessorID &id, const QStringList &program) {
@@ -37,6 +40,7 @@ void tst_stall::run_test(const ProcessorID &id, const QStringList &program) {
   auto loader = new ProgramLoader();
   loader->loadTest(program.join("\n"));
   auto proc = ProcessorHandler::get()->getProcessorNonConst();
+  proc->setPipelineStatsEnabled(true);
 
   // Step until finished
   while (!proc->finished() && proc->getCycleCount() < 1000)
@@ -90,5 +94,67 @@ void tst_stall::tst_no_stall_load_ex_hazard_x0() {
   }
 }
 
+void tst_stall::tst_stall_counters_load_use_hazard() {
+  for (auto processor : {ProcessorID::RV32_5S, ProcessorID::RV64_5S}) {
+    QStringList program = QStringList() << ".data"
+                                        << "A: .word 5"
+                                        << ".text"
+                                        << "la a0, A"
+                                        << "lw x14, 0(a0)"
+                                        << "add x15, x14, x14";
+    run_test(processor, program);
+    auto *proc = ProcessorHandler::get()->getProcessor();
+    QCOMPARE(proc->getCycleCount(), 9LL);
+
+    // The load-use hazard stalls a single instruction, which is visible as a
+    // single stalled cycle in the EX stage.
+    const auto &stats = proc->pipelineStats();
+    QCOMPARE(static_cast<unsigned>(stats.size()),
+             proc->structure().numStages());
+    uint64_t exStalls = 0;
+    for (const auto &s : stats)
+      if (s.stage.index() == 2)
+        exStalls = s.stallCycles;
+    QCOMPARE(exStalls, uint64_t(1));
+  }
+}
+
+void tst_stall::tst_hazard_telemetry_load_use_hazards() {
+  for (auto processor : {ProcessorID::RV32_5S, ProcessorID::RV64_5S}) {
+    QStringList program = QStringList() << ".data"
+                                        << "A: .word 5"
+                                        << ".text"
+                                        << "la a0, A"
+                                        << "lw t0, 0(a0)"
+                                        << "add t1, t0, t0"
+                                        << "lw t2, 0(a0)"
+                                        << "add t3, t2, t2"
+                                        << "lw t4, 0(a0)"
+                                        << "add t5, t4, t4";
+    run_test(processor, program);
+    auto *proc = ProcessorHandler::get()->getProcessorNonConst();
+
+    // Each of the 3 load-use hazards is reported as a single stall, although
+    // the stalled slot occupies the EX, MEM and WB stages.
+    HazardTelemetry telemetry;
+    const QVariantMap report = telemetry.report(/*json=*/true).toMap();
+    QCOMPARE(report.value("stalls").toULongLong(), 3ull);
+    QCOMPARE(report.value("flushes").toULongLong(), 0ull);
+    uint64_t stallCycles = 0;
+    for (const auto &s : proc->pipelineStats())
+      stallCycles += s.stallCycles;
+    QCOMPARE(stallCycles, uint64_t(9));
+
+    // Reversing the processor reverts the statistics.
+    while (proc->canReverseProcessor())
+      proc->reverseProcessor();
+    QCOMPARE(proc->getCycleCount(), 0LL);
+    for (const auto &s : proc->pipelineStats()) {
+      QCOMPARE(s.stalls, uint64_t(0));
+      QCOMPARE(s.stallCycles, uint64_t(0));
+    }
+  }
+}
+
 QTEST_MAIN(tst_stall)
 #include "tst_stall.moc"
@@ -0,0 +1,62 @@
+#include <QtTest/QTest>
+
+#include "simulator.h"
+#include "syscall/systemio.h"
+
+using namespace Ripes;
+
+// Tests the output of programs through the print system calls.
+
+class tst_syscall : public QObject {
+  Q_OBJECT
+
+private slots:
+  void tst_printCharLatin1();
+  void tst_splitUtf8Output();
+};
+
+void tst_syscall::tst_printCharLatin1() {
+  // PrintChar interprets its argument as a Latin-1 character, which is output
+  // as UTF-8.
+  Simulator sim;
+  QVERIFY(sim.loadAssembly(R"(
+    li a0, 0x41
+    li a7, 11
+    ecall
+    li a0, 0xe9
+    ecall
+    li a0, 0
+    li a7, 93
+    ecall
+)")
+              .empty());
+  QVERIFY(sim.run() == Simulator::RunResult::Finished);
+  QCOMPARE(sim.output(), QByteArray("A\xc3\xa9"));
+}
+
+void tst_syscall::tst_splitUtf8Output() {
+  // Without an output sink, output is emitted through the doPrint signal. A
+  // UTF-8 sequence split across writes is emitted once completed.
+  SystemIO::setOutputSink(nullptr);
+  SystemIO::reset();
+  QStringList printed;
+  auto connection = connect(&SystemIO::get(), &SystemIO::doPrint, this,
+                            [&](const QString &str) { printed << str; });
+
+  SystemIO::printBytes(QByteArray("A\xc3"));
+  QCOMPARE(printed, QStringList{"A"});
+  SystemIO::printBytes(QByteArray("\xa9"));
+  QCOMPARE(printed, (QStringList{"A", QString(QChar(0xe9))}));
+
+  // Resetting discards an incomplete sequence.
+  printed.clear();
+  SystemIO::printBytes(QByteArray("\xc3"));
+  SystemIO::reset();
+  SystemIO::printBytes(QByteArray("B"));
+  QCOMPARE(printed, QStringList{"B"});
+
+  disconnect(connection);
+}
+
+QTEST_MAIN(tst_syscall)
+#include "tst_syscall.moc"